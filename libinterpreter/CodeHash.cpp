@@ -0,0 +1,37 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#include "CodeHash.h"
+
+#include <tuple>
+#include <vector>
+
+namespace dev
+{
+namespace eth
+{
+namespace
+{
+/// code, size, hash of the frames being set up or run on this thread, innermost last
+thread_local std::vector<std::tuple<uint8_t const*, size_t, h256>> t_noted;
+}
+
+CodeHashScope::CodeHashScope(bytesConstRef _code, h256 const& _codeHash)
+{
+    t_noted.emplace_back(_code.data(), _code.size(), _codeHash);
+}
+
+CodeHashScope::~CodeHashScope()
+{
+    t_noted.pop_back();
+}
+
+h256 const* notedCodeHash(uint8_t const* _code, size_t _codeSize)
+{
+    for (auto it = t_noted.rbegin(); it != t_noted.rend(); ++it)
+        if (std::get<0>(*it) == _code && std::get<1>(*it) == _codeSize)
+            return &std::get<2>(*it);
+    return nullptr;
+}
+}
+}
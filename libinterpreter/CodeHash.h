@@ -0,0 +1,29 @@
+// Aleth: Ethereum C++ client, tools and libraries.
+// Copyright 2014-2019 Aleth Authors.
+// Licensed under the GNU General Public License, Version 3.
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+namespace dev
+{
+namespace eth
+{
+/// Notes the code about to be executed on this thread as the code of _codeHash, so the interpreter runs it
+/// from the analysis shared by hash instead of copying and analysing it for every frame. The note is dropped
+/// when the scope ends, scopes nest with calls.
+class CodeHashScope
+{
+public:
+    CodeHashScope(bytesConstRef _code, h256 const& _codeHash);
+    ~CodeHashScope();
+
+    CodeHashScope(CodeHashScope const&) = delete;
+    CodeHashScope& operator=(CodeHashScope const&) = delete;
+};
+
+/// Hash noted for the code at _code of _codeSize bytes on this thread, nullptr if there is none.
+h256 const* notedCodeHash(uint8_t const* _code, size_t _codeSize);
+}
+}
@@ -24,12 +24,55 @@ void delete_output(const evmc_result* result)
     delete[] result->output_data;
 }
 
+/// VM instances are large (the stack alone is 32KB) and every nested call needs its own.
+/// Instances are reused per thread: a frame takes a free one and returns it when done,
+/// so a nested call simply takes the next one.
+class VMPool
+{
+public:
+    std::unique_ptr<dev::eth::VM> acquire()
+    {
+        if (m_free.empty())
+            return std::unique_ptr<dev::eth::VM>{new dev::eth::VM};
+        auto vm = std::move(m_free.back());
+        m_free.pop_back();
+        return vm;
+    }
+
+    void release(std::unique_ptr<dev::eth::VM> _vm)
+    {
+        if (m_free.size() >= c_maxFree)
+            return;
+        _vm->reset();
+        m_free.push_back(std::move(_vm));
+    }
+
+private:
+    /// deeper call chains than this allocate the extra frames
+    static constexpr size_t c_maxFree = 64;
+    std::vector<std::unique_ptr<dev::eth::VM>> m_free;
+};
+
+thread_local VMPool t_vmPool;
+
+/// returns the instance to the pool of this thread when the frame is done
+class PooledVM
+{
+public:
+    PooledVM() : m_vm(t_vmPool.acquire()) {}
+    ~PooledVM() { t_vmPool.release(std::move(m_vm)); }
+    dev::eth::VM* operator->() const { return m_vm.get(); }
+
+private:
+    std::unique_ptr<dev::eth::VM> m_vm;
+};
+
 evmc_result execute(evmc_vm* _instance, const evmc_host_interface* _host,
     evmc_host_context* _context, evmc_revision _rev, const evmc_message* _msg, uint8_t const* _code,
     size_t _codeSize) noexcept
 {
     (void)_instance;
-    std::unique_ptr<dev::eth::VM> vm{new dev::eth::VM};
+    PooledVM vm;
 
     evmc_result result = {};
     dev::eth::owning_bytes_ref output;
@@ -259,6 +302,50 @@ owning_bytes_ref VM::exec(const evmc_host_interface* _host, evmc_host_context* _
     return std::move(m_output);
 }
 
+void VM::reset()
+{
+    /// memory buffers grown by a big frame are not kept around
+    constexpr size_t maxKeptCapacity = 1024 * 1024;
+
+    m_host = nullptr;
+    m_context = nullptr;
+    m_message = nullptr;
+    m_tx_context.reset();
+    m_bounce = nullptr;
+    m_nSteps = 0;
+    m_io_gas = 0;
+    m_output = owning_bytes_ref{};
+
+    if (m_mem.capacity() > maxKeptCapacity)
+        bytes().swap(m_mem);
+    else
+        m_mem.clear();
+    if (m_returnData.capacity() > maxKeptCapacity)
+        bytes().swap(m_returnData);
+    else
+        m_returnData.clear();
+    if (m_ownCode.code.capacity() > maxKeptCapacity)
+        bytes().swap(m_ownCode.code);
+    else
+        m_ownCode.code.clear();
+    m_ownCode.jumpDests.clear();
+    m_ownCode.pool.clear();
+
+    m_pCode = nullptr;
+    m_codeSize = 0;
+    m_sharedCode.reset();
+    m_analysed = nullptr;
+    m_code = nullptr;
+    m_beginSubs.clear();
+
+    m_PC = 0;
+    m_SP = m_stackEnd;
+    m_SPP = m_SP;
+    m_runGas = 0;
+    m_newMemSize = 0;
+    m_copyMemSize = 0;
+}
+
 //
 // main interpreter loop and switch
 //
@@ -1205,7 +1292,7 @@ void VM::interpretCases()
             off = m_code[m_PC++] << 8;
             off |= m_code[m_PC++];
             m_PC += m_code[m_PC];
-            m_SPP[0] = m_pool[off];
+            m_SPP[0] = m_analysed->pool[off];
             TRACE_VAL(2, "Retrieved pooled const", m_SPP[0]);
 #else
             throwBadInstruction();
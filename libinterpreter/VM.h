@@ -13,6 +13,8 @@
 
 #include <boost/optional.hpp>
 
+#include <memory>
+
 namespace dev
 {
 namespace eth
@@ -46,6 +48,17 @@ struct VMSchedule
     static constexpr int64_t callSelfGas = 40;
 };
 
+/// Code as the interpreter runs it: extended by zero bytes so pushes at the end read no further bounds,
+/// synthetic instructions in user code made invalid, jump destinations found. Immutable once analysed,
+/// code noted with its hash is analysed once and shared by every frame running it.
+struct AnalysedCode
+{
+    bytes code;
+    std::vector<uint64_t> jumpDests;
+    // constant pool
+    std::vector<intx::uint256> pool;
+};
+
 class VM
 {
 public:
@@ -56,6 +69,10 @@ public:
     owning_bytes_ref exec(const evmc_host_interface* _host, evmc_host_context* _context,
         evmc_revision _rev, const evmc_message* _msg, uint8_t const* _code, size_t _codeSize);
 
+    /// Clear the state of the last frame so the instance can run another one,
+    /// keeping the stack array and the capacity of unshared code, memory and return data buffers.
+    void reset();
+
     uint64_t m_io_gas = 0;
 private:
     const evmc_host_interface* m_host = nullptr;
@@ -65,7 +82,6 @@ private:
     evmc_message const* m_message = nullptr;
     boost::optional<evmc_tx_context> m_tx_context;
     static std::array<std::array<evmc_instruction_metrics, 256>, EVMC_MAX_REVISION + 1> s_metrics;
-    void copyCode(int);
     typedef void (VM::*MemFnPtr)();
     MemFnPtr m_bounce = nullptr;
     uint64_t m_nSteps = 0;
@@ -78,8 +94,12 @@ private:
 
     uint8_t const* m_pCode = nullptr;
     size_t m_codeSize = 0;
-    // space for code
-    bytes m_code;
+    // analysis shared by code hash, or of this frame only into m_ownCode
+    std::shared_ptr<AnalysedCode const> m_sharedCode;
+    AnalysedCode m_ownCode;
+    AnalysedCode const* m_analysed = nullptr;
+    // code of m_analysed
+    byte const* m_code = nullptr;
 
     /// RETURNDATA buffer for memory returned from direct subcalls.
     bytes m_returnData;
@@ -88,9 +108,7 @@ private:
     intx::uint256 m_stack[VMSchedule::stackLimit];
     intx::uint256 *m_stackEnd = &m_stack[VMSchedule::stackLimit];
     size_t stackSize() { return m_stackEnd - m_SP; }
-    
-    // constant pool
-    std::vector<intx::uint256> m_pool;
+
 
     // interpreter state
     Instruction m_OP;         // current operation
@@ -105,7 +123,8 @@ private:
 
     // initialize interpreter
     void initEntry();
-    void optimize();
+    static void analyse(AnalysedCode& o_code, uint8_t const* _code, size_t _codeSize);
+    static std::shared_ptr<AnalysedCode const> sharedAnalysis(h256 const& _codeHash, uint8_t const* _code, size_t _codeSize);
 
     // interpreter loop & switch
     void interpretCases();
@@ -130,8 +149,8 @@ private:
     void throwBufferOverrun(intx::uint512 const& _enfOfAccess);
 
     std::vector<uint64_t> m_beginSubs;
-    std::vector<uint64_t> m_jumpDests;
     int64_t verifyJumpDest(intx::uint256 const& _dest, bool _throw = true);
+    static int64_t findJumpDest(std::vector<uint64_t> const& _jumpDests, intx::uint256 const& _dest);
 
     void onOperation() {}
     void adjustStack(int _removed, int _added);
@@ -77,6 +77,14 @@ void VM::throwBufferOverrun(intx::uint512 const& _endOfAccess)
 }
 
 int64_t VM::verifyJumpDest(intx::uint256 const& _dest, bool _throw)
+{
+    int64_t pc = findJumpDest(m_analysed->jumpDests, _dest);
+    if (pc < 0 && _throw)
+        throwBadJumpDestination();
+    return pc;
+}
+
+int64_t VM::findJumpDest(std::vector<uint64_t> const& _jumpDests, intx::uint256 const& _dest)
 {
     // check for overflow
     if (_dest <= 0x7FFFFFFFFFFFFFFF) {
@@ -84,11 +92,9 @@ int64_t VM::verifyJumpDest(intx::uint256 const& _dest, bool _throw)
         // check for within bounds and to a jump destination
         // use binary search of array because hashtable collisions are exploitable
         uint64_t pc = uint64_t(_dest);
-        if (std::binary_search(m_jumpDests.begin(), m_jumpDests.end(), pc))
+        if (std::binary_search(_jumpDests.begin(), _jumpDests.end(), pc))
             return pc;
     }
-    if (_throw)
-        throwBadJumpDestination();
     return -1;
 }
 
@@ -2,6 +2,10 @@
 // Copyright 2016-2019 Aleth Authors.
 // Licensed under the GNU General Public License, Version 3.
 #include "VM.h"
+#include "CodeHash.h"
+
+#include <map>
+#include <mutex>
 
 namespace dev
 {
@@ -28,29 +32,26 @@ bool VM::initMetrics()
     return true;
 }
 
-void VM::copyCode(int _extraBytes)
+void VM::analyse(AnalysedCode& o_code, uint8_t const* _code, size_t _codeSize)
 {
     // Copy code so that it can be safely modified and extend code by
-    // _extraBytes zero bytes to allow reading virtual data at the end
+    // 33 zero bytes to allow reading virtual data at the end
     // of the code without bounds checks.
-    auto extendedSize = m_codeSize + _extraBytes;
-    m_code.reserve(extendedSize);
-    m_code.assign(m_pCode, m_pCode + m_codeSize);
-    m_code.resize(extendedSize);
-}
-
-void VM::optimize()
-{
-    copyCode(33);
+    bytes& code = o_code.code;
+    o_code.jumpDests.clear();
+    o_code.pool.clear();
+    code.reserve(_codeSize + 33);
+    code.assign(_code, _code + _codeSize);
+    code.resize(_codeSize + 33);
 
-    size_t const nBytes = m_codeSize;
+    size_t const nBytes = _codeSize;
 
     // build a table of jump destinations for use in verifyJumpDest
     
     TRACE_STR(1, "Build JUMPDEST table")
     for (size_t pc = 0; pc < nBytes; ++pc)
     {
-        Instruction op = Instruction(m_code[pc]);
+        Instruction op = Instruction(code[pc]);
         TRACE_OP(2, pc, op);
                 
         // make synthetic ops in user code trigger invalid instruction if run
@@ -61,12 +62,12 @@ void VM::optimize()
         )
         {
             TRACE_OP(1, pc, op);
-            m_code[pc] = (byte)Instruction::UNDEFINED;
+            code[pc] = (byte)Instruction::UNDEFINED;
         }
 
         if (op == Instruction::JUMPDEST)
         {
-            m_jumpDests.push_back(pc);
+            o_code.jumpDests.push_back(pc);
         }
         else if (
             (byte)Instruction::PUSH1 <= (byte)op &&
@@ -83,16 +84,16 @@ void VM::optimize()
     for (size_t pc = 0; pc < nBytes; ++pc)
     {
         intx::uint256 val = 0;
-        Instruction op = Instruction(m_code[pc]);
+        Instruction op = Instruction(code[pc]);
 
         if ((byte)Instruction::PUSH1 <= (byte)op && (byte)op <= (byte)Instruction::PUSH32)
         {
             byte nPush = (byte)op - (byte)Instruction::PUSH1 + 1;
 
             // decode pushed bytes to integral value
-            val = m_code[pc+1];
+            val = code[pc+1];
             for (uint64_t i = pc+2, n = nPush; --n; ++i) {
-                val = (val << 8) | m_code[i];
+                val = (val << 8) | code[i];
             }
 
         #if EVM_USE_CONSTANT_POOL
@@ -102,16 +103,16 @@ void VM::optimize()
             // followed by one byte count of remaining pushed bytes
             if (5 < nPush)
             {
-                uint16_t pool_off = m_pool.size();
+                uint16_t pool_off = o_code.pool.size();
                 TRACE_VAL(1, "stash", val);
                 TRACE_VAL(1, "... in pool at offset" , pool_off);
-                m_pool.push_back(val);
+                o_code.pool.push_back(val);
 
                 TRACE_PRE_OPT(1, pc, op);
-                m_code[pc] = byte(op = Instruction::PUSHC);
-                m_code[pc+3] = nPush - 2;
-                m_code[pc+2] = pool_off & 0xff;
-                m_code[pc+1] = pool_off >> 8;
+                code[pc] = byte(op = Instruction::PUSHC);
+                code[pc+3] = nPush - 2;
+                code[pc+2] = pool_off & 0xff;
+                code[pc+1] = pool_off >> 8;
                 TRACE_POST_OPT(1, pc, op);
             }
 
@@ -123,14 +124,14 @@ void VM::optimize()
             // outer loop is N = number of bytes in code array
             // so complexity is N log M, worst case is N log N
             size_t i = pc + nPush + 1;
-            op = Instruction(m_code[i]);
+            op = Instruction(code[i]);
             if (op == Instruction::JUMP)
             {
                 TRACE_VAL(1, "Replace const JUMP with JUMPC to", val)
                 TRACE_PRE_OPT(1, i, op);
                 
-                if (0 <= verifyJumpDest(val, false))
-                    m_code[i] = byte(op = Instruction::JUMPC);
+                if (0 <= findJumpDest(o_code.jumpDests, val))
+                    code[i] = byte(op = Instruction::JUMPC);
                 
                 TRACE_POST_OPT(1, i, op);
             }
@@ -139,8 +140,8 @@ void VM::optimize()
                 TRACE_VAL(1, "Replace const JUMPI with JUMPCI to", val)
                 TRACE_PRE_OPT(1, i, op);
                 
-                if (0 <= verifyJumpDest(val, false))
-                    m_code[i] = byte(op = Instruction::JUMPCI);
+                if (0 <= findJumpDest(o_code.jumpDests, val))
+                    code[i] = byte(op = Instruction::JUMPCI);
                 
                 TRACE_POST_OPT(1, i, op);
             }
@@ -154,13 +155,80 @@ void VM::optimize()
 }
 
 
+namespace
+{
+/// analyses shared by code hash, bounded by code bytes, a random one is evicted when full
+class AnalysedCodeCache
+{
+public:
+    std::shared_ptr<AnalysedCode const> get(h256 const& _codeHash)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_codes.find(_codeHash);
+        return it == m_codes.end() ? nullptr : it->second;
+    }
+
+    void put(h256 const& _codeHash, std::shared_ptr<AnalysedCode const> const& _code)
+    {
+        if (_code->code.size() > c_maxBytes)
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_codes.count(_codeHash))
+            return;
+        while (!m_codes.empty() && m_bytes + _code->code.size() > c_maxBytes)
+        {
+            auto it = m_codes.lower_bound(h256::random());
+            if (it == m_codes.end())
+                it = m_codes.begin();
+            m_bytes -= it->second->code.size();
+            m_codes.erase(it);
+        }
+        m_codes.emplace(_codeHash, _code);
+        m_bytes += _code->code.size();
+    }
+
+private:
+    static constexpr size_t c_maxBytes = 64 * 1024 * 1024;
+    std::mutex m_mutex;
+    std::map<h256, std::shared_ptr<AnalysedCode const>> m_codes;
+    size_t m_bytes = 0;
+};
+
+AnalysedCodeCache s_analysedCodes;
+}
+
+std::shared_ptr<AnalysedCode const> VM::sharedAnalysis(h256 const& _codeHash, uint8_t const* _code, size_t _codeSize)
+{
+    std::shared_ptr<AnalysedCode const> result = s_analysedCodes.get(_codeHash);
+    if (!result)
+    {
+        // analysed twice at worst when two threads miss at once, the results are the same
+        auto code = std::make_shared<AnalysedCode>();
+        analyse(*code, _code, _codeSize);
+        result = code;
+        s_analysedCodes.put(_codeHash, result);
+    }
+    return result;
+}
+
+
 //
 // Init interpreter on entry.
 //
 void VM::initEntry()
 {
     m_bounce = &VM::interpretCases;
-    optimize();
+    if (h256 const* codeHash = notedCodeHash(m_pCode, m_codeSize))
+    {
+        m_sharedCode = sharedAnalysis(*codeHash, m_pCode, m_codeSize);
+        m_analysed = m_sharedCode.get();
+    }
+    else
+    {
+        analyse(m_ownCode, m_pCode, m_codeSize);
+        m_analysed = &m_ownCode;
+    }
+    m_code = m_analysed->code.data();
 }
 }
 }
@@ -368,7 +368,8 @@ void mcp_daemon::add_options(boost::program_options::options_description & descr
 {
 	description_a.add_options()
 		("config", boost::program_options::value<std::string>(), "Config file")
-		("network", boost::program_options::value<unsigned>(), "Network id");
+		("network", boost::program_options::value<unsigned>(), "Network id")
+		("genesis", boost::program_options::value<std::string>(), "Genesis file of a local mini test network (from, to, value, exec_timestamp, witnesses)");
 
     //node
     description_a.add_options()
@@ -415,7 +416,8 @@ void mcp_daemon::add_options(boost::program_options::options_description & descr
 	//database
 	description_a.add_options()
 		("cache", boost::program_options::value<uint64_t>(), "database block cache")
-		("write_buffer", boost::program_options::value<uint64_t>(), "database write buffer");
+		("write_buffer", boost::program_options::value<uint64_t>(), "database write buffer")
+		("db_profile", boost::program_options::value<std::string>(), "database profile: validator, rpc-archive or sync-bootstrap");
 }
 
 bool mcp_daemon::parse_command_to_config(mcp_daemon::daemon_config & config_a, boost::program_options::variables_map const & vm_a)
@@ -567,10 +569,61 @@ bool mcp_daemon::parse_command_to_config(mcp_daemon::daemon_config & config_a, b
 	{
 		config_a.db.write_buffer_size = vm_a["write_buffer"].as<uint32_t>();
 	}
+	if (vm_a.count("db_profile"))
+	{
+		if (mcp::db::db_profile::preset(vm_a["db_profile"].as<std::string>(), config_a.db.profile))
+		{
+			std::cerr << "Unknown database profile: " << vm_a["db_profile"].as<std::string>() << std::endl;
+			error = true;
+		}
+	}
 
     return error;
 }
 
+bool mcp_daemon::load_genesis_file(boost::filesystem::path const & path_a)
+{
+	std::ifstream genesis_stream(path_a.string());
+	if (!genesis_stream.is_open())
+		return true;
+
+	mcp::json j_genesis;
+	try
+	{
+		j_genesis = mcp::json::parse(genesis_stream);
+	}
+	catch (std::exception const & e)
+	{
+		std::cerr << "Genesis file parse error: " << e.what() << std::endl;
+		return true;
+	}
+
+	if (!(j_genesis.count("from") && j_genesis["from"].is_string() && mcp::isAddress(j_genesis["from"].get<std::string>())
+		&& j_genesis.count("to") && j_genesis["to"].is_string() && mcp::isAddress(j_genesis["to"].get<std::string>())
+		&& j_genesis.count("value") && j_genesis["value"].is_string()
+		&& j_genesis.count("exec_timestamp")
+		&& j_genesis.count("witnesses") && j_genesis["witnesses"].is_array() && !j_genesis["witnesses"].empty()))
+		return true;
+
+	std::vector<std::string> witnesses;
+	for (auto const & w : j_genesis["witnesses"])
+	{
+		if (!w.is_string() || !mcp::isAddress(w.get<std::string>()))
+			return true;
+		witnesses.push_back(w.get<std::string>());
+	}
+
+	if (j_genesis["exec_timestamp"].is_number_unsigned())
+		j_genesis["exec_timestamp"] = std::to_string(j_genesis["exec_timestamp"].get<uint64_t>());
+	if (!j_genesis.count("data"))
+		j_genesis["data"] = "";
+	j_genesis.erase("witnesses");
+
+	mcp::custom_genesis_data = j_genesis.dump();
+	mcp::custom_genesis_witnesses = witnesses;
+	return false;
+}
+
 std::string mcp_daemon::get_home_directory(std::string path)
 {
     if (path.size() && path[0] == '~')
@@ -635,6 +688,22 @@ void mcp_daemon::daemon::run(boost::filesystem::path const &data_path, boost::pr
 	config.logging.init(data_path);
 	mcp::log::init(config.logging);
 
+	///local genesis
+	if (vm.count("genesis"))
+	{
+		std::string genesis_path(get_home_directory(vm["genesis"].as<std::string>()));
+		if (mcp::mcp_network != mcp::mcp_networks::mcp_mini_test_network)
+		{
+			std::cerr << "Genesis file is only supported on the mini test network\n";
+			return;
+		}
+		if (mcp_daemon::load_genesis_file(genesis_path))
+		{
+			std::cerr << "Error genesis file, path:" << genesis_path << "\n";
+			return;
+		}
+	}
+
 	///default bootstrap nodes
 	if (config.p2p.bootstrap_nodes.empty())
     {
@@ -785,6 +854,7 @@ void mcp_daemon::daemon::run(boost::filesystem::path const &data_path, boost::pr
 			return;
 		capability->set_processor(processor);
 		sync->set_processor(processor);
+		processor->onCommitted([composer]() { composer->on_committed(); });
 
 		///wallet
 		std::shared_ptr<mcp::wallet> wallet(std::make_shared<mcp::wallet>(chain_store, cache, key_manager, TQ));
@@ -805,7 +875,8 @@ void mcp_daemon::daemon::run(boost::filesystem::path const &data_path, boost::pr
 			mcp::error_message error_msg;
 			witness = std::make_shared<mcp::witness>(error_msg,
 				key_manager, chain_store, alarm, composer, chain, processor, cache, TQ, AQ,
-				config.witness.account_or_file, config.witness.password);
+				config.witness.account_or_file, config.witness.password,
+				config.witness.min_delay, config.witness.max_delay);
 
 			if (error_msg.error)
 			{
@@ -828,26 +899,34 @@ void mcp_daemon::daemon::run(boost::filesystem::path const &data_path, boost::pr
 			LOG(m_log.info) << "RPC is disabled";
 		}
 
-		//std::shared_ptr<mcp::rpc_ws> rpc_ws = get_rpc_ws(io_service, background, config.rpc_ws);
-		//if (config.rpc_ws.rpc_ws_enable)
-		//{
-		//	rpc_ws->start();
-		//	rpc_ws->register_subscribe("new_block");
-		//	rpc_ws->register_subscribe("stable_block");
-		//	chain->set_ws_new_block_func(
-		//		std::bind(&mcp::rpc_ws::on_new_block, rpc_ws, std::placeholders::_1)
-		//	);
-		//	chain->set_ws_stable_block_func(
-		//		std::bind(&mcp::rpc_ws::on_stable_block, rpc_ws, std::placeholders::_1)
-		//	);
-		//	chain->set_ws_stable_mci_func(
-		//		std::bind(&mcp::rpc_ws::on_stable_mci, rpc_ws, std::placeholders::_1)
-		//	);
-		//}
-		//else
-		//{
-		//	LOG(m_log.info) << "WebSocket RPC is disabled";
-		//}
+		/// JSON-RPC over websocket with the methods of the http rpc
+		std::shared_ptr<mcp::rpc_ws> rpc_ws = get_rpc_ws(io_service, background, config.rpc_ws, rpc);
+		if (config.rpc_ws.rpc_ws_enable)
+		{
+			rpc_ws->start();
+			rpc_ws->register_subscribe("new_block");
+			rpc_ws->register_subscribe("stable_block");
+		}
+		else
+		{
+			LOG(m_log.info) << "WebSocket RPC is disabled";
+		}
+
+		if (config.rpc.rpc_enable || config.rpc_ws.rpc_ws_enable)
+			rpc->start_calls();
+		if (config.rpc_ws.rpc_ws_enable)
+		{
+			/// the handlers post to the background, the block processor is not held up by subscribers
+			chain->set_ws_new_block_func(
+				std::bind(&mcp::rpc_ws::on_new_block, rpc_ws, std::placeholders::_1)
+			);
+			chain->set_ws_stable_block_func(
+				std::bind(&mcp::rpc_ws::on_stable_block, rpc_ws, std::placeholders::_1)
+			);
+		}
+
+		/// after every handler of the processor, chain and queue signals is registered
+		processor->start();
 
 		ongoing_report(chain_store, host, sync_async, background, cache,
 			sync, processor, capability,chain, alarm, TQ, AQ, witness, m_log);
@@ -893,8 +972,22 @@ void mcp_daemon::ongoing_report(
 			peer_metrics_info << ", write queue buffer size:" << p->write_queue_buffer_size;
 			peer_metrics_info << ", send size:" << p->send_size;
 			peer_metrics_info << ", send count:" << p->send_count;
+			std::string const class_names[] = { "critical", "gossip", "bulk" };
+			for (size_t c = 0; c < mcp::p2p::send_class_count; c++)
+				peer_metrics_info << ", " << class_names[c] << " queue:" << p->classes[c].queue_size << "/" << p->classes[c].queue_bytes << "B"
+					<< " sent:" << p->classes[c].send_count << "/" << p->classes[c].send_size << "B"
+					<< " dropped:" << p->classes[c].dropped_count;
 			LOG(log.info) << peer_metrics_info.str();
 		}
+
+		LOG(log.info) << "peer:" << i.first
+			<< ", score:" << p->score.score()
+			<< ", rtt:" << p->score.rtt() << "ms"
+			<< ", success rate:" << p->score.success_rate()
+			<< ", throughput:" << p->score.throughput() << "B/s"
+			<< ", write queue pressure:" << p->score.write_queue_pressure() << "B"
+			<< ", responses:" << p->score.responses()
+			<< ", timeouts:" << p->score.timeouts();
 	}
 
 	//io service
@@ -939,6 +1032,8 @@ void mcp_daemon::ongoing_report(
 		<< ", transaction_request:" << mcp::CapMetricsSend.transaction_request
 		<< ", send_transaction:" << mcp::CapMetricsSend.send_transaction
 		<< ", transaction:" << mcp::CapMetricsSend.transaction
+		<< ", transaction_hashes:" << mcp::CapMetricsSend.transaction_hashes
+		<< ", transactions_request:" << mcp::CapMetricsSend.transactions_request
 		<< ", broadcast_approve:" << mcp::CapMetricsSend.broadcast_approve
 		<< ", approve_request:" << mcp::CapMetricsSend.approve_request
 		<< ", send_approve:" << mcp::CapMetricsSend.send_approve
@@ -963,6 +1058,8 @@ void mcp_daemon::ongoing_report(
 		<< ", transaction_request:" << mcp::CapMetricsRecieved.transaction_request
 		<< ", send_transaction:" << mcp::CapMetricsRecieved.send_transaction
 		<< ", transaction:" << mcp::CapMetricsRecieved.transaction
+		<< ", transaction_hashes:" << mcp::CapMetricsRecieved.transaction_hashes
+		<< ", transactions_request:" << mcp::CapMetricsRecieved.transactions_request
 		<< ", approve_request:" << mcp::CapMetricsRecieved.approve_request
 		<< ", send_approve:" << mcp::CapMetricsRecieved.send_approve
 		<< ", approve:" << mcp::CapMetricsRecieved.approve
@@ -984,6 +1081,7 @@ void mcp_daemon::ongoing_report(
 		LOG(log.info) << "witness:" << witness->getInfo();
 
 	LOG(log.info) << store.get_rocksdb_state(32 * 1024 * 1024);
+	LOG(log.info) << "Rocksdb telemetry: " << store.get_rocksdb_telemetry_summary();
 
 	auto elapseds = mcp::stopwatch_manager::list_elapseds();
 	for (auto p : elapseds)
@@ -30,6 +30,8 @@ namespace mcp_daemon
 		mcp::log& log
 	);
     std::string get_home_directory(std::string path);
+	/// custom genesis of the mini test network, true on error
+	bool load_genesis_file(boost::filesystem::path const & path_a);
 	class daemon
 	{
 	public:
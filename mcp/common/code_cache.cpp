@@ -0,0 +1,39 @@
+#include "code_cache.hpp"
+
+mcp::code_cache::code_ptr mcp::code_cache::get(dev::h256 const & hash_a) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it(m_codes.find(hash_a));
+	if (it == m_codes.end())
+		return nullptr;
+	return it->second;
+}
+
+void mcp::code_cache::put(dev::h256 const & hash_a, code_ptr const & code_a)
+{
+	if (!code_a || code_a->empty() || code_a->size() > max_bytes)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_codes.count(hash_a))
+		return;
+	while (!m_codes.empty() && m_bytes + code_a->size() > max_bytes)
+		remove_random_element();
+	m_codes.emplace(hash_a, code_a);
+	m_bytes += code_a->size();
+}
+
+mcp::code_cache & mcp::code_cache::instance()
+{
+	static mcp::code_cache cache;
+	return cache;
+}
+
+void mcp::code_cache::remove_random_element()
+{
+	auto it(m_codes.lower_bound(dev::h256::random()));
+	if (it == m_codes.end())
+		it = m_codes.begin();
+	m_bytes -= it->second->size();
+	m_codes.erase(it);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace mcp
+{
+	/// Immutable contract code shared by every state and execution that runs it, keyed by code hash.
+	/// Bounded by total code bytes, a random entry is evicted when full.
+	class code_cache
+	{
+	public:
+		using code_ptr = std::shared_ptr<dev::bytes const>;
+
+		/// null if not cached
+		code_ptr get(dev::h256 const & hash_a) const;
+		void put(dev::h256 const & hash_a, code_ptr const & code_a);
+
+		static code_cache & instance();
+
+	private:
+		void remove_random_element();
+
+		static size_t const max_bytes = 64 * 1024 * 1024;
+		mutable std::mutex m_mutex;
+		std::map<dev::h256, code_ptr> m_codes;
+		size_t m_bytes = 0;
+	};
+}
@@ -96,7 +96,7 @@ dev::Slice mcp::value_previous_work::val() const
 
 //store
 mcp::key_store::key_store(bool & error_a, boost::filesystem::path const& _path) :
-	m_database(std::make_shared<mcp::db::database>(_path))
+	m_database(std::make_shared<mcp::db::database>(_path, "keys"))
 {
 	if (error_a)
 		return;
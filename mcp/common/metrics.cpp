@@ -0,0 +1,298 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	/// index of the highest set bit, value must not be 0
+	unsigned highest_bit(uint64_t const & value_a)
+	{
+#ifdef _MSC_VER
+		unsigned long result;
+		_BitScanReverse64(&result, value_a);
+		return result;
+#else
+		return 63 - __builtin_clzll(value_a);
+#endif
+	}
+}
+
+size_t mcp::metrics::this_shard()
+{
+	static std::atomic<size_t> next = { 0 };
+	thread_local size_t const shard = next.fetch_add(1, std::memory_order_relaxed) % shard_count;
+	return shard;
+}
+
+mcp::metrics::metric::metric(std::string const & name_a, std::string const & help_a, std::string const & labels_a, char const * type_a) :
+	name(name_a),
+	help(help_a),
+	labels(labels_a),
+	type(type_a)
+{
+}
+
+mcp::metrics::metric::~metric()
+{
+	mcp::metrics::registry::instance().remove(this);
+}
+
+std::string mcp::metrics::metric::series(std::string const & suffix_a, std::string const & extra_label_a) const
+{
+	std::string result(name + suffix_a);
+	if (labels.empty() && extra_label_a.empty())
+		return result;
+
+	result += "{" + labels;
+	if (!labels.empty() && !extra_label_a.empty())
+		result += ",";
+	result += extra_label_a + "}";
+	return result;
+}
+
+mcp::metrics::counter::counter(std::string const & name_a, std::string const & help_a, std::string const & labels_a) :
+	metric(name_a, help_a, labels_a, "counter")
+{
+	mcp::metrics::registry::instance().add(this);
+}
+
+uint64_t mcp::metrics::counter::value() const
+{
+	uint64_t result(0);
+	for (auto const & s : m_shards)
+		result += s.value.load(std::memory_order_relaxed);
+	return result;
+}
+
+void mcp::metrics::counter::render(std::ostream & out_a) const
+{
+	out_a << series("") << " " << value() << "\n";
+}
+
+mcp::metrics::gauge::gauge(std::string const & name_a, std::string const & help_a, std::string const & labels_a) :
+	metric(name_a, help_a, labels_a, "gauge")
+{
+	mcp::metrics::registry::instance().add(this);
+}
+
+int64_t mcp::metrics::gauge::value() const
+{
+	int64_t result(m_base.load(std::memory_order_relaxed));
+	for (auto const & s : m_shards)
+		result += s.value.load(std::memory_order_relaxed);
+	return result;
+}
+
+void mcp::metrics::gauge::render(std::ostream & out_a) const
+{
+	out_a << series("") << " " << value() << "\n";
+}
+
+mcp::metrics::callback_gauge::callback_gauge(std::string const & name_a, std::string const & help_a, std::function<double()> const & callback_a, std::string const & labels_a) :
+	metric(name_a, help_a, labels_a, "gauge"),
+	m_callback(callback_a)
+{
+	mcp::metrics::registry::instance().add(this);
+}
+
+void mcp::metrics::callback_gauge::render(std::ostream & out_a) const
+{
+	out_a << series("") << " " << m_callback() << "\n";
+}
+
+mcp::metrics::histogram::shard::shard()
+{
+	for (auto & b : buckets)
+		b.store(0, std::memory_order_relaxed);
+}
+
+mcp::metrics::histogram::histogram(std::string const & name_a, std::string const & help_a, std::string const & labels_a) :
+	metric(name_a, help_a, labels_a, "summary"),
+	m_shards(std::make_unique<std::array<shard, histogram_shard_count>>())
+{
+	mcp::metrics::registry::instance().add(this);
+}
+
+size_t mcp::metrics::histogram::bucket_index(uint64_t const & us_a)
+{
+	if (us_a < sub_bucket_count)
+		return us_a;
+
+	unsigned exponent(highest_bit(us_a));
+	if (exponent > max_exponent)
+		return bucket_count - 1;
+
+	size_t sub((us_a >> (exponent - sub_bucket_bits)) & (sub_bucket_count - 1));
+	return (exponent - sub_bucket_bits + 1) * sub_bucket_count + sub;
+}
+
+uint64_t mcp::metrics::histogram::bucket_upper_bound(size_t const & index_a)
+{
+	if (index_a < sub_bucket_count)
+		return index_a;
+
+	unsigned exponent(index_a / sub_bucket_count + sub_bucket_bits - 1);
+	uint64_t sub(index_a % sub_bucket_count);
+	uint64_t width(uint64_t(1) << (exponent - sub_bucket_bits));
+	return (sub_bucket_count + sub) * width + width - 1;
+}
+
+void mcp::metrics::histogram::record(uint64_t const & us_a)
+{
+	shard & s((*m_shards)[this_shard() % histogram_shard_count]);
+	s.buckets[bucket_index(us_a)].fetch_add(1, std::memory_order_relaxed);
+	s.sum.fetch_add(us_a, std::memory_order_relaxed);
+	s.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void mcp::metrics::histogram::merge(std::vector<uint64_t> & buckets_a, uint64_t & sum_a, uint64_t & count_a) const
+{
+	buckets_a.assign(bucket_count, 0);
+	sum_a = 0;
+	count_a = 0;
+	for (auto const & s : *m_shards)
+	{
+		for (size_t i = 0; i < bucket_count; i++)
+		{
+			uint64_t n(s.buckets[i].load(std::memory_order_relaxed));
+			buckets_a[i] += n;
+			/// count from buckets, consistent with quantiles even if a record is in flight
+			count_a += n;
+		}
+		sum_a += s.sum.load(std::memory_order_relaxed);
+	}
+}
+
+uint64_t mcp::metrics::histogram::count() const
+{
+	uint64_t result(0);
+	for (auto const & s : *m_shards)
+		result += s.count.load(std::memory_order_relaxed);
+	return result;
+}
+
+namespace
+{
+	uint64_t quantile_of(std::vector<uint64_t> const & buckets_a, uint64_t const & count_a, double const & q_a)
+	{
+		if (count_a == 0)
+			return 0;
+
+		uint64_t rank(std::max<uint64_t>(1, std::ceil(q_a * count_a)));
+		uint64_t seen(0);
+		for (size_t i = 0; i < buckets_a.size(); i++)
+		{
+			seen += buckets_a[i];
+			if (seen >= rank)
+				return mcp::metrics::histogram::bucket_upper_bound(i);
+		}
+		return mcp::metrics::histogram::bucket_upper_bound(buckets_a.size() - 1);
+	}
+}
+
+uint64_t mcp::metrics::histogram::quantile(double const & q_a) const
+{
+	std::vector<uint64_t> buckets;
+	uint64_t sum, count;
+	merge(buckets, sum, count);
+	return quantile_of(buckets, count, q_a);
+}
+
+void mcp::metrics::histogram::render(std::ostream & out_a) const
+{
+	std::vector<uint64_t> buckets;
+	uint64_t sum, count;
+	merge(buckets, sum, count);
+
+	for (auto q : { "0.5", "0.9", "0.99", "0.999" })
+		out_a << series("", std::string("quantile=\"") + q + "\"") << " " << quantile_of(buckets, count, std::stod(q)) / 1e6 << "\n";
+	out_a << series("_sum") << " " << sum / 1e6 << "\n";
+	out_a << series("_count") << " " << count << "\n";
+}
+
+mcp::metrics::registry & mcp::metrics::registry::instance()
+{
+	static registry result;
+	return result;
+}
+
+void mcp::metrics::registry::add(metric * metric_a)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_metrics.push_back(metric_a);
+}
+
+void mcp::metrics::registry::remove(metric * metric_a)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_metrics.erase(std::remove(m_metrics.begin(), m_metrics.end(), metric_a), m_metrics.end());
+}
+
+template <class T>
+T & mcp::metrics::registry::get_or_create(std::string const & name_a, std::string const & help_a, std::string const & labels_a)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto const & m : m_owned)
+		{
+			if (m->name == name_a && m->labels == labels_a)
+				return static_cast<T &>(*m);
+		}
+	}
+
+	/// constructor registers itself, must not hold the lock
+	auto created(std::make_unique<T>(name_a, help_a, labels_a));
+	T & result(*created);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto const & m : m_owned)
+	{
+		if (m->name == name_a && m->labels == labels_a)
+		{
+			/// lost a race, keep ours unregistered
+			m_metrics.erase(std::remove(m_metrics.begin(), m_metrics.end(), created.get()), m_metrics.end());
+			T & existing(static_cast<T &>(*m));
+			m_owned.push_back(std::move(created));
+			return existing;
+		}
+	}
+	m_owned.push_back(std::move(created));
+	return result;
+}
+
+mcp::metrics::counter & mcp::metrics::registry::counter(std::string const & name_a, std::string const & help_a, std::string const & labels_a)
+{
+	return get_or_create<mcp::metrics::counter>(name_a, help_a, labels_a);
+}
+
+mcp::metrics::histogram & mcp::metrics::registry::histogram(std::string const & name_a, std::string const & help_a, std::string const & labels_a)
+{
+	return get_or_create<mcp::metrics::histogram>(name_a, help_a, labels_a);
+}
+
+std::string mcp::metrics::registry::render()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<metric *> sorted(m_metrics);
+	std::stable_sort(sorted.begin(), sorted.end(), [](metric * a, metric * b) { return a->name < b->name; });
+
+	std::ostringstream out;
+	std::string last_name;
+	for (auto m : sorted)
+	{
+		if (m->name != last_name)
+		{
+			out << "# HELP " << m->name << " " << m->help << "\n";
+			out << "# TYPE " << m->name << " " << m->type << "\n";
+			last_name = m->name;
+		}
+		m->render(out);
+	}
+	return out.str();
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace mcp
+{
+	namespace metrics
+	{
+		/// number of shards, threads are spread over the shards round robin
+		constexpr size_t shard_count = 16;
+
+		/// shard index of the calling thread
+		size_t this_shard();
+
+		class metric
+		{
+		public:
+			metric(std::string const & name_a, std::string const & help_a, std::string const & labels_a, char const * type_a);
+			virtual ~metric();
+			metric(metric const &) = delete;
+			metric & operator=(metric const &) = delete;
+
+			/// prometheus text exposition format, without HELP and TYPE
+			virtual void render(std::ostream & out_a) const = 0;
+
+			std::string const name;
+			std::string const help;
+			/// e.g. method="eth_call", empty if none
+			std::string const labels;
+			char const * const type;
+
+		protected:
+			std::string series(std::string const & suffix_a, std::string const & extra_label_a = "") const;
+		};
+
+		/// monotonic counter, add is a relaxed atomic on the shard of the calling thread
+		class counter : public metric
+		{
+		public:
+			counter(std::string const & name_a, std::string const & help_a, std::string const & labels_a = "");
+			void add(uint64_t const & value_a = 1)
+			{
+				m_shards[this_shard()].value.fetch_add(value_a, std::memory_order_relaxed);
+			}
+			uint64_t value() const;
+			void render(std::ostream & out_a) const override;
+
+		private:
+			struct alignas(64) shard
+			{
+				std::atomic<uint64_t> value = { 0 };
+			};
+			std::array<shard, shard_count> m_shards;
+		};
+
+		/// a gauge is either set as a whole or moved by add/sub, do not mix both on one gauge
+		class gauge : public metric
+		{
+		public:
+			gauge(std::string const & name_a, std::string const & help_a, std::string const & labels_a = "");
+			void set(int64_t const & value_a)
+			{
+				m_base.store(value_a, std::memory_order_relaxed);
+			}
+			void add(int64_t const & value_a = 1)
+			{
+				m_shards[this_shard()].value.fetch_add(value_a, std::memory_order_relaxed);
+			}
+			void sub(int64_t const & value_a = 1)
+			{
+				add(-value_a);
+			}
+			int64_t value() const;
+			void render(std::ostream & out_a) const override;
+
+		private:
+			struct alignas(64) shard
+			{
+				std::atomic<int64_t> value = { 0 };
+			};
+			std::atomic<int64_t> m_base = { 0 };
+			std::array<shard, shard_count> m_shards;
+		};
+
+		/// value sampled when scraped, for sizes already tracked elsewhere
+		class callback_gauge : public metric
+		{
+		public:
+			callback_gauge(std::string const & name_a, std::string const & help_a, std::function<double()> const & callback_a, std::string const & labels_a = "");
+			void render(std::ostream & out_a) const override;
+
+		private:
+			std::function<double()> m_callback;
+		};
+
+		/// HDR style latency histogram in microseconds:
+		/// exact below 8us, then 8 linear sub buckets per power of two (relative error < 12.5%), up to ~25 days.
+		/// rendered as prometheus summary in seconds.
+		class histogram : public metric
+		{
+		public:
+			histogram(std::string const & name_a, std::string const & help_a, std::string const & labels_a = "");
+			void record(uint64_t const & us_a);
+			void record(std::chrono::steady_clock::duration const & duration_a)
+			{
+				record(std::chrono::duration_cast<std::chrono::microseconds>(duration_a).count());
+			}
+			/// upper bound in microseconds of the bucket holding the quantile, 0 if empty
+			uint64_t quantile(double const & q_a) const;
+			uint64_t count() const;
+			void render(std::ostream & out_a) const override;
+
+			static constexpr unsigned sub_bucket_bits = 3;
+			static constexpr unsigned sub_bucket_count = 1 << sub_bucket_bits;
+			static constexpr unsigned max_exponent = 40;
+			static constexpr unsigned bucket_count = (max_exponent - sub_bucket_bits + 2) * sub_bucket_count;
+			static size_t bucket_index(uint64_t const & us_a);
+			static uint64_t bucket_upper_bound(size_t const & index_a);
+
+		private:
+			/// threads recording into one histogram are far fewer than into counters
+			static constexpr size_t histogram_shard_count = 8;
+			struct alignas(64) shard
+			{
+				std::atomic<uint64_t> sum = { 0 };
+				std::atomic<uint64_t> count = { 0 };
+				std::array<std::atomic<uint64_t>, bucket_count> buckets;
+				shard();
+			};
+			std::unique_ptr<std::array<shard, histogram_shard_count>> m_shards;
+			void merge(std::vector<uint64_t> & buckets_a, uint64_t & sum_a, uint64_t & count_a) const;
+		};
+
+		/// records the lifetime of the guard into a histogram
+		class timer_guard
+		{
+		public:
+			timer_guard(histogram & histogram_a) :
+				m_histogram(histogram_a),
+				m_start(std::chrono::steady_clock::now())
+			{
+			}
+
+			~timer_guard()
+			{
+				m_histogram.record(std::chrono::steady_clock::now() - m_start);
+			}
+
+		private:
+			histogram & m_histogram;
+			std::chrono::steady_clock::time_point m_start;
+		};
+
+		/// all live metrics. Hot paths hold static handles, the registry is only locked when metrics are created or scraped.
+		class registry
+		{
+		public:
+			static registry & instance();
+
+			void add(metric * metric_a);
+			void remove(metric * metric_a);
+
+			/// labeled metrics created on demand and owned by the registry, look up once and keep the reference
+			mcp::metrics::counter & counter(std::string const & name_a, std::string const & help_a, std::string const & labels_a);
+			mcp::metrics::histogram & histogram(std::string const & name_a, std::string const & help_a, std::string const & labels_a);
+
+			/// prometheus text exposition format 0.0.4
+			std::string render();
+
+		private:
+			registry() = default;
+			template <class T>
+			T & get_or_create(std::string const & name_a, std::string const & help_a, std::string const & labels_a);
+
+			std::mutex m_mutex;
+			std::vector<metric *> m_metrics;
+			std::vector<std::unique_ptr<metric>> m_owned;
+		};
+	}
+}
@@ -0,0 +1,66 @@
+#include "rolling_filter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+mcp::rolling_filter::rolling_filter(size_t const & capacity_a) :
+	m_capacity(std::max<size_t>(capacity_a, 1)),
+	m_mutex(std::make_shared<std::mutex>())
+{
+	/// load factor at most 3/4
+	size_t slots(1);
+	while (slots * 3 < m_capacity * 4)
+		slots <<= 1;
+	m_mask = slots - 1;
+	for (auto & generation : m_slots)
+		generation.assign(slots, 0);
+}
+
+void mcp::rolling_filter::add(dev::h256 const & hash_a)
+{
+	uint64_t const fp(fingerprint(hash_a));
+	std::lock_guard<std::mutex> lock(*m_mutex);
+	size_t slot(find(m_current, fp));
+	if (m_slots[m_current][slot])
+		return;
+
+	if (m_counts[m_current] >= m_capacity)
+	{
+		m_current ^= 1;
+		std::fill(m_slots[m_current].begin(), m_slots[m_current].end(), 0);
+		m_counts[m_current] = 0;
+		slot = find(m_current, fp);
+	}
+	m_slots[m_current][slot] = fp;
+	m_counts[m_current]++;
+}
+
+bool mcp::rolling_filter::contains(dev::h256 const & hash_a) const
+{
+	uint64_t const fp(fingerprint(hash_a));
+	std::lock_guard<std::mutex> lock(*m_mutex);
+	return m_slots[0][find(0, fp)] || m_slots[1][find(1, fp)];
+}
+
+size_t mcp::rolling_filter::size() const
+{
+	std::lock_guard<std::mutex> lock(*m_mutex);
+	return m_counts[0] + m_counts[1];
+}
+
+uint64_t mcp::rolling_filter::fingerprint(dev::h256 const & hash_a)
+{
+	/// hashes are uniform, their first bytes are as good a fingerprint as any. 0 marks an empty slot
+	uint64_t fp;
+	std::memcpy(&fp, hash_a.data(), sizeof(fp));
+	return fp ? fp : 1;
+}
+
+size_t mcp::rolling_filter::find(size_t const & generation_a, uint64_t const & fingerprint_a) const
+{
+	std::vector<uint64_t> const & slots(m_slots[generation_a]);
+	size_t slot(fingerprint_a & m_mask);
+	while (slots[slot] && slots[slot] != fingerprint_a)
+		slot = (slot + 1) & m_mask;
+	return slot;
+}
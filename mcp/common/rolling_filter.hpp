@@ -0,0 +1,40 @@
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mcp
+{
+	/// Fixed size set of recently added hashes, for gossip suppression. Two generations of open addressed
+	/// 64 bit fingerprints, the older one is cleared and reused when the newer one holds capacity hashes, so it
+	/// remembers at least the last capacity and at most the last 2 * capacity hashes. Does not allocate after construction.
+	/// A hash may be reported as contained when its fingerprint collides with another, never the other way.
+	class rolling_filter
+	{
+	public:
+		rolling_filter(size_t const & capacity_a);
+
+		void add(dev::h256 const & hash_a);
+		bool contains(dev::h256 const & hash_a) const;
+		size_t size() const;
+
+	private:
+		static uint64_t fingerprint(dev::h256 const & hash_a);
+		/// slot holding fingerprint_a in generation_a, or the empty slot it would go to
+		size_t find(size_t const & generation_a, uint64_t const & fingerprint_a) const;
+
+		/// entries of one generation
+		size_t m_capacity;
+		size_t m_mask;
+		std::array<std::vector<uint64_t>, 2> m_slots;
+		std::array<size_t, 2> m_counts = { { 0, 0 } };
+		size_t m_current = 0;
+		/// shared, the filter is moved with the peer owning it
+		std::shared_ptr<std::mutex> m_mutex;
+	};
+}
@@ -0,0 +1,63 @@
+#include "trie_node_cache.hpp"
+
+mcp::trie_node_cache::trie_node_cache() :
+	m_hit(mcp::metrics::registry::instance().counter("mcp_trie_node_cache_requests_total", "trie node cache lookups", "result=\"hit\"")),
+	m_miss(mcp::metrics::registry::instance().counter("mcp_trie_node_cache_requests_total", "trie node cache lookups", "result=\"miss\"")),
+	m_bytes("mcp_trie_node_cache_bytes", "bytes of cached trie nodes")
+{
+}
+
+bool mcp::trie_node_cache::get(dev::h256 const & hash_a, std::string & value_a)
+{
+	shard & s(shard_of(hash_a));
+	{
+		std::lock_guard<std::mutex> lock(s.mutex);
+		auto it(s.nodes.find(hash_a));
+		if (it != s.nodes.end())
+		{
+			value_a = it->second;
+			m_hit.add();
+			return true;
+		}
+	}
+	m_miss.add();
+	return false;
+}
+
+void mcp::trie_node_cache::put(dev::h256 const & hash_a, std::string const & value_a)
+{
+	if (value_a.empty() || value_a.size() > max_shard_bytes)
+		return;
+
+	shard & s(shard_of(hash_a));
+	std::lock_guard<std::mutex> lock(s.mutex);
+	if (s.nodes.count(hash_a))
+		return;
+	while (!s.nodes.empty() && s.bytes + value_a.size() > max_shard_bytes)
+		remove_random_element(s);
+	s.nodes.emplace(hash_a, value_a);
+	s.bytes += value_a.size();
+	m_bytes.add(value_a.size());
+}
+
+mcp::trie_node_cache & mcp::trie_node_cache::instance()
+{
+	static mcp::trie_node_cache cache;
+	return cache;
+}
+
+mcp::trie_node_cache::shard & mcp::trie_node_cache::shard_of(dev::h256 const & hash_a)
+{
+	/// node hashes are uniform already
+	return m_shards[hash_a[0] % shard_count];
+}
+
+void mcp::trie_node_cache::remove_random_element(shard & shard_a)
+{
+	auto it(shard_a.nodes.lower_bound(dev::h256::random()));
+	if (it == shard_a.nodes.end())
+		it = shard_a.nodes.begin();
+	shard_a.bytes -= it->second.size();
+	m_bytes.sub(it->second.size());
+	shard_a.nodes.erase(it);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <mcp/common/metrics.hpp>
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <array>
+#include <map>
+#include <mutex>
+
+namespace mcp
+{
+	/// Clean state trie nodes read from the store, shared by every overlay_db, keyed by node hash.
+	/// Nodes are content addressed, a cached node is never stale. Bounded by total node bytes,
+	/// split in shards locked on their own, a random entry of the shard is evicted when full.
+	class trie_node_cache
+	{
+	public:
+		trie_node_cache();
+
+		/// false if not cached
+		bool get(dev::h256 const & hash_a, std::string & value_a);
+		void put(dev::h256 const & hash_a, std::string const & value_a);
+
+		static trie_node_cache & instance();
+
+	private:
+		static size_t const shard_count = 16;
+		static size_t const max_bytes = 256 * 1024 * 1024;
+		static size_t const max_shard_bytes = max_bytes / shard_count;
+
+		struct shard
+		{
+			std::mutex mutex;
+			std::map<dev::h256, std::string> nodes;
+			size_t bytes = 0;
+		};
+		shard & shard_of(dev::h256 const & hash_a);
+		void remove_random_element(shard & shard_a);
+
+		std::array<shard, shard_count> m_shards;
+
+		mcp::metrics::counter & m_hit;
+		mcp::metrics::counter & m_miss;
+		mcp::metrics::gauge m_bytes;
+	};
+}
@@ -4,6 +4,12 @@
 #include <mcp/core/param.hpp>
 #include <mcp/common/stopwatch.hpp>
 #include <mcp/common/log.hpp>
+#include <mcp/common/metrics.hpp>
+
+namespace
+{
+	mcp::metrics::histogram dag_validate_latency("mcp_block_validation_seconds", "dag validation time of one block");
+}
 
 mcp::validation::validation(
 	mcp::block_store& store_a,
@@ -92,6 +98,7 @@ mcp::base_validate_result mcp::validation::base_validate(mcp::db::db_transaction
 
 mcp::validate_result mcp::validation::dag_validate(mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::iblock_cache> cache_a, mcp::joint_message const &message)
 {
+	mcp::metrics::timer_guard tg(dag_validate_latency);
 	mcp::validate_result result;
 
 	std::shared_ptr<mcp::block> block(message.block);
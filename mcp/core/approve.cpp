@@ -4,7 +4,9 @@
 #include <boost/endian/conversion.hpp>
 #include <mcp/common/common.hpp>
 #include <mcp/common/log.hpp>
+#include <mcp/common/assert.hpp>
 #include "config.hpp"
+#include <algorithm>
 #include <vector>
 
 
@@ -148,11 +150,73 @@ h256 mcp::approve::sha3(IncludeSignature _sig) const
 void mcp::approve::vrf_verify(mcp::block_hash const& msg) const
 {
 	sender();
+	if (m_outputs && m_vrf_msg == msg) ///verified by vrf_verify_batch
+		return;
 	if(!dev::verify(m_outputs, m_proof, m_publicCompressed, msg))
 	{
 		//LOG(g_log.debug) << "[vrf_verify] secp256k1_vrf_verify fail ";
 		BOOST_THROW_EXCEPTION(InvalidSignature());
 	}
+	m_vrf_msg = msg;
 	//LOG(g_log.debug) << "[vrf_verify] secp256k1_vrf_verify ok";
 }
 
+namespace
+{
+	/// batch verification needs the verification tables of a context, built once
+	secp256k1_context const* vrf_verify_context()
+	{
+		static std::unique_ptr<secp256k1_context, decltype(&secp256k1_context_destroy)> s_ctx(
+			secp256k1_context_create(SECP256K1_CONTEXT_VERIFY), &secp256k1_context_destroy);
+		return s_ctx.get();
+	}
+}
+
+void mcp::approve::vrf_verify_batch(std::vector<std::shared_ptr<approve>> const& _approves, std::vector<mcp::block_hash> const& _msgs)
+{
+	assert_x(_approves.size() == _msgs.size());
+
+	std::vector<size_t> indexes;
+	std::vector<unsigned char const*> proofs;
+	std::vector<unsigned char const*> pks;
+	std::vector<unsigned char const*> msgs;
+	std::vector<unsigned int> msglens;
+	for (size_t i = 0; i < _approves.size(); i++)
+	{
+		approve const& ap(*_approves[i]);
+		if (ap.m_outputs && ap.m_vrf_msg == _msgs[i])
+			continue;
+		try
+		{
+			ap.sender();
+		}
+		catch (...)
+		{
+			continue; /// left to vrf_verify, which throws the same error
+		}
+		indexes.push_back(i);
+		proofs.push_back(ap.m_proof.data());
+		pks.push_back(ap.m_publicCompressed.data());
+		msgs.push_back(_msgs[i].data());
+		msglens.push_back(mcp::block_hash::size);
+	}
+	if (indexes.empty())
+		return;
+
+	std::vector<unsigned char> outputs(indexes.size() * h256::size);
+	std::vector<int> results(indexes.size());
+	if (!secp256k1_vrf_verify_batch(vrf_verify_context(), outputs.data(), results.data(),
+		proofs.data(), pks.data(), msgs.data(), msglens.data(), indexes.size()))
+		LOG(g_log.debug) << "[vrf_verify_batch] " << std::count(results.begin(), results.end(), 0)
+			<< " of " << results.size() << " proofs rejected, left to vrf_verify";
+
+	for (size_t j = 0; j < indexes.size(); j++)
+	{
+		if (!results[j])
+			continue;
+		approve const& ap(*_approves[indexes[j]]);
+		ap.m_outputs = h256(&outputs[j * h256::size], h256::ConstructFromPointer);
+		ap.m_vrf_msg = _msgs[indexes[j]];
+	}
+}
+
@@ -66,6 +66,9 @@ namespace mcp
 		void sign(Secret const& _priv);			///< Sign the transaction.
 
 		void vrf_verify(mcp::block_hash const& msg) const;
+		/// Verifies the proofs of @a _approves against @a _msgs in one batch and caches the outputs of the valid ones.
+		/// Never throws, rejected approves are verified again one by one by vrf_verify.
+		static void vrf_verify_batch(std::vector<std::shared_ptr<approve>> const& _approves, std::vector<mcp::block_hash> const& _msgs);
 		h256 outputs() { return m_outputs; }
 		
 		Epoch epoch() const { return m_epoch; }
@@ -80,6 +83,7 @@ namespace mcp
 		mutable h256 m_hashWith;			///< Cached hash of approve with signature.
 		mutable dev::PublicCompressed m_publicCompressed;
 		mutable h256 m_outputs;			    ///< Cached output of proof.
+		mutable mcp::block_hash m_vrf_msg;	///< Message the cached output was verified against.
 		mutable boost::optional<Address> m_sender;  ///< Cached sender, determined from signature.
 	};
 }
@@ -0,0 +1,429 @@
+#include "block_archive.hpp"
+#include <mcp/common/assert.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	size_t const bloom_bits_per_entry = 10;
+	size_t const bloom_hashes = 7;
+
+	void write_u64(std::ostream & out_a, uint64_t const & value_a)
+	{
+		uint64_t value(boost::endian::native_to_little(value_a));
+		out_a.write((char const *)&value, sizeof(value));
+	}
+
+	uint64_t read_u64(char const * data_a)
+	{
+		uint64_t value;
+		std::memcpy(&value, data_a, sizeof(value));
+		return boost::endian::little_to_native(value);
+	}
+
+	uint32_t read_u32(char const * data_a)
+	{
+		uint32_t value;
+		std::memcpy(&value, data_a, sizeof(value));
+		return boost::endian::little_to_native(value);
+	}
+
+	/// streams only flush to the OS, what the database forgets must be on disk first
+	void sync_path(boost::filesystem::path const & path_a, bool const & directory_a = false)
+	{
+#if defined(_WIN32)
+		/// directory entries are written through on windows
+		if (directory_a)
+			return;
+		int fd(_open(path_a.string().c_str(), _O_RDWR | _O_BINARY));
+		bool ok(fd >= 0 && !_commit(fd));
+		if (fd >= 0)
+			_close(fd);
+#else
+		int fd(::open(path_a.string().c_str(), directory_a ? O_RDONLY | O_DIRECTORY : O_RDONLY));
+		bool ok(fd >= 0 && !::fsync(fd));
+		if (fd >= 0)
+			::close(fd);
+#endif
+		if (!ok)
+			throw std::runtime_error("Archive " + path_a.string() + " can not be synced");
+	}
+
+	/// the hashes are uniformly distributed already, two words of them give the probe sequence
+	uint64_t bloom_bit(dev::h256 const & hash_a, size_t const & i_a, uint64_t const & bits_a)
+	{
+		uint64_t h1(read_u64((char const *)hash_a.data()));
+		uint64_t h2(read_u64((char const *)hash_a.data() + 8) | 1);
+		return (h1 + i_a * h2) % bits_a;
+	}
+}
+
+mcp::block_archive::sealed_segment::sealed_segment(boost::filesystem::path const & path_a, uint64_t const & number_a)
+{
+	using namespace boost::interprocess;
+	std::string number(std::to_string(number_a));
+	data_file = file_mapping((path_a / (number + ".data")).string().c_str(), read_only);
+	data = mapped_region(data_file, read_only);
+	index_file = file_mapping((path_a / (number + ".index")).string().c_str(), read_only);
+	index = mapped_region(index_file, read_only);
+	hashes_file = file_mapping((path_a / (number + ".hashes")).string().c_str(), read_only);
+	hashes = mapped_region(hashes_file, read_only);
+
+	char const * header((char const *)hashes.get_address());
+	entry_count = read_u64(header);
+	bloom_words = read_u64(header + 8);
+	assert_x_msg(index.get_size() == segment_size * 8, "archive segment " + number + " index is not complete");
+	assert_x_msg(hashes.get_size() == 16 + bloom_words * 8 + entry_count * entry_size, "archive segment " + number + " hashes are not complete");
+}
+
+dev::bytesConstRef mcp::block_archive::sealed_segment::record(uint64_t const & offset_a) const
+{
+	char const * base((char const *)data.get_address());
+	assert_x(offset_a + header_size <= data.get_size());
+	uint32_t size(read_u32(base + offset_a + 33));
+	assert_x(offset_a + header_size + size <= data.get_size());
+	return dev::bytesConstRef((dev::byte const *)base + offset_a, header_size + size);
+}
+
+bool mcp::block_archive::sealed_segment::find(archive_record const & type_a, dev::h256 const & hash_a, dev::bytesConstRef & value_a) const
+{
+	char const * base((char const *)hashes.get_address());
+	char const * bloom(base + 16);
+	uint64_t bits(bloom_words * 64);
+	for (size_t i = 0; i < bloom_hashes; i++)
+	{
+		uint64_t bit(bloom_bit(hash_a, i, bits));
+		if (!(read_u64(bloom + bit / 64 * 8) & (uint64_t(1) << (bit % 64))))
+			return false;
+	}
+
+	char const * entries(bloom + bloom_words * 8);
+	uint64_t low(0), high(entry_count);
+	while (low < high)
+	{
+		uint64_t mid(low + (high - low) / 2);
+		if (std::memcmp(entries + mid * entry_size, hash_a.data(), 32) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	/// a transaction and its receipt share the hash
+	for (; low < entry_count && !std::memcmp(entries + low * entry_size, hash_a.data(), 32); low++)
+	{
+		dev::bytesConstRef r(record(read_u64(entries + low * entry_size + 32)));
+		if (r[0] == (dev::byte)type_a)
+		{
+			value_a = r.cropped(header_size);
+			return true;
+		}
+	}
+	return false;
+}
+
+mcp::block_archive::block_archive(boost::filesystem::path const & path_a, uint64_t const & next_index_a) :
+	m_path(path_a)
+{
+	boost::filesystem::create_directories(m_path);
+	uint64_t open_number(next_index_a / segment_size);
+
+	/// segments past the open one were appended but never recorded as archived
+	for (auto const & entry : boost::filesystem::directory_iterator(m_path))
+	{
+		std::string name(entry.path().filename().string());
+		std::string number(name.substr(0, name.find('.')));
+		if (!number.empty() && std::all_of(number.begin(), number.end(), [](char c) { return c >= '0' && c <= '9'; })
+			&& std::stoull(number) > open_number)
+			boost::filesystem::remove(entry.path());
+	}
+
+	auto sealed(std::make_shared<sealed_list>());
+	for (uint64_t number = 0; number < open_number; number++)
+	{
+		/// stopped while sealing
+		if (!boost::filesystem::exists(segment_path(number, "hashes")))
+			write_hashes(number);
+		sealed->push_back(std::make_shared<sealed_segment>(m_path, number));
+	}
+	m_sealed = sealed;
+
+	boost::filesystem::remove(segment_path(open_number, "hashes"));
+	open_segment(open_number, next_index_a - open_number * segment_size);
+}
+
+boost::filesystem::path mcp::block_archive::segment_path(uint64_t const & number_a, std::string const & extension_a) const
+{
+	return m_path / (std::to_string(number_a) + "." + extension_a);
+}
+
+void mcp::block_archive::open_segment(uint64_t const & number_a, uint64_t const & count_a)
+{
+	m_data_out.close();
+	m_index_out.close();
+	m_data_in.close();
+
+	m_open_number = number_a;
+	m_open_ends.clear();
+	m_open_hashes.clear();
+	m_open_pending.clear();
+
+	std::string data_path(segment_path(number_a, "data").string());
+	std::string index_path(segment_path(number_a, "index").string());
+	/// create if missing
+	std::ofstream(data_path, std::ios::binary | std::ios::app);
+	std::ofstream(index_path, std::ios::binary | std::ios::app);
+
+	/// end offsets of the stable indexes recorded as archived, anything after them is dropped
+	{
+		std::ifstream in(index_path, std::ios::binary);
+		char end[8];
+		for (uint64_t i = 0; i < count_a; i++)
+		{
+			if (!in.read(end, sizeof(end)))
+				throw std::runtime_error("Archive index " + index_path + " is shorter than the archived stable index");
+			m_open_ends.push_back(read_u64(end));
+		}
+	}
+	m_open_flushed = m_open_ends.size();
+	m_open_size = m_open_ends.empty() ? 0 : m_open_ends.back();
+	boost::filesystem::resize_file(index_path, count_a * 8);
+	if (boost::filesystem::file_size(data_path) < m_open_size)
+		throw std::runtime_error("Archive data " + data_path + " is shorter than its index");
+	boost::filesystem::resize_file(data_path, m_open_size);
+
+	{
+		std::ifstream in(data_path, std::ios::binary);
+		char header[header_size];
+		for (uint64_t offset = 0; offset < m_open_size; offset += header_size + read_u32(header + 33))
+		{
+			in.seekg(offset);
+			if (!in.read(header, sizeof(header)))
+				throw std::runtime_error("Archive data " + data_path + " can not be read");
+			dev::h256 hash;
+			std::memcpy(hash.data(), header + 1, 32);
+			m_open_hashes.emplace(hash, offset);
+		}
+	}
+
+	m_data_out.open(data_path, std::ios::binary | std::ios::app);
+	m_index_out.open(index_path, std::ios::binary | std::ios::app);
+	if (!m_data_out || !m_index_out)
+		throw std::runtime_error("Archive segment " + std::to_string(number_a) + " can not be opened for writing");
+	/// the files of a new segment
+	sync_path(m_path, true);
+}
+
+void mcp::block_archive::write_hashes(uint64_t const & number_a)
+{
+	std::string data_path(segment_path(number_a, "data").string());
+	std::vector<std::pair<dev::h256, uint64_t>> entries;
+	{
+		uint64_t size(boost::filesystem::file_size(data_path));
+		std::ifstream in(data_path, std::ios::binary);
+		char header[header_size];
+		for (uint64_t offset = 0; offset < size; offset += header_size + read_u32(header + 33))
+		{
+			in.seekg(offset);
+			if (!in.read(header, sizeof(header)))
+				throw std::runtime_error("Archive data " + data_path + " can not be read");
+			dev::h256 hash;
+			std::memcpy(hash.data(), header + 1, 32);
+			entries.emplace_back(hash, offset);
+		}
+	}
+	std::sort(entries.begin(), entries.end(), [](std::pair<dev::h256, uint64_t> const & a, std::pair<dev::h256, uint64_t> const & b) {
+		return std::memcmp(a.first.data(), b.first.data(), 32) < 0;
+	});
+
+	uint64_t bloom_words(std::max<uint64_t>(1, (entries.size() * bloom_bits_per_entry + 63) / 64));
+	std::vector<uint64_t> bloom(bloom_words, 0);
+	for (auto const & e : entries)
+		for (size_t i = 0; i < bloom_hashes; i++)
+		{
+			uint64_t bit(bloom_bit(e.first, i, bloom_words * 64));
+			bloom[bit / 64] |= uint64_t(1) << (bit % 64);
+		}
+
+	/// renamed into place once complete
+	boost::filesystem::path path(segment_path(number_a, "hashes"));
+	boost::filesystem::path temp(segment_path(number_a, "hashes.tmp"));
+	{
+		std::ofstream out(temp.string(), std::ios::binary | std::ios::trunc);
+		write_u64(out, entries.size());
+		write_u64(out, bloom_words);
+		for (auto const & word : bloom)
+			write_u64(out, word);
+		for (auto const & e : entries)
+		{
+			out.write((char const *)e.first.data(), 32);
+			write_u64(out, e.second);
+		}
+		if (!out.flush())
+			throw std::runtime_error("Archive hashes " + temp.string() + " can not be written");
+	}
+	sync_path(temp);
+	boost::filesystem::rename(temp, path);
+	sync_path(m_path, true);
+}
+
+void mcp::block_archive::seal()
+{
+	write_hashes(m_open_number);
+	auto sealed(std::make_shared<sealed_list>(*m_sealed));
+	sealed->push_back(std::make_shared<sealed_segment>(m_path, m_open_number));
+	m_sealed = sealed;
+	open_segment(m_open_number + 1, 0);
+}
+
+uint64_t mcp::block_archive::next_index()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_open_number * segment_size + m_open_ends.size();
+}
+
+void mcp::block_archive::append(uint64_t const & index_a, std::vector<std::pair<archive_record, dev::h256>> const & keys_a, std::vector<std::string> const & values_a)
+{
+	assert_x(keys_a.size() == values_a.size() && !keys_a.empty() && keys_a.front().first == archive_record::block);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	assert_x(index_a == m_open_number * segment_size + m_open_ends.size());
+	if (m_open_ends.size() == segment_size)
+	{
+		assert_x(m_open_flushed == segment_size);
+		seal();
+	}
+
+	for (size_t i = 0; i < keys_a.size(); i++)
+	{
+		uint32_t size(boost::endian::native_to_little((uint32_t)values_a[i].size()));
+		char type((char)keys_a[i].first);
+		m_data_out.write(&type, 1);
+		m_data_out.write((char const *)keys_a[i].second.data(), 32);
+		m_data_out.write((char const *)&size, sizeof(size));
+		m_data_out.write(values_a[i].data(), values_a[i].size());
+		m_open_pending.emplace_back(keys_a[i].second, m_open_size);
+		m_open_size += header_size + values_a[i].size();
+	}
+	m_open_ends.push_back(m_open_size);
+}
+
+void mcp::block_archive::flush()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	/// data first, an index entry never points past the data
+	m_data_out.flush();
+	if (!m_data_out)
+		throw std::runtime_error("Archive segment " + std::to_string(m_open_number) + " can not be written");
+	sync_path(segment_path(m_open_number, "data"));
+	for (size_t i = m_open_flushed; i < m_open_ends.size(); i++)
+		write_u64(m_index_out, m_open_ends[i]);
+	m_index_out.flush();
+	if (!m_index_out)
+		throw std::runtime_error("Archive segment " + std::to_string(m_open_number) + " can not be written");
+	sync_path(segment_path(m_open_number, "index"));
+
+	for (auto const & p : m_open_pending)
+		m_open_hashes.emplace(p.first, p.second);
+	m_open_pending.clear();
+	m_open_flushed = m_open_ends.size();
+}
+
+void mcp::block_archive::truncate(uint64_t const & next_index_a)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	assert_x(next_index_a >= m_open_number * segment_size);
+	uint64_t count(next_index_a - m_open_number * segment_size);
+	assert_x(count <= m_open_flushed);
+	open_segment(m_open_number, count);
+}
+
+bool mcp::block_archive::read_open(uint64_t const & offset_a, archive_record const * type_a, dev::h256 const * hash_a, dev::bytes & buffer_a)
+{
+	if (!m_data_in.is_open())
+		m_data_in.open(segment_path(m_open_number, "data").string(), std::ios::binary);
+	m_data_in.clear();
+	m_data_in.seekg(offset_a);
+
+	char header[header_size];
+	if (!m_data_in.read(header, sizeof(header)))
+		return false;
+	if (type_a && header[0] != (char)*type_a)
+		return false;
+	if (hash_a && std::memcmp(header + 1, hash_a->data(), 32))
+		return false;
+
+	buffer_a.resize(read_u32(header + 33));
+	return !!m_data_in.read((char *)buffer_a.data(), buffer_a.size());
+}
+
+bool mcp::block_archive::get(archive_record const & type_a, dev::h256 const & hash_a, dev::bytesConstRef & value_a, dev::bytes & buffer_a)
+{
+	std::shared_ptr<sealed_list const> sealed;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto range(m_open_hashes.equal_range(hash_a));
+		for (auto it = range.first; it != range.second; it++)
+		{
+			if (read_open(it->second, &type_a, &hash_a, buffer_a))
+			{
+				value_a = dev::bytesConstRef(&buffer_a);
+				return true;
+			}
+		}
+		sealed = m_sealed;
+	}
+
+	/// recent segments first
+	for (auto it = sealed->rbegin(); it != sealed->rend(); it++)
+		if ((*it)->find(type_a, hash_a, value_a))
+			return true;
+	return false;
+}
+
+bool mcp::block_archive::exists(archive_record const & type_a, dev::h256 const & hash_a)
+{
+	dev::bytesConstRef value;
+	dev::bytes buffer;
+	return get(type_a, hash_a, value, buffer);
+}
+
+bool mcp::block_archive::block_get(uint64_t const & index_a, dev::bytesConstRef & value_a, dev::bytes & buffer_a)
+{
+	uint64_t number(index_a / segment_size);
+	uint64_t position(index_a % segment_size);
+	std::shared_ptr<sealed_list const> sealed;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (number == m_open_number)
+		{
+			if (position >= m_open_flushed)
+				return false;
+			uint64_t offset(position ? m_open_ends[position - 1] : 0);
+			archive_record type(archive_record::block);
+			if (!read_open(offset, &type, nullptr, buffer_a))
+				return false;
+			value_a = dev::bytesConstRef(&buffer_a);
+			return true;
+		}
+		if (number > m_open_number)
+			return false;
+		sealed = m_sealed;
+	}
+
+	auto const & segment((*sealed)[number]);
+	uint64_t offset(position ? read_u64((char const *)segment->index.get_address() + (position - 1) * 8) : 0);
+	dev::bytesConstRef r(segment->record(offset));
+	assert_x(r[0] == (dev::byte)archive_record::block);
+	value_a = r.cropped(header_size);
+	return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mcp
+{
+	enum class archive_record : uint8_t
+	{
+		block = 0,
+		transaction = 1,
+		receipt = 2
+	};
+
+	/// Append only archive of stable blocks with their transactions and receipts, in stable index order.
+	/// Stable indexes are grouped in segments of segment_size, each with a data file of records, an index file
+	/// holding the end offset of every stable index and, once the segment is full, a sorted hash table with a bloom filter.
+	/// Full segments are memory mapped and read without copying, the open one is read from its file.
+	class block_archive
+	{
+	public:
+		/// drops what was appended from next_index_a on, it was never recorded as archived
+		block_archive(boost::filesystem::path const & path_a, uint64_t const & next_index_a);
+
+		/// next stable index to append
+		uint64_t next_index();
+
+		/// records of one stable index, the block first, readable after flush
+		void append(uint64_t const & index_a, std::vector<std::pair<archive_record, dev::h256>> const & keys_a, std::vector<std::string> const & values_a);
+		/// writes and syncs what was appended, it is on disk on return
+		void flush();
+		/// drops everything from next_index_a on, only within the open segment
+		void truncate(uint64_t const & next_index_a);
+
+		/// value_a points into the mapping, or into buffer_a for the open segment
+		bool get(archive_record const & type_a, dev::h256 const & hash_a, dev::bytesConstRef & value_a, dev::bytes & buffer_a);
+		bool exists(archive_record const & type_a, dev::h256 const & hash_a);
+		/// block of a stable index
+		bool block_get(uint64_t const & index_a, dev::bytesConstRef & value_a, dev::bytes & buffer_a);
+
+		static constexpr uint64_t segment_size = 1 << 16;
+
+	private:
+		/// type, hash, value size
+		static constexpr size_t header_size = 1 + 32 + 4;
+		/// hash, offset
+		static constexpr size_t entry_size = 32 + 8;
+
+		struct sealed_segment
+		{
+			sealed_segment(boost::filesystem::path const & path_a, uint64_t const & number_a);
+			bool find(archive_record const & type_a, dev::h256 const & hash_a, dev::bytesConstRef & value_a) const;
+			dev::bytesConstRef record(uint64_t const & offset_a) const;
+
+			boost::interprocess::file_mapping data_file;
+			boost::interprocess::mapped_region data;
+			boost::interprocess::file_mapping index_file;
+			boost::interprocess::mapped_region index;
+			boost::interprocess::file_mapping hashes_file;
+			boost::interprocess::mapped_region hashes;
+			uint64_t entry_count;
+			uint64_t bloom_words;
+		};
+		using sealed_list = std::vector<std::shared_ptr<sealed_segment const>>;
+
+		boost::filesystem::path segment_path(uint64_t const & number_a, std::string const & extension_a) const;
+		void open_segment(uint64_t const & number_a, uint64_t const & count_a);
+		void seal();
+		/// sorted hash table with bloom filter of a full segment, from its data file
+		void write_hashes(uint64_t const & number_a);
+		bool read_open(uint64_t const & offset_a, archive_record const * type_a, dev::h256 const * hash_a, dev::bytes & buffer_a);
+
+		boost::filesystem::path m_path;
+		std::mutex m_mutex;
+
+		/// copied on write, readers search it without the lock
+		std::shared_ptr<sealed_list const> m_sealed;
+
+		uint64_t m_open_number = 0;
+		/// end offsets of the flushed stable indexes of the open segment, then the pending ones
+		std::vector<uint64_t> m_open_ends;
+		size_t m_open_flushed = 0;
+		std::unordered_multimap<dev::h256, uint64_t> m_open_hashes;
+		std::vector<std::pair<dev::h256, uint64_t>> m_open_pending;
+		uint64_t m_open_size = 0;
+		std::ofstream m_data_out;
+		std::ofstream m_index_out;
+		std::ifstream m_data_in;
+	};
+}
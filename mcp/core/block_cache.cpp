@@ -1,5 +1,39 @@
 #include "block_cache.hpp"
 
+#include <mcp/common/metrics.hpp>
+
+namespace
+{
+	/// hit rate of a block_cache table, reading an entry which is changing counts as neither
+	class cache_metrics
+	{
+	public:
+		cache_metrics(std::string const & table_a) :
+			m_hit(mcp::metrics::registry::instance().counter("mcp_block_cache_requests_total", "block_cache lookups", "table=\"" + table_a + "\",result=\"hit\"")),
+			m_miss(mcp::metrics::registry::instance().counter("mcp_block_cache_requests_total", "block_cache lookups", "table=\"" + table_a + "\",result=\"miss\""))
+		{
+		}
+
+		void record(bool const & hit_a)
+		{
+			(hit_a ? m_hit : m_miss).add();
+		}
+
+	private:
+		mcp::metrics::counter & m_hit;
+		mcp::metrics::counter & m_miss;
+	};
+
+	cache_metrics block_metrics("block");
+	cache_metrics block_state_metrics("block_state");
+	cache_metrics latest_account_state_metrics("latest_account_state");
+	cache_metrics transaction_metrics("transaction");
+	cache_metrics approve_metrics("approve");
+	cache_metrics account_nonce_metrics("account_nonce");
+	cache_metrics transaction_address_metrics("transaction_address");
+	cache_metrics transaction_receipt_metrics("transaction_receipt");
+}
+
 mcp::block_cache::block_cache(mcp::block_store &store_a) :
 	m_store(store_a),
 	m_blocks(500),
@@ -34,6 +68,7 @@ std::shared_ptr<mcp::block> mcp::block_cache::block_get(mcp::db::db_transaction
 	if (!m_block_changings.count(block_hash_a))
 	{
 		bool exists = m_blocks.tryGet(block_hash_a, block);
+		block_metrics.record(exists);
 		if (!exists)
 		{
 			block = m_store.block_get(transaction_a, block_hash_a);
@@ -58,9 +93,13 @@ std::shared_ptr<mcp::block> mcp::block_cache::block_get(mcp::db::db_transaction
 	if (!m_block_changings.count(bh))
 	{
 		bool exists = m_blocks.tryGet(bh, block);
+		block_metrics.record(exists);
 		if (!exists)
 		{
-			block = m_store.block_get(transaction_a, bh);
+			/// archived blocks are found by their index without a hash lookup
+			block = m_store.archived_block_get(index_a);
+			if (!block)
+				block = m_store.block_get(transaction_a, bh);
 			if (block)
 				m_blocks.insert(bh, block);
 		}
@@ -105,6 +144,7 @@ std::shared_ptr<mcp::block_state> mcp::block_cache::block_state_get(mcp::db::db_
 	if (!m_block_state_changings.count(block_hash_a))
 	{
 		bool exists = m_block_states.tryGet(block_hash_a, state);
+		block_state_metrics.record(exists);
 		if (!exists)
 		{
 			state = m_store.block_state_get(transaction_a, block_hash_a);
@@ -152,6 +192,7 @@ std::shared_ptr<mcp::account_state> mcp::block_cache::latest_account_state_get(m
 	if (!m_latest_account_state_changings.count(account_a))
 	{
 		bool exists = m_latest_account_states.tryGet(account_a, state);
+		latest_account_state_metrics.record(exists);
 		if (exists)
 			return state;
 	}
@@ -209,6 +250,7 @@ std::shared_ptr<mcp::Transaction> mcp::block_cache::transaction_get(mcp::db::db_
 	if (!m_transaction_changings.count(hash))
 	{
 		bool exists = m_transactions.tryGet(hash, t);
+		transaction_metrics.record(exists);
 		if (!exists)
 		{
 			t = m_store.transaction_get(transaction_a, hash);
@@ -261,6 +303,7 @@ std::shared_ptr<mcp::approve> mcp::block_cache::approve_get(mcp::db::db_transact
 	std::lock_guard<std::mutex> lock(m_approve_mutex);
 
 	bool exists = m_approves.tryGet(hash, t);
+	approve_metrics.record(exists);
 	if (!exists)
 	{
 		t = m_store.approve_get(transaction_a, hash);
@@ -287,6 +330,7 @@ bool mcp::block_cache::account_nonce_get(mcp::db::db_transaction & transaction_a
 {
 	std::lock_guard<std::mutex> lock(m_account_nonce_mutex);
 	bool exists = m_account_nonces.tryGet(account_a, nonce_a);
+	account_nonce_metrics.record(exists);
 	if (!exists)
 	{
 		exists = m_store.account_nonce_get(transaction_a, account_a, nonce_a);
@@ -328,6 +372,7 @@ std::shared_ptr<mcp::TransactionAddress> mcp::block_cache::transaction_address_g
 	std::shared_ptr<mcp::TransactionAddress> td = nullptr;
 	std::lock_guard<std::mutex> lock(m_transaction_address_mutex);
 	bool exists = m_transaction_address.tryGet(hash, td);
+	transaction_address_metrics.record(exists);
 	if (!exists)
 	{
 		td = m_store.transaction_address_get(transaction_a, hash);
@@ -481,6 +526,7 @@ std::shared_ptr<dev::eth::TransactionReceipt> mcp::block_cache::transaction_rece
 	if (!m_transaction_receipt_changings.count(hash))
 	{
 		bool exists = m_transaction_receipts.tryGet(hash, t);
+		transaction_receipt_metrics.record(exists);
 		if (!exists)
 		{
 			t = m_store.transaction_receipt_get(transaction_a, hash);
@@ -599,4 +645,29 @@ std::string mcp::block_cache::report_cache_size()
 		<< " , m_transaction_receipts:" << m_transaction_receipts.size();
 
 	return s.str();
-}
\ No newline at end of file
+}
+
+void mcp::block_cache::save_hot_blocks(mcp::db::db_transaction & transaction_a)
+{
+	std::vector<mcp::block_hash> hashs;
+	{
+		std::lock_guard<std::mutex> lock(m_block_mutex);
+		auto collect = [&hashs](mcp::KeyValuePair<mcp::block_hash, std::shared_ptr<mcp::block>> const & item_a) { hashs.push_back(item_a.key); };
+		m_blocks.cwalk(collect);
+	}
+	m_store.hot_blocks_put(transaction_a, hashs);
+}
+
+void mcp::block_cache::load_hot_blocks(mcp::db::db_transaction & transaction_a)
+{
+	std::vector<mcp::block_hash> hashs;
+	m_store.hot_blocks_get(transaction_a, hashs);
+	if (hashs.size() > m_blocks.getMaxSize())
+		hashs.resize(m_blocks.getMaxSize());
+	/// saved most recently used first, load it last
+	for (auto it = hashs.rbegin(); it != hashs.rend(); it++)
+	{
+		if (block_get(transaction_a, *it))
+			block_state_get(transaction_a, *it);
+	}
+}
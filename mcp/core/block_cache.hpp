@@ -111,6 +111,10 @@ class block_cache : public mcp::iblock_cache
 
 	std::string report_cache_size();
 
+	/// blocks of the cache are saved at shutdown and read back on start, so a restart does not begin cold
+	void save_hot_blocks(mcp::db::db_transaction & transaction_a);
+	void load_hot_blocks(mcp::db::db_transaction & transaction_a);
+
 private:
 	mcp::block_store & m_store;
 
@@ -5,7 +5,7 @@
 #include <mcp/common/log.hpp>
 
 mcp::block_store::block_store(bool & error_a, boost::filesystem::path const & path_a) :
-	m_db(std::make_shared<mcp::db::database>(path_a)),
+	m_db(std::make_shared<mcp::db::database>(path_a, "chain")),
 	dag_account_info(0),
 	account_info(0),
 	account_state(0),
@@ -44,16 +44,19 @@ mcp::block_store::block_store(bool & error_a, boost::filesystem::path const & pa
 	epoch_param(0),
 	epoch_work_transaction(0),
 	stakingList(0),
-	receiptsRoot(0)
+	receiptsRoot(0),
+	work_statistics(0),
+	epoch_vrf_outputs(0),
+	stable_block_bundle(0)
 {
 	if (error_a)
 		return;
 
-	auto tbops_prefix = mcp::db::db_column::default_table_options(mcp::db::database::get_table_cache());
+	auto tbops_prefix = mcp::db::db_column::default_table_options(mcp::db::database::get_table_cache(), rocksdb::kDefaultColumnFamilyName);
 	if (rocksdb::BlockBasedTableOptions::IndexType::kBinarySearch == tbops_prefix->index_type)
 		tbops_prefix->index_type = rocksdb::BlockBasedTableOptions::IndexType::kHashSearch;
 	
-	auto cfops_prefix = mcp::db::db_column::default_column_family_options(tbops_prefix);
+	auto cfops_prefix = mcp::db::db_column::default_column_family_options(tbops_prefix, rocksdb::kDefaultColumnFamilyName);
 	cfops_prefix->prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(3));
 	cfops_prefix->memtable_prefix_bloom_size_ratio = 0.02;
 	//cfops_prefix->max_write_buffer_number = 6;
@@ -96,6 +99,9 @@ mcp::block_store::block_store(bool & error_a, boost::filesystem::path const & pa
 	epoch_work_transaction = m_db->set_column_family(default_col, "034");
 	stakingList = m_db->set_column_family(default_col, "035");
 	receiptsRoot = m_db->set_column_family(default_col, "036");
+	work_statistics = m_db->set_column_family(default_col, "037");
+	epoch_vrf_outputs = m_db->set_column_family(default_col, "038");
+	stable_block_bundle = m_db->set_column_family(default_col, "039");
 
 	//use iterator
 	dag_free = m_db->set_column_family(default_col, "101");
@@ -103,6 +109,26 @@ mcp::block_store::block_store(bool & error_a, boost::filesystem::path const & pa
 	unlink_info = m_db->set_column_family(default_col, "103");
 	head_unlink = m_db->set_column_family(default_col, "104");
 
+	/// logical table names in storage telemetry
+	std::vector<std::pair<int, std::string>> const table_names = {
+		{ dag_account_info, "dag_account_info" }, { account_info, "account_info" }, { account_state, "account_state" },
+		{ latest_account_state, "latest_account_state" }, { blocks, "blocks" }, { transactions, "transactions" },
+		{ transaction_address, "transaction_address" }, { account_nonce, "account_nonce" }, { block_state, "block_state" },
+		{ successor, "successor" }, { main_chain, "main_chain" }, { skiplist, "skiplist" }, { block_summary, "block_summary" },
+		{ summary_block, "summary_block" }, { stable_block, "stable_block" }, { stable_block_number, "stable_block_number" },
+		{ contract_main, "contract_main" }, { prop, "prop" }, { catchup_chain_summaries, "catchup_chain_summaries" },
+		{ catchup_chain_block_summary, "catchup_chain_block_summary" }, { catchup_chain_summary_block, "catchup_chain_summary_block" },
+		{ hash_tree_summary, "hash_tree_summary" }, { unlink_block, "unlink_block" }, { traces, "traces" },
+		{ next_unlink, "next_unlink" }, { next_unlink_index, "next_unlink_index" }, { contract_aux, "contract_aux" },
+		{ transaction_receipt, "transaction_receipt" }, { approves, "approves" }, { approve_receipt, "approve_receipt" },
+		{ epoch_approves, "epoch_approves" }, { epoch_param, "epoch_param" }, { epoch_work_transaction, "epoch_work_transaction" },
+		{ stakingList, "staking_list" }, { receiptsRoot, "receipts_root" }, { work_statistics, "work_statistics" },
+		{ epoch_vrf_outputs, "epoch_vrf_outputs" }, { stable_block_bundle, "stable_block_bundle" },
+		{ dag_free, "dag_free" }, { block_child, "block_child" }, { unlink_info, "unlink_info" }, { head_unlink, "head_unlink" }
+	};
+	for (auto const & t : table_names)
+		m_db->set_table_name(t.first, t.second);
+
 
 	////column have used iterator 
 	//auto tbops_iter = mcp::db::db_column::default_table_options(mcp::db::database::get_table_cache());
@@ -134,6 +160,30 @@ mcp::block_store::block_store(bool & error_a, boost::filesystem::path const & pa
 		std::cerr << "Block store db upgrade error" << std::endl;
 		return;
 	}
+
+	try
+	{
+		mcp::db::db_transaction transaction(create_transaction());
+		uint64_t archived_index(archived_index_get(transaction));
+		if (mcp::db::database_config::archive || archived_index > 0)
+			m_archive = std::make_shared<mcp::block_archive>(path_a.parent_path() / "archive", archived_index);
+	}
+	catch (std::exception const & e)
+	{
+		std::cerr << "Block archive open error: " << e.what() << std::endl;
+		error_a = true;
+		return;
+	}
+
+	try
+	{
+		m_db->init_loader(path_a.parent_path() / "ingest", bulk_load_min_bytes);
+	}
+	catch (std::exception const & e)
+	{
+		std::cerr << "Block store bulk loader open error: " << e.what() << std::endl;
+		error_a = true;
+	}
 }
 
 bool mcp::block_store::upgrade()
@@ -156,6 +206,16 @@ std::string mcp::block_store::get_rocksdb_state(uint64_t limit)
 	return str;
 }
 
+mcp::json mcp::block_store::get_rocksdb_telemetry()
+{
+	return m_db->get_telemetry();
+}
+
+std::string mcp::block_store::get_rocksdb_telemetry_summary()
+{
+	return m_db->get_telemetry_summary();
+}
+
 void mcp::block_store::version_put(mcp::db::db_transaction & transaction_a, int version_a)
 {
 	dev::h256 version_value(version_a);
@@ -196,6 +256,13 @@ std::shared_ptr<mcp::block> mcp::block_store::block_get(mcp::db::db_transaction
 		result = std::make_shared<mcp::block>(r);
 		assert_x_msg(result != nullptr, "hash:" + hash_a.hex() + " ,data:" + value);
 	}
+	else if (m_archive)
+	{
+		dev::bytesConstRef archived;
+		dev::bytes buffer;
+		if (m_archive->get(mcp::archive_record::block, hash_a, archived, buffer))
+			result = std::make_shared<mcp::block>(dev::RLP(archived));
+	}
 	return result;
 }
 
@@ -203,6 +270,8 @@ bool mcp::block_store::block_exists(mcp::db::db_transaction & transaction_a, mcp
 {
 	std::string result;
 	bool exists(transaction_a.get(blocks, mcp::h256_to_slice(hash_a), result));
+	if (!exists && m_archive)
+		exists = m_archive->exists(mcp::archive_record::block, hash_a);
 	return exists;
 }
 
@@ -238,6 +307,8 @@ bool mcp::block_store::transaction_exists(mcp::db::db_transaction & transaction_
 {
 	std::string result;
 	bool exists(transaction_a.get(transactions, mcp::h256_to_slice(hash_a), result));
+	if (!exists && m_archive)
+		exists = m_archive->exists(mcp::archive_record::transaction, hash_a);
 	return exists;
 }
 
@@ -246,9 +317,15 @@ std::shared_ptr<mcp::Transaction> mcp::block_store::transaction_get(mcp::db::db_
 	std::string value;
 	bool exists(transaction_a.get(transactions, mcp::h256_to_slice(hash_a), value));
 	std::shared_ptr<mcp::Transaction> result = nullptr;
+	dev::bytesConstRef archived;
+	dev::bytes buffer;
+	if (exists)
+		archived = dev::bytesConstRef((dev::byte const *)value.data(), value.size());
+	else if (m_archive)
+		exists = m_archive->get(mcp::archive_record::transaction, hash_a, archived, buffer);
 	if (exists)
 	{
-		dev::RLP r(value);
+		dev::RLP r(archived);
 		result = std::make_shared<mcp::Transaction>(r,CheckTransaction::None);
 
 		/// genesis set sender.
@@ -596,6 +673,54 @@ void mcp::block_store::stable_block_put(mcp::db::db_transaction & transaction_a,
 	transaction_a.put(stable_block_number, mcp::h256_to_slice(hash_a), mcp::h64_to_slice(index));
 }
 
+void mcp::block_store::stable_block_bundle_put(mcp::db::db_transaction & transaction_a, uint64_t const & index_a, mcp::stable_block_bundle const & bundle_a)
+{
+	dev::bytes b_value;
+	{
+		dev::RLPStream s;
+		bundle_a.stream_RLP(s);
+		s.swapOut(b_value);
+	}
+	dev::h64 index(index_a);
+	dev::Slice s_value((char *)b_value.data(), b_value.size());
+	/// a bundle is derived from stable blocks, rewritten the same if its commit is lost after it was ingested
+	if (m_db->loader()->enabled())
+		transaction_a.put_bulk(stable_block_bundle, mcp::h64_to_slice(index), s_value);
+	else
+		transaction_a.put(stable_block_bundle, mcp::h64_to_slice(index), s_value);
+}
+
+void mcp::block_store::bulk_load(bool const & enable_a)
+{
+	m_db->loader()->enable(enable_a);
+}
+
+mcp::db::forward_iterator mcp::block_store::stable_block_bundle_begin(mcp::db::db_transaction & transaction_a, uint64_t const & index_a, std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a)
+{
+	dev::h64 index(index_a);
+	return transaction_a.begin(stable_block_bundle, mcp::h64_to_slice(index), snapshot_a);
+}
+
+std::shared_ptr<mcp::stable_block_bundle> mcp::block_store::stable_block_bundle_get(mcp::db::forward_iterator & it_a, uint64_t const & index_a)
+{
+	std::shared_ptr<mcp::stable_block_bundle> result;
+	while (it_a.valid())
+	{
+		uint64_t index(((dev::h64::Arith)mcp::slice_to_h64(it_a.key())).convert_to<uint64_t>());
+		if (index > index_a)
+			break;
+		if (index == index_a)
+		{
+			dev::Slice value(it_a.value());
+			result = std::make_shared<mcp::stable_block_bundle>(dev::RLP(dev::bytesConstRef((dev::byte const *)value.data(), value.size())));
+		}
+		++it_a;
+		if (result)
+			break;
+	}
+	return result;
+}
+
 size_t mcp::block_store::transaction_unstable_count(mcp::db::db_transaction & transaction_a)
 {
 	return transaction_a.count_get("transaction_unstable");
@@ -1056,6 +1181,13 @@ std::shared_ptr<dev::eth::TransactionReceipt> mcp::block_store::transaction_rece
 		dev::RLP r(value);
 		result = std::make_shared<dev::eth::TransactionReceipt>(r);
 	}
+	else if (m_archive)
+	{
+		dev::bytesConstRef archived;
+		dev::bytes buffer;
+		if (m_archive->get(mcp::archive_record::receipt, hash_a, archived, buffer))
+			result = std::make_shared<dev::eth::TransactionReceipt>(dev::RLP(archived));
+	}
 	return result;
 }
 
@@ -1203,6 +1335,213 @@ void mcp::block_store::PutBlockReceiptsRoot(mcp::db::db_transaction& transaction
 	transaction_a.put(receiptsRoot, mcp::h256_to_slice(block_hash_a), mcp::h256_to_slice(root_a));
 }
 
+bool mcp::block_store::warm_state_exists(mcp::db::db_transaction & transaction_a)
+{
+	std::string value;
+	return transaction_a.get(prop, mcp::h256_to_slice(warm_state_key), value);
+}
+
+void mcp::block_store::warm_state_put(mcp::db::db_transaction & transaction_a)
+{
+	transaction_a.put(prop, mcp::h256_to_slice(warm_state_key), dev::Slice());
+}
+
+void mcp::block_store::work_statistics_get(mcp::db::db_transaction & transaction_a, std::map<dev::Address, std::pair<int, int>> & statistics_a)
+{
+	mcp::db::forward_iterator it(transaction_a.begin(work_statistics));
+	for (; it.valid(); ++it)
+	{
+		std::string value(it.value().toString());
+		dev::RLP r(value);
+		assert_x(r.itemCount() == 2);
+		statistics_a[mcp::slice_to_account(it.key())] = std::make_pair(r[0].toInt<int>(), r[1].toInt<int>());
+	}
+}
+
+void mcp::block_store::work_statistics_put(mcp::db::db_transaction & transaction_a, dev::Address const & account_a, int const & on_mci_a, int const & not_on_mci_a)
+{
+	dev::bytes b_value;
+	{
+		dev::RLPStream s;
+		s.appendList(2);
+		s << on_mci_a << not_on_mci_a;
+		s.swapOut(b_value);
+	}
+	dev::Slice s_value((char *)b_value.data(), b_value.size());
+	transaction_a.put(work_statistics, mcp::account_to_slice(account_a), s_value);
+}
+
+void mcp::block_store::work_statistics_del(mcp::db::db_transaction & transaction_a, dev::Address const & account_a)
+{
+	transaction_a.del(work_statistics, mcp::account_to_slice(account_a));
+}
+
+void mcp::block_store::epoch_vrf_outputs_get(mcp::db::db_transaction & transaction_a, std::map<Epoch, std::map<h256, dev::ApproveReceipt>> & outputs_a)
+{
+	mcp::db::forward_iterator it(transaction_a.begin(epoch_vrf_outputs));
+	for (; it.valid(); ++it)
+	{
+		mcp::epoch_approves_key key(it.key());
+		std::string value(it.value().toString());
+		dev::RLP r(value);
+		outputs_a[key.epoch].insert(std::make_pair(key.hash, dev::ApproveReceipt(r)));
+	}
+}
+
+void mcp::block_store::epoch_vrf_output_put(mcp::db::db_transaction & transaction_a, Epoch const & epoch_a, h256 const & output_a, dev::ApproveReceipt const & receipt_a)
+{
+	dev::bytes b_value;
+	{
+		dev::RLPStream s;
+		receipt_a.streamRLP(s);
+		s.swapOut(b_value);
+	}
+	dev::Slice s_value((char *)b_value.data(), b_value.size());
+	transaction_a.put(epoch_vrf_outputs, mcp::epoch_approves_key(epoch_a, output_a).val(), s_value);
+}
+
+void mcp::block_store::epoch_vrf_outputs_del(mcp::db::db_transaction & transaction_a, Epoch const & epoch_a)
+{
+	std::list<h256> outputs;
+	mcp::epoch_approves_key key(epoch_a, h256());
+	mcp::db::forward_iterator it(transaction_a.begin(epoch_vrf_outputs, key.val()));
+	for (; it.valid(); ++it)
+	{
+		mcp::epoch_approves_key output_key(it.key());
+		if (output_key.epoch != epoch_a)
+			break;
+		outputs.push_back(output_key.hash);
+	}
+	for (auto const & output : outputs)
+		transaction_a.del(epoch_vrf_outputs, mcp::epoch_approves_key(epoch_a, output).val());
+}
+
+void mcp::block_store::hot_blocks_get(mcp::db::db_transaction & transaction_a, std::vector<mcp::block_hash> & hashs_a)
+{
+	std::string value;
+	bool exists(transaction_a.get(prop, mcp::h256_to_slice(hot_blocks_key), value));
+	if (exists)
+	{
+		dev::RLP r(value);
+		for (dev::RLP _r : r)
+			hashs_a.push_back((mcp::block_hash)_r);
+	}
+}
+
+void mcp::block_store::hot_blocks_put(mcp::db::db_transaction & transaction_a, std::vector<mcp::block_hash> const & hashs_a)
+{
+	dev::bytes b_value;
+	{
+		dev::RLPStream s;
+		s.appendVector(hashs_a);
+		s.swapOut(b_value);
+	}
+	dev::Slice s_value((char *)b_value.data(), b_value.size());
+	transaction_a.put(prop, mcp::h256_to_slice(hot_blocks_key), s_value);
+}
+
+uint64_t mcp::block_store::archived_index_get(mcp::db::db_transaction & transaction_a)
+{
+	std::string value;
+	bool exists(transaction_a.get(prop, mcp::h256_to_slice(archived_index_key), value));
+	uint64_t result(0);
+	if (exists)
+		result = ((dev::h64::Arith)mcp::slice_to_h64(value)).convert_to<uint64_t>();
+	return result;
+}
+
+void mcp::block_store::archived_index_put(mcp::db::db_transaction & transaction_a, uint64_t const & archived_index_a)
+{
+	dev::h64 archived_index(archived_index_a);
+	transaction_a.put(prop, mcp::h256_to_slice(archived_index_key), mcp::h64_to_slice(archived_index));
+}
+
+size_t mcp::block_store::archive_stable(uint64_t const & end_a, size_t const & max_a)
+{
+	if (!m_archive)
+		return 0;
+
+	mcp::db::db_transaction transaction(create_transaction());
+	uint64_t begin(archived_index_get(transaction));
+	/// a batch does not cross a segment, only the open segment can be truncated
+	uint64_t end(std::min(end_a, begin + max_a));
+	end = std::min(end, (begin / mcp::block_archive::segment_size + 1) * mcp::block_archive::segment_size);
+	if (end <= begin)
+		return 0;
+
+	try
+	{
+		for (uint64_t index = begin; index < end; index++)
+		{
+			mcp::block_hash hash;
+			bool error(stable_block_get(transaction, index, hash));
+			assert_x_msg(!error, "stable block of index " + std::to_string(index) + " not found");
+
+			std::vector<std::pair<mcp::archive_record, dev::h256>> keys;
+			std::vector<std::string> values;
+			std::string block_value;
+			bool exists(transaction.get(blocks, mcp::h256_to_slice(hash), block_value));
+			assert_x_msg(exists, "stable block " + hash.hex() + " not found");
+			keys.emplace_back(mcp::archive_record::block, hash);
+			values.push_back(block_value);
+
+			/// a transaction linked by several blocks goes with the block it was executed in
+			dev::RLP r(block_value);
+			mcp::block b(r);
+			for (auto const & link : b.links())
+			{
+				auto address(transaction_address_get(transaction, link));
+				if (!address || address->blockHash != hash)
+					continue;
+				std::string value;
+				if (transaction.get(transactions, mcp::h256_to_slice(link), value))
+				{
+					keys.emplace_back(mcp::archive_record::transaction, link);
+					values.push_back(value);
+					transaction.del(transactions, mcp::h256_to_slice(link));
+				}
+				if (transaction.get(transaction_receipt, mcp::h256_to_slice(link), value))
+				{
+					keys.emplace_back(mcp::archive_record::receipt, link);
+					values.push_back(value);
+					transaction.del(transaction_receipt, mcp::h256_to_slice(link));
+				}
+			}
+			transaction.del(blocks, mcp::h256_to_slice(hash));
+			/// range readers go back to point reads for archived indexes
+			dev::h64 bundle_index(index);
+			transaction.del(stable_block_bundle, mcp::h64_to_slice(bundle_index));
+
+			m_archive->append(index, keys, values);
+		}
+
+		/// readable from the archive and on disk before they are gone from the database
+		m_archive->flush();
+		archived_index_put(transaction, end);
+		transaction.commit();
+	}
+	catch (...)
+	{
+		transaction.rollback();
+		m_archive->truncate(begin);
+		throw;
+	}
+	return end - begin;
+}
+
+std::shared_ptr<mcp::block> mcp::block_store::archived_block_get(uint64_t const & index_a)
+{
+	std::shared_ptr<mcp::block> result;
+	if (m_archive)
+	{
+		dev::bytesConstRef archived;
+		dev::bytes buffer;
+		if (m_archive->block_get(index_a, archived, buffer))
+			result = std::make_shared<mcp::block>(dev::RLP(archived));
+	}
+	return result;
+}
+
 dev::h256 const mcp::block_store::version_key(0);
 dev::h256 const mcp::block_store::genesis_hash_key(1);
 dev::h256 const mcp::block_store::genesis_transaction_hash_key(2);
@@ -1212,3 +1551,6 @@ dev::h256 const mcp::block_store::advance_info_key(5);
 dev::h256 const mcp::block_store::last_stable_index_key(6);
 dev::h256 const mcp::block_store::catchup_index(7);
 dev::h256 const mcp::block_store::catchup_max_index(8);
+dev::h256 const mcp::block_store::warm_state_key(9);
+dev::h256 const mcp::block_store::hot_blocks_key(10);
+dev::h256 const mcp::block_store::archived_index_key(11);
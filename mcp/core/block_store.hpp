@@ -1,8 +1,10 @@
 #pragma once
 
 #include "blocks.hpp"
+#include <mcp/core/block_archive.hpp>
 #include <mcp/core/common.hpp>
 #include <mcp/db/database.hpp>
+#include <mcp/db/sst_loader.hpp>
 #include <mcp/core/transaction_receipt.hpp>
 #include <mcp/core/approve_receipt.hpp>
 
@@ -19,6 +21,8 @@ namespace mcp
 		bool upgrade();
 
 		std::string get_rocksdb_state(uint64_t limit);
+		mcp::json get_rocksdb_telemetry();
+		std::string get_rocksdb_telemetry_summary();
 
 		bool block_exists(mcp::db::db_transaction &, mcp::block_hash const &);
 		std::shared_ptr<mcp::block> block_get(mcp::db::db_transaction &, mcp::block_hash const &);
@@ -84,6 +88,14 @@ namespace mcp
 		size_t stable_block_count(mcp::db::db_transaction & transaction_a);
 		bool stable_block_get(mcp::db::db_transaction & transaction_a, uint64_t const & index, mcp::block_hash & hash_a, std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a = nullptr);
 		void stable_block_put(mcp::db::db_transaction & transaction_a, uint64_t const & index_a, mcp::block_hash const & hash_a);
+		/// bundles are ordered by stable index, a range is read with one iterator
+		void stable_block_bundle_put(mcp::db::db_transaction & transaction_a, uint64_t const & index_a, mcp::stable_block_bundle const & bundle_a);
+		mcp::db::forward_iterator stable_block_bundle_begin(mcp::db::db_transaction & transaction_a, uint64_t const & index_a, std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a = nullptr);
+		/// bundle of index_a if the iterator is at it, then moves the iterator on; nullptr if there is none, stable indexes before bundles were written have none
+		std::shared_ptr<mcp::stable_block_bundle> stable_block_bundle_get(mcp::db::forward_iterator & it_a, uint64_t const & index_a);
+		/// while catching up, bundles are ingested from sst files when their transaction commits,
+		/// instead of written through the WAL and memtables
+		void bulk_load(bool const & enable_a);
 		bool stable_block_get(mcp::db::db_transaction & transaction_a, mcp::block_hash const& hash_a, uint64_t & index_a, std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a = nullptr);
 
 		size_t transaction_unstable_count(mcp::db::db_transaction & transaction_a);
@@ -181,6 +193,29 @@ namespace mcp
 		bool GetBlockReceiptsRoot(mcp::db::db_transaction&, mcp::block_hash const&, dev::h256&);
 		void PutBlockReceiptsRoot(mcp::db::db_transaction&, mcp::block_hash const&, dev::h256 const&);
 
+		/// consensus warm state, kept in step with the chain so that a restart does not rebuild it
+		bool warm_state_exists(mcp::db::db_transaction & transaction_a);
+		void warm_state_put(mcp::db::db_transaction & transaction_a);
+
+		void work_statistics_get(mcp::db::db_transaction & transaction_a, std::map<dev::Address, std::pair<int, int>> & statistics_a);
+		void work_statistics_put(mcp::db::db_transaction & transaction_a, dev::Address const & account_a, int const & on_mci_a, int const & not_on_mci_a);
+		void work_statistics_del(mcp::db::db_transaction & transaction_a, dev::Address const & account_a);
+
+		void epoch_vrf_outputs_get(mcp::db::db_transaction & transaction_a, std::map<Epoch, std::map<h256, dev::ApproveReceipt>> & outputs_a);
+		void epoch_vrf_output_put(mcp::db::db_transaction & transaction_a, Epoch const & epoch_a, h256 const & output_a, dev::ApproveReceipt const & receipt_a);
+		void epoch_vrf_outputs_del(mcp::db::db_transaction & transaction_a, Epoch const & epoch_a);
+
+		void hot_blocks_get(mcp::db::db_transaction & transaction_a, std::vector<mcp::block_hash> & hashs_a);
+		void hot_blocks_put(mcp::db::db_transaction & transaction_a, std::vector<mcp::block_hash> const & hashs_a);
+
+		/// stable blocks below the archived index are moved with their transactions and receipts to the archive
+		uint64_t archived_index_get(mcp::db::db_transaction & transaction_a);
+		void archived_index_put(mcp::db::db_transaction & transaction_a, uint64_t const & archived_index_a);
+		/// archives stable indexes up to end_a, at most max_a of them, return the number archived
+		size_t archive_stable(uint64_t const & end_a, size_t const & max_a);
+		/// block of an archived stable index, nullptr if not archived
+		std::shared_ptr<mcp::block> archived_block_get(uint64_t const & index_a);
+
 		mcp::db::db_transaction create_transaction(std::shared_ptr<rocksdb::WriteOptions> write_options_a = nullptr,
 			std::shared_ptr<rocksdb::TransactionOptions> txn_ops_a = nullptr)
 		{
@@ -191,6 +226,8 @@ namespace mcp
 		//void release_snapshot(std::shared_ptr<rocksdb::ManagedSnapshot> _snapshot) { m_db->release_snapshot(_snapshot); }
 
 		std::shared_ptr<mcp::db::database> m_db;
+		/// nullptr if archiving was never enabled
+		std::shared_ptr<mcp::block_archive> m_archive;
 		// account -> dag account info                                 
 		int dag_account_info;
 		// account -> account info                                        
@@ -273,6 +310,13 @@ namespace mcp
 		// block hash -> receiptsRoot hash
 		int receiptsRoot;
 
+		// account -> witness block statistics of the current epoch
+		int work_statistics;
+		// epoch, vrf output -> approve receipt
+		int epoch_vrf_outputs;
+		// stable index -> stable block bundle
+		int stable_block_bundle;
+
 		//genesis hash key
 		static dev::h256 const genesis_hash_key;
 		//genesis transaction hash key
@@ -289,5 +333,14 @@ namespace mcp
 		static dev::h256 const catchup_index;
 		//catch up max index key
 		static dev::h256 const catchup_max_index;
+		//warm state key
+		static dev::h256 const warm_state_key;
+		//hot blocks of block cache key
+		static dev::h256 const hot_blocks_key;
+		//archived stable index key
+		static dev::h256 const archived_index_key;
+
+		//bytes of bundles a commit must have to be ingested rather than put when bulk loading
+		static size_t const bulk_load_min_bytes = 4 * 1024 * 1024;
 	};
 }
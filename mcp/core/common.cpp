@@ -437,7 +437,7 @@ void mcp::account_state::setCode(dev::bytes&& _code)
 	auto const newHash = sha3(_code);
 	if (newHash != m_codeHash)
 	{
-		m_codeCache = std::move(_code);
+		m_codeCache = std::make_shared<bytes const>(std::move(_code));
 		m_hasNewCode = true;
 		m_codeHash = newHash;
 	}
@@ -445,7 +445,7 @@ void mcp::account_state::setCode(dev::bytes&& _code)
 
 void mcp::account_state::resetCode()
 {
-	m_codeCache.clear();
+	m_codeCache.reset();
 	m_hasNewCode = false;
 	m_codeHash = EmptySHA3;
 }
@@ -488,6 +488,45 @@ void mcp::skiplist_info::stream_RLP(dev::RLPStream & s) const
         s << sk;
 }
 
+mcp::stable_block_bundle::stable_block_bundle(dev::RLP const & r)
+{
+	assert_x(r.isList() && r.itemCount() == 9);
+	block = std::make_shared<mcp::block>(r[0]);
+	bool error(false);
+	state = mcp::block_state(error, r[1]);
+	assert_x(!error);
+	summary = (mcp::summary_hash)r[2];
+	previous_summary = (mcp::summary_hash)r[3];
+	for (auto const & p : r[4])
+		parent_summaries.push_back((mcp::summary_hash)p);
+	receipts_root = (h256)r[5];
+	for (auto const & sk : r[6])
+		skiplist.insert((mcp::block_hash)sk);
+	for (auto const & sk : r[7])
+		skiplist_summaries.insert((mcp::summary_hash)sk);
+	for (auto const & i : r[8])
+		executed_links.push_back(i.toInt<uint32_t>());
+}
+
+void mcp::stable_block_bundle::stream_RLP(dev::RLPStream & s) const
+{
+	s.appendList(9);
+	block->streamRLP(s);
+	state.stream_RLP(s);
+	s << summary << previous_summary;
+	s.appendList(parent_summaries.size());
+	for (auto const & p : parent_summaries)
+		s << p;
+	s << receipts_root;
+	s.appendList(skiplist.size());
+	for (auto const & sk : skiplist)
+		s << sk;
+	s.appendList(skiplist_summaries.size());
+	for (auto const & sk : skiplist_summaries)
+		s << sk;
+	s.appendVector(executed_links);
+}
+
 mcp::summary_hash mcp::summary::gen_summary_hash(mcp::block_hash const & block_hash, mcp::summary_hash const & previous_hash,
 	std::list<mcp::summary_hash> const & parent_hashs, h256 const & receipts_root, std::set<mcp::summary_hash> const & skiplist,
 	mcp::block_status const & status_a, uint64_t const& stable_index_a, uint64_t const& mc_timestamp_a)
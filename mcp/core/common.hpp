@@ -78,6 +78,7 @@ namespace mcp
 		unsigned depositSize = 0; 							///< Amount of code of the creation's attempted deposit.
 		u256 gasForDeposit;			 						///< Amount of gas remaining for the code deposit phase.
 		std::set<Address> modified_accounts;			///< The accounts that have been modified by the transaction.
+		u256 gasCallSlack = 0;							///< Gas beyond the used gas the calls need to keep their callees funded under the 63/64 rule.
 
 		bool Failed() const { return excepted != TransactionException::None; } /// Failed returns the indicator whether the execution is successful or not.
 
@@ -298,10 +299,13 @@ namespace mcp
 
 		/// Specify to the object what the actual code is for the account. @a _code must have a SHA3
 		/// equal to codeHash().
-		void noteCode(bytesConstRef _code) { assert(sha3(_code) == m_codeHash); m_codeCache = _code.toBytes(); }
+		void noteCode(bytesConstRef _code) { assert(sha3(_code) == m_codeHash); m_codeCache = std::make_shared<bytes const>(_code.toBytes()); }
+
+		/// Same as above, sharing code that is already loaded instead of copying it.
+		void noteCode(std::shared_ptr<bytes const> const& _code) { assert(sha3(*_code) == m_codeHash); m_codeCache = _code; }
 
 		/// @returns the account's code.
-		bytes const& code() const { return m_codeCache; }
+		bytes const& code() const { return m_codeCache ? *m_codeCache : NullBytes; }
 
 		//clear temp state to make it just like the state get from db
 		void clear_temp_state()
@@ -310,7 +314,7 @@ namespace mcp
 			m_hasNewCode = false;
 			m_storageOverlay.clear();
 			m_storageOriginal.clear();
-			m_codeCache.clear();
+			m_codeCache.reset();
 		}
 
 	private:
@@ -361,7 +365,8 @@ namespace mcp
 
     	/// The associated code for this account. The SHA3 of this should be equal to m_codeHash unless
     	/// m_codeHash equals c_contractConceptionCodeHash.
-    	dev::bytes m_codeCache;
+    	/// immutable and shared between copies of the account state
+    	std::shared_ptr<dev::bytes const> m_codeCache;
 
     	/// Value for m_codeHash when this account is having its code determined.
     	static const u256 c_contractConceptionCodeHash;
@@ -406,6 +411,26 @@ namespace mcp
 		std::set<mcp::block_hash> list;
 	};
 
+	/// what readers of stable index ranges need about a stable block, written once when it becomes stable
+	class stable_block_bundle
+	{
+	public:
+		stable_block_bundle() = default;
+		stable_block_bundle(dev::RLP const & r);
+		void stream_RLP(dev::RLPStream & s) const;
+
+		std::shared_ptr<mcp::block> block;
+		mcp::block_state state;
+		mcp::summary_hash summary;
+		mcp::summary_hash previous_summary;
+		std::list<mcp::summary_hash> parent_summaries;
+		h256 receipts_root;
+		std::set<mcp::block_hash> skiplist;
+		std::set<mcp::summary_hash> skiplist_summaries;
+		/// positions in links of the transactions executed in this block, their receipts have the same hashes
+		std::vector<uint32_t> executed_links;
+	};
+
 	class summary
 	{
 	public:
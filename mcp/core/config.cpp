@@ -5,6 +5,8 @@ mcp::mcp_networks mcp::mcp_network = mcp::mcp_networks::mcp_live_network;
 dev::u256 mcp::gas_price;
 uint64_t mcp::chain_id;
 mcp::ChainOperationParams* mcp::ChainConfig = new mcp::ChainOperationParams();
+std::string mcp::custom_genesis_data;
+std::vector<std::string> mcp::custom_genesis_witnesses;
 
 mcp::uint256_t mcp::chainID()
 {
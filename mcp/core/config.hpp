@@ -4,7 +4,9 @@
 #include <cstddef>
 #include <set>
 #include <map>
+#include <string>
 #include <utility>
+#include <vector>
 #include <mcp/common/numbers.hpp>
 #include <libdevcore/Address.h>
 #include <libdevcore/Guards.h>
@@ -29,6 +31,9 @@ extern mcp::mcp_networks mcp_network;
 extern dev::u256 gas_price;
 extern uint64_t chain_id;
 extern ChainOperationParams* ChainConfig;
+/// genesis json and witness list of a local mini test network, empty for the built in one
+extern std::string custom_genesis_data;
+extern std::vector<std::string> custom_genesis_witnesses;
 
 mcp::uint256_t chainID();
 Epoch epoch(uint64_t last_summary_mci);
@@ -63,7 +63,7 @@ std::pair<bool, mcp::Transactions> mcp::genesis::try_initialize(mcp::db::db_tran
 	switch (mcp::mcp_network)
 	{
 	case mcp::mcp_networks::mcp_mini_test_network:
-		genesis_data  = mini_test_genesis_data;
+		genesis_data = mcp::custom_genesis_data.empty() ? mini_test_genesis_data : mcp::custom_genesis_data;
 		break;
 	case mcp::mcp_networks::mcp_test_network:
 		genesis_data = test_genesis_data;
@@ -207,6 +207,26 @@ std::pair<bool, dev::Address> mcp::genesis::isGenesisTransaction(mcp::block_hash
 	return std::make_pair(false, dev::ZeroAddress);
 }
 
+void mcp::genesis::put_accounts(mcp::db::db_transaction & transaction_a, mcp::block_store & store_a, AccountMap const & accounts_a, h256 const & ts_a)
+{
+	for (auto const & i : accounts_a)
+	{
+		mcp::account_state & state(*i.second);
+		assert_x(!state.hasNewCode() && state.storageOverlay().empty());
+
+		/// same steps as commit of chain state
+		state.setStorageRoot(state.baseRoot());
+		state.setPrevious();
+		state.setTs(ts_a);
+		state.record_init_hash();
+		state.clear_temp_state();
+
+		h256 acc_hash(state.hash());
+		store_a.account_state_put(transaction_a, acc_hash, state);
+		store_a.latest_account_state_put(transaction_a, i.first, acc_hash);
+	}
+}
+
 mcp::block_hash mcp::genesis::block_hash(0);
 dev::Address mcp::genesis::GenesisAddress(dev::ZeroAddress);
 
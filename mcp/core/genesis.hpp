@@ -13,6 +13,10 @@ namespace mcp
 		
 		static std::pair<bool, dev::Address> isGenesisTransaction(mcp::block_hash const& _h);
 
+		/// Writes the states of accounts without code or storage straight to the store, skipping the overlay db and
+		/// the trie commit of regular execution. The states hash as if committed by a transaction ts_a.
+		static void put_accounts(mcp::db::db_transaction & transaction_a, mcp::block_store & store_a, AccountMap const & accounts_a, h256 const & ts_a);
+
 		static mcp::block_hash block_hash;
 
 		static dev::Address GenesisAddress;
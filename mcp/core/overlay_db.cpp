@@ -5,6 +5,7 @@
 #include "overlay_db.hpp"
 #include <libdevcore/TrieDB.h>
 #include <mcp/core/block_store.hpp>
+#include <mcp/common/trie_node_cache.hpp>
 
 namespace mcp
 {
@@ -83,8 +84,13 @@ std::string overlay_db::lookup(dev::h256 const& _h) const
         return ret;
 
     std::string value;
+    if (mcp::trie_node_cache::instance().get(_h, value))
+        return value;
+
     bool error = store.contract_main_trie_node_get(transaction, mcp::code_hash(_h), value);
     //std::cout << "looktup: " << mcp::uint256_union(_h).to_string() << " string: " << value.size() << std::endl;
+    if (!error)
+        mcp::trie_node_cache::instance().put(_h, value);
     return value;
 }
 
@@ -94,7 +100,13 @@ bool overlay_db::exists(dev::h256 const& _h) const
         return true;
 
     std::string value;
-    return !store.contract_main_trie_node_get(transaction, mcp::code_hash(_h), value);
+    if (mcp::trie_node_cache::instance().get(_h, value))
+        return true;
+
+    bool error = store.contract_main_trie_node_get(transaction, mcp::code_hash(_h), value);
+    if (!error)
+        mcp::trie_node_cache::instance().put(_h, value);
+    return !error;
 
     /*
     return m_db && m_db->exists(toSlice(_h));
@@ -121,6 +121,8 @@ private:
 			witness_str_list_v0 = {
 				"0x49a1b41e8ccb704f5c069ef89b08cd33f764e9b3"
 			};
+			if (!mcp::custom_genesis_witnesses.empty())
+				witness_str_list_v0 = mcp::custom_genesis_witnesses;
 			break;
 		}
 		case mcp::mcp_networks::mcp_test_network:
@@ -10,19 +10,21 @@ mcp::db::db_column::~db_column()
 {
 }
 
-std::shared_ptr<rocksdb::ColumnFamilyOptions> mcp::db::db_column::default_column_family_options(std::shared_ptr<rocksdb::BlockBasedTableOptions> table_options)
+std::shared_ptr<rocksdb::ColumnFamilyOptions> mcp::db::db_column::default_column_family_options(std::shared_ptr<rocksdb::BlockBasedTableOptions> table_options, std::string const & table_a)
 { 
+	table_profile const & profile(database_config::profile.table(table_a));
 	rocksdb::ColumnFamilyOptions faOption;
-	faOption.compression = rocksdb::CompressionType::kLZ4Compression;
+	table_profile::parse_compression(profile.compression, faOption.compression);
+	table_profile::parse_compression(profile.bottommost_compression, faOption.bottommost_compression);
 
-	faOption.write_buffer_size = 128 * 1024 * 1024;
-	//faOption.max_write_buffer_number = 4;
+	faOption.write_buffer_size = profile.write_buffer * 1024 * 1024;
+	faOption.max_write_buffer_number = profile.max_write_buffers;
 	//faOption.min_write_buffer_number_to_merge = 4;
 	faOption.max_bytes_for_level_base = 1024 * 1024 * 1024;
 	//faOption.hard_pending_compaction_bytes_limit = 128 * 1024 * 1024 * 1024;
 	faOption.level_compaction_dynamic_level_bytes = true;
 	//faOption.optimize_filters_for_hits = true;
-	faOption.target_file_size_base = 128 * 1024 * 1024;
+	faOption.target_file_size_base = profile.target_file_size * 1024 * 1024;
 	if (table_options)
 		faOption.table_factory.reset(NewBlockBasedTableFactory(*table_options));
 	
@@ -30,8 +32,9 @@ std::shared_ptr<rocksdb::ColumnFamilyOptions> mcp::db::db_column::default_column
 	return std::make_shared<rocksdb::ColumnFamilyOptions>(faOption);
 }
 
-std::shared_ptr<rocksdb::BlockBasedTableOptions> mcp::db::db_column::default_table_options(std::shared_ptr<rocksdb::Cache> cache)
+std::shared_ptr<rocksdb::BlockBasedTableOptions> mcp::db::db_column::default_table_options(std::shared_ptr<rocksdb::Cache> cache, std::string const & table_a)
 {
+	table_profile const & profile(database_config::profile.table(table_a));
 	rocksdb::BlockBasedTableOptions table_options;
 
 	if (cache)
@@ -46,9 +49,9 @@ std::shared_ptr<rocksdb::BlockBasedTableOptions> mcp::db::db_column::default_tab
 	}
 
 	table_options.data_block_index_type = rocksdb::BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash;
-	table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
+	table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(profile.bloom_bits, false));
 	table_options.format_version = 4;
-	table_options.block_size = 16 * 1024;
+	table_options.block_size = profile.block_size * 1024;
 	return std::make_shared<rocksdb::BlockBasedTableOptions>(table_options);
 }
 
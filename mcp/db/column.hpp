@@ -16,8 +16,8 @@ namespace mcp
 		public:
 			db_column();
 			~db_column();
-			static std::shared_ptr<rocksdb::ColumnFamilyOptions> default_column_family_options(std::shared_ptr<rocksdb::BlockBasedTableOptions> table_options = nullptr);
-			static std::shared_ptr<rocksdb::BlockBasedTableOptions> default_table_options(std::shared_ptr<rocksdb::Cache> cache = nullptr);
+			static std::shared_ptr<rocksdb::ColumnFamilyOptions> default_column_family_options(std::shared_ptr<rocksdb::BlockBasedTableOptions> table_options = nullptr, std::string const & table_a = "");
+			static std::shared_ptr<rocksdb::BlockBasedTableOptions> default_table_options(std::shared_ptr<rocksdb::Cache> cache = nullptr, std::string const & table_a = "");
 			rocksdb::ColumnFamilyHandle* get_column_family_handle(int index);
 			int insert_column_families(std::string const& name, std::shared_ptr<rocksdb::ColumnFamilyOptions> cfops);
 			//void preserve_index();
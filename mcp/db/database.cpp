@@ -1,4 +1,7 @@
 #include "database.hpp"
+#include "sst_loader.hpp"
+
+#include <algorithm>
 
 using namespace mcp::db;
 
@@ -6,6 +9,11 @@ std::shared_ptr<rocksdb::Cache> mcp::db::database::table_cache = nullptr;
 std::shared_ptr<rocksdb::SstFileManager> mcp::db::database::rocksdb_sst_file_manager = std::shared_ptr<rocksdb::SstFileManager>(rocksdb::NewSstFileManager(rocksdb::Env::Default(), nullptr, "", 0));
 uint64_t mcp::db::database_config::write_buffer_size = 1024;
 bool mcp::db::database_config::cache_filter = true;
+bool mcp::db::database_config::archive = false;
+bool mcp::db::database_config::statistics = false;
+uint32_t mcp::db::database_config::perf_sample = 0;
+mcp::db::db_profile mcp::db::database_config::profile;
+std::shared_ptr<rocksdb::RateLimiter> mcp::db::database::rate_limiter = nullptr;
 //check return status
 void mcp::db::check_status(rocksdb::Status const& _status)
 {
@@ -19,11 +27,177 @@ void mcp::db::check_status(rocksdb::Status const& _status)
 }
 
 
+bool mcp::db::table_profile::parse_compression(std::string const & name_a, rocksdb::CompressionType & type_a)
+{
+	static std::map<std::string, rocksdb::CompressionType> const types = {
+		{ "none", rocksdb::kNoCompression },
+		{ "snappy", rocksdb::kSnappyCompression },
+		{ "zlib", rocksdb::kZlibCompression },
+		{ "lz4", rocksdb::kLZ4Compression },
+		{ "lz4hc", rocksdb::kLZ4HCCompression },
+		{ "zstd", rocksdb::kZSTD }
+	};
+	auto it(types.find(name_a));
+	if (it == types.end())
+		return true;
+	type_a = it->second;
+	return false;
+}
+
+void mcp::db::table_profile::serialize_json(mcp::json & json_a) const
+{
+	json_a["block_size"] = block_size;
+	json_a["bloom_bits"] = bloom_bits;
+	json_a["compression"] = compression;
+	json_a["bottommost_compression"] = bottommost_compression;
+	json_a["write_buffer"] = write_buffer;
+	json_a["max_write_buffers"] = max_write_buffers;
+	json_a["target_file_size"] = target_file_size;
+}
+
+bool mcp::db::table_profile::deserialize_json(mcp::json const & json_a)
+{
+	auto error(false);
+	try
+	{
+		if (json_a.count("block_size") && json_a["block_size"].is_number_unsigned())
+			block_size = json_a["block_size"].get<uint64_t>();
+		if (json_a.count("bloom_bits") && json_a["bloom_bits"].is_number())
+			bloom_bits = json_a["bloom_bits"].get<double>();
+		if (json_a.count("compression") && json_a["compression"].is_string())
+			compression = json_a["compression"].get<std::string>();
+		if (json_a.count("bottommost_compression") && json_a["bottommost_compression"].is_string())
+			bottommost_compression = json_a["bottommost_compression"].get<std::string>();
+		if (json_a.count("write_buffer") && json_a["write_buffer"].is_number_unsigned())
+			write_buffer = json_a["write_buffer"].get<uint64_t>();
+		if (json_a.count("max_write_buffers") && json_a["max_write_buffers"].is_number_unsigned())
+			max_write_buffers = json_a["max_write_buffers"].get<uint32_t>();
+		if (json_a.count("target_file_size") && json_a["target_file_size"].is_number_unsigned())
+			target_file_size = json_a["target_file_size"].get<uint64_t>();
+
+		rocksdb::CompressionType type;
+		error |= parse_compression(compression, type);
+		error |= parse_compression(bottommost_compression, type);
+		error |= block_size == 0 || write_buffer == 0 || max_write_buffers == 0 || target_file_size == 0;
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	return error;
+}
+
+bool mcp::db::db_profile::preset(std::string const & name_a, db_profile & profile_a)
+{
+	db_profile profile;
+	profile.name = name_a;
+	if (name_a == "validator")
+	{
+		/// mixed reads and writes, the defaults
+	}
+	else if (name_a == "rpc-archive")
+	{
+		/// random reads of old data dominate: more bloom bits, bigger blocks, compact cold levels
+		profile.db_write_buffer = 256;
+		profile.background_jobs = 6;
+		profile.default_table.block_size = 32;
+		profile.default_table.bloom_bits = 16;
+		profile.default_table.bottommost_compression = "zstd";
+		profile.default_table.write_buffer = 64;
+	}
+	else if (name_a == "sync-bootstrap")
+	{
+		/// bulk writes while catching up: big memtables and files, more compaction threads
+		profile.db_write_buffer = 1024;
+		profile.background_jobs = 12;
+		profile.subcompactions = 8;
+		profile.default_table.write_buffer = 256;
+		profile.default_table.max_write_buffers = 4;
+		profile.default_table.target_file_size = 256;
+	}
+	else
+		return true;
+
+	profile_a = profile;
+	return false;
+}
+
+void mcp::db::db_profile::serialize_json(mcp::json & json_a) const
+{
+	json_a["name"] = name;
+	json_a["db_write_buffer"] = db_write_buffer;
+	json_a["background_jobs"] = background_jobs;
+	json_a["subcompactions"] = subcompactions;
+	json_a["rate_limit"] = rate_limit;
+	json_a["direct_io"] = direct_io ? "true" : "false";
+	mcp::json j_table;
+	default_table.serialize_json(j_table);
+	json_a["table"] = j_table;
+	mcp::json j_tables = mcp::json::object();
+	for (auto const & t : tables)
+	{
+		mcp::json j;
+		t.second.serialize_json(j);
+		j_tables[t.first] = j;
+	}
+	json_a["tables"] = j_tables;
+}
+
+bool mcp::db::db_profile::deserialize_json(mcp::json const & json_a)
+{
+	auto error(false);
+	try
+	{
+		/// the preset first, then overrides on top of it
+		if (json_a.count("name") && json_a["name"].is_string())
+			error |= preset(json_a["name"].get<std::string>(), *this);
+		if (json_a.count("db_write_buffer") && json_a["db_write_buffer"].is_number_unsigned())
+			db_write_buffer = json_a["db_write_buffer"].get<uint64_t>();
+		if (json_a.count("background_jobs") && json_a["background_jobs"].is_number_unsigned())
+			background_jobs = json_a["background_jobs"].get<uint32_t>();
+		if (json_a.count("subcompactions") && json_a["subcompactions"].is_number_unsigned())
+			subcompactions = json_a["subcompactions"].get<uint32_t>();
+		if (json_a.count("rate_limit") && json_a["rate_limit"].is_number_unsigned())
+			rate_limit = json_a["rate_limit"].get<uint64_t>();
+		if (json_a.count("direct_io") && json_a["direct_io"].is_string())
+			direct_io = (json_a["direct_io"].get<std::string>() == "true" ? true : false);
+		if (json_a.count("table") && json_a["table"].is_object())
+			error |= default_table.deserialize_json(json_a["table"]);
+		if (json_a.count("tables") && json_a["tables"].is_object())
+		{
+			tables.clear();
+			for (auto it = json_a["tables"].begin(); it != json_a["tables"].end(); ++it)
+			{
+				table_profile t(default_table);
+				error |= t.deserialize_json(it.value());
+				tables[it.key()] = t;
+			}
+		}
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	return error;
+}
+
+mcp::db::table_profile const & mcp::db::db_profile::table(std::string const & name_a) const
+{
+	auto it(tables.find(name_a));
+	return it == tables.end() ? default_table : it->second;
+}
+
 void mcp::db::database_config::serialize_json(mcp::json &json_a) const
 {
 	json_a["cache"] = cache_size;
 	json_a["write_buffer"] = write_buffer_size;
 	json_a["cache_filter"] = cache_filter ? "true" : "false";
+	json_a["archive"] = archive ? "true" : "false";
+	json_a["statistics"] = statistics ? "true" : "false";
+	json_a["perf_sample"] = perf_sample;
+	mcp::json j_profile;
+	profile.serialize_json(j_profile);
+	json_a["profile"] = j_profile;
 }
 
 bool mcp::db::database_config::deserialize_json(mcp::json const & json_a)
@@ -37,6 +211,16 @@ bool mcp::db::database_config::deserialize_json(mcp::json const & json_a)
 			write_buffer_size = json_a["write_buffer"].get<std::uint64_t>();
 		if (json_a.count("cache_filter") && json_a["cache_filter"].is_string())
 			cache_filter = (json_a["cache_filter"].get<std::string>() == "true" ? true : false);
+		if (json_a.count("archive") && json_a["archive"].is_string())
+			archive = (json_a["archive"].get<std::string>() == "true" ? true : false);
+		if (json_a.count("statistics") && json_a["statistics"].is_string())
+			statistics = (json_a["statistics"].get<std::string>() == "true" ? true : false);
+		if (json_a.count("perf_sample") && json_a["perf_sample"].is_number_unsigned())
+			perf_sample = json_a["perf_sample"].get<uint32_t>();
+		if (json_a.count("profile") && json_a["profile"].is_string())
+			error |= db_profile::preset(json_a["profile"].get<std::string>(), profile);
+		else if (json_a.count("profile") && json_a["profile"].is_object())
+			error |= profile.deserialize_json(json_a["profile"]);
 	}
 	catch (std::runtime_error const &)
 	{
@@ -75,15 +259,16 @@ bool mcp::db::database_config::parse_old_version_data(mcp::json const & json_a,
 	return error;
 }
 
-mcp::db::database::database(boost::filesystem::path const& path_a) :
+mcp::db::database::database(boost::filesystem::path const& path_a, std::string const& name_a) :
 	m_db(nullptr),
 	m_path(path_a.string()),
+	m_name(name_a),
 	m_column(std::make_shared<db_column>()),
 	m_read_options(std::move(default_read_options())),
 	m_write_options(std::move(default_write_options()))
 {
-	auto tbops = mcp::db::db_column::default_table_options(mcp::db::database::get_table_cache());
-	auto cfops = mcp::db::db_column::default_column_family_options(tbops);
+	auto tbops = mcp::db::db_column::default_table_options(mcp::db::database::get_table_cache(), "count");
+	auto cfops = mcp::db::db_column::default_column_family_options(tbops, "count");
 	cfops->merge_operator = std::make_shared<count_merge_operator>();
 	cfops->max_successive_merges = 1000;
 	m_count = set_column_family(create_column_family("count", cfops));
@@ -91,6 +276,8 @@ mcp::db::database::database(boost::filesystem::path const& path_a) :
 
 mcp::db::database::~database()
 {
+	m_loader.reset();
+	m_gauges.clear();
 	for (auto handle : m_column->m_handles)
 	{
 		delete handle;
@@ -106,6 +293,62 @@ bool mcp::db::database::open()
 	if (status.ok())
 	{
 		//m_column->preserve_index();
+		for (auto & i : m_index)
+		{
+			if (i.second.name.empty())
+				i.second.name = i.second.shared ? i.second.prefix : m_column->m_column_families[i.second.col_index].name;
+			i.second.metrics = std::make_shared<table_metrics>(m_name, i.second.name);
+		}
+
+		std::vector<std::pair<std::string, std::string>> const properties = {
+			{ "mcp_db_cf_live_data_bytes", rocksdb::DB::Properties::kEstimateLiveDataSize },
+			{ "mcp_db_cf_sst_files_bytes", rocksdb::DB::Properties::kTotalSstFilesSize },
+			{ "mcp_db_cf_memtable_bytes", rocksdb::DB::Properties::kCurSizeAllMemTables },
+			{ "mcp_db_cf_table_readers_bytes", rocksdb::DB::Properties::kEstimateTableReadersMem },
+			{ "mcp_db_cf_pending_compaction_bytes", rocksdb::DB::Properties::kEstimatePendingCompactionBytes },
+			{ "mcp_db_cf_compaction_pending", rocksdb::DB::Properties::kCompactionPending },
+			{ "mcp_db_cf_immutable_memtables", rocksdb::DB::Properties::kNumImmutableMemTable },
+			{ "mcp_db_cf_level0_files", rocksdb::DB::Properties::kNumFilesAtLevelPrefix + std::string("0") }
+		};
+		std::string const label("db=\"" + m_name + "\"");
+		for (auto handle : m_column->m_handles)
+		{
+			for (auto const & p : properties)
+			{
+				std::string property(p.second);
+				m_gauges.push_back(std::make_unique<mcp::metrics::callback_gauge>(p.first, "rocksdb property " + property + " of the column family", [this, handle, property]() {
+					std::string value;
+					return m_db->GetProperty(handle, property, &value) ? boost::lexical_cast<double>(value) : 0.0;
+				}, label + ",cf=\"" + handle->GetName() + "\""));
+			}
+		}
+		m_gauges.push_back(std::make_unique<mcp::metrics::callback_gauge>("mcp_db_running_compactions", "rocksdb compactions running", [this]() {
+			uint64_t value(0);
+			m_db->GetIntProperty(rocksdb::DB::Properties::kNumRunningCompactions, &value);
+			return (double)value;
+		}, label));
+		m_gauges.push_back(std::make_unique<mcp::metrics::callback_gauge>("mcp_db_delayed_write_rate", "rocksdb delayed write rate in bytes per second, 0 if writes are not delayed", [this]() {
+			uint64_t value(0);
+			m_db->GetIntProperty(rocksdb::DB::Properties::kActualDelayedWriteRate, &value);
+			return (double)value;
+		}, label));
+		m_gauges.push_back(std::make_unique<mcp::metrics::callback_gauge>("mcp_db_write_stopped", "1 if rocksdb writes are stopped", [this]() {
+			uint64_t value(0);
+			m_db->GetIntProperty(rocksdb::DB::Properties::kIsWriteStopped, &value);
+			return (double)value;
+		}, label));
+		if (m_statistics)
+		{
+			m_gauges.push_back(std::make_unique<mcp::metrics::callback_gauge>("mcp_db_stall_seconds", "rocksdb write stall time", [this]() {
+				return m_statistics->getTickerCount(rocksdb::STALL_MICROS) / 1e6;
+			}, label));
+			m_gauges.push_back(std::make_unique<mcp::metrics::callback_gauge>("mcp_db_compaction_read_bytes", "rocksdb bytes read by compactions", [this]() {
+				return (double)m_statistics->getTickerCount(rocksdb::COMPACT_READ_BYTES);
+			}, label));
+			m_gauges.push_back(std::make_unique<mcp::metrics::callback_gauge>("mcp_db_compaction_write_bytes", "rocksdb bytes written by compactions", [this]() {
+				return (double)m_statistics->getTickerCount(rocksdb::COMPACT_WRITE_BYTES);
+			}, label));
+		}
 	}
 	else
 	{
@@ -140,6 +383,7 @@ void mcp::db::database::put(int const& _index, dev::Slice const& _k, dev::Slice
 		_k.copyTo(dev::SliceRef(&key));
 	}
 
+	mcp::db::perf_sample sample(info->metrics, perf_op::put);
 	rocksdb::Status status = m_db->Put(
 		*write_ops,
 		handle,
@@ -173,6 +417,7 @@ bool mcp::db::database::get(int const& _index, dev::Slice const& _k, std::string
 		_k.copyTo(dev::SliceRef(&key));
 	}
 
+	mcp::db::perf_sample sample(info->metrics, perf_op::get);
 	rocksdb::Status status = m_db->Get(
 		*read_ops,
 		handle,
@@ -214,6 +459,7 @@ void mcp::db::database::del(int const& _index, dev::Slice const& _k,
 	if (nullptr == write_ops)
 		write_ops = m_write_options;
 
+	mcp::db::perf_sample sample(info->metrics, perf_op::del);
 	rocksdb::Status status = m_db->Delete(
 		*write_ops,
 		handle,
@@ -261,6 +507,43 @@ void mcp::db::database::del_range(int const& index, dev::Slice const& start, dev
 	check_status(status);
 }
 
+void mcp::db::database::ingest(int const& _index, std::map<dev::bytes, dev::bytes> const& sorted_a, boost::filesystem::path const& file_a)
+{
+	std::shared_ptr<mcp::db::index_info> info = std::make_shared<mcp::db::index_info>();
+	auto handle = get_column_family_handle(_index, info);
+
+	rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), m_db->GetOptions(handle), handle);
+	check_status(writer.Open(file_a.string()));
+	dev::bytes key;
+	for (auto const & kv : sorted_a)
+	{
+		if (info->shared)
+		{
+			key.resize(info->prefix.size() + kv.first.size());
+			std::copy(info->prefix.begin(), info->prefix.end(), key.begin());
+			std::copy(kv.first.begin(), kv.first.end(), key.begin() + info->prefix.size());
+		}
+		else
+			key = kv.first;
+
+		check_status(writer.Put(
+			rocksdb::Slice((char const *)key.data(), key.size()),
+			rocksdb::Slice((char const *)kv.second.data(), kv.second.size())
+		));
+	}
+	check_status(writer.Finish());
+
+	rocksdb::IngestExternalFileOptions ingest_ops;
+	/// hard linked into the database, the file is gone from file_a
+	ingest_ops.move_files = true;
+	check_status(m_db->IngestExternalFile(handle, { file_a.string() }, ingest_ops));
+}
+
+void mcp::db::database::init_loader(boost::filesystem::path const& path_a, size_t const& min_bytes_a)
+{
+	m_loader = std::make_unique<sst_loader>(*this, path_a, min_bytes_a);
+}
+
 bool mcp::db::database::exists(int const& _index, dev::Slice const & _k,
 	std::shared_ptr<rocksdb::ReadOptions> read_ops_a)
 {
@@ -344,6 +627,13 @@ int mcp::db::database::set_column_family(int index_a, std::string const & name_a
 	return index;
 }
 
+void mcp::db::database::set_table_name(int index_a, std::string const & name_a)
+{
+	auto it = m_index.find(index_a);
+	assert_x(it != m_index.end());
+	it->second.name = name_a;
+}
+
 std::shared_ptr<rocksdb::ManagedSnapshot> mcp::db::database::create_snapshot()
 { 
 	return std::make_shared<rocksdb::ManagedSnapshot>(m_db, m_db->GetSnapshot());
@@ -368,9 +658,12 @@ rocksdb::Options mcp::db::database::default_DB_options()
 	options.create_if_missing = true;
 	options.create_missing_column_families = true;
 	//options.max_file_opening_threads = 4;
-	options.db_write_buffer_size = 512 * 1024 * 1024;
-	options.max_background_jobs = 8;
-	options.max_subcompactions = 4;
+	db_profile const & profile(database_config::profile);
+	options.db_write_buffer_size = profile.db_write_buffer * 1024 * 1024;
+	options.max_background_jobs = profile.background_jobs;
+	options.max_subcompactions = profile.subcompactions;
+	options.use_direct_reads = profile.direct_io;
+	options.use_direct_io_for_flush_and_compaction = profile.direct_io;
 	//options.table_cache_numshardbits = 6;
 	//options.allow_mmap_reads = true;
 	//options.bytes_per_sync = 1 * 1024 * 1024;
@@ -385,7 +678,18 @@ rocksdb::Options mcp::db::database::default_DB_options()
 	//options.row_cache = rocksdb::NewLRUCache(6 * 1024 * 1024 * 1024);
 
 	//options.rate_limiter.reset(rocksdb::NewGenericRateLimiter(10 * 1024 * 1024));
-	//options.statistics = rocksdb::CreateDBStatistics();
+	if (profile.rate_limit)
+	{
+		if (!rate_limiter)
+			rate_limiter.reset(rocksdb::NewGenericRateLimiter(profile.rate_limit * 1024 * 1024));
+		options.rate_limiter = rate_limiter;
+	}
+	if (database_config::statistics)
+	{
+		m_statistics = rocksdb::CreateDBStatistics();
+		m_statistics->set_stats_level(rocksdb::StatsLevel::kExceptDetailedTimers);
+		options.statistics = m_statistics;
+	}
 	//options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(3));
 	return options;
 }
@@ -435,6 +739,7 @@ rocksdb::ColumnFamilyHandle* mcp::db::database::get_column_family_handle(int ind
 		info->col_index = it->second.col_index;
 		info->prefix = it->second.prefix;
 		info->shared = it->second.shared;
+		info->metrics = it->second.metrics;
 	}
 
 	return m_column->get_column_family_handle(it->second.col_index);
@@ -472,3 +777,137 @@ std::string mcp::db::database::get_rocksdb_state(uint64_t limit)
 	return str;
 }
 
+
+mcp::json mcp::db::database::get_telemetry()
+{
+	mcp::json result;
+	result["block_cache_usage"] = table_cache ? table_cache->GetUsage() : 0;
+	result["block_cache_pinned_usage"] = table_cache ? table_cache->GetPinnedUsage() : 0;
+
+	mcp::json cfs = mcp::json::object();
+	std::vector<std::string> const properties = {
+		rocksdb::DB::Properties::kEstimateLiveDataSize,
+		rocksdb::DB::Properties::kTotalSstFilesSize,
+		rocksdb::DB::Properties::kCurSizeAllMemTables,
+		rocksdb::DB::Properties::kEstimateTableReadersMem,
+		rocksdb::DB::Properties::kEstimatePendingCompactionBytes,
+		rocksdb::DB::Properties::kCompactionPending,
+		rocksdb::DB::Properties::kNumImmutableMemTable,
+		rocksdb::DB::Properties::kEstimateNumKeys
+	};
+	for (auto handle : m_column->m_handles)
+	{
+		mcp::json cf;
+		for (auto const & p : properties)
+		{
+			uint64_t value(0);
+			if (m_db->GetIntProperty(handle, p, &value))
+				cf[p] = value;
+		}
+		std::map<std::string, std::string> stats;
+		if (m_db->GetMapProperty(handle, rocksdb::DB::Properties::kCFStats, &stats))
+		{
+			mcp::json cf_stats;
+			for (auto const & s : stats)
+				cf_stats[s.first] = s.second;
+			cf["cfstats"] = cf_stats;
+		}
+		cfs[handle->GetName()] = cf;
+	}
+	result["column_families"] = cfs;
+
+	mcp::json tables = mcp::json::object();
+	for (auto const & i : m_index)
+	{
+		auto const & metrics(i.second.metrics);
+		if (!metrics || !metrics->samples.value())
+			continue;
+		mcp::json table;
+		table["samples"] = metrics->samples.value();
+		for (size_t op = 0; op < metrics->latency.size(); op++)
+		{
+			auto const & h(*metrics->latency[op]);
+			if (!h.count())
+				continue;
+			mcp::json latency;
+			latency["count"] = h.count();
+			latency["p50_us"] = h.quantile(0.5);
+			latency["p99_us"] = h.quantile(0.99);
+			table[op == 0 ? "get" : op == 1 ? "put" : "del"] = latency;
+		}
+		table["block_reads"] = metrics->block_reads.value();
+		table["block_read_bytes"] = metrics->block_read_bytes.value();
+		table["block_cache_hits"] = metrics->block_cache_hits.value();
+		table["memtable_hits"] = metrics->memtable_hits.value();
+		table["file_read_bytes"] = metrics->file_read_bytes.value();
+		table["block_read_p99_us"] = metrics->block_read_time.quantile(0.99);
+		tables[metrics->table] = table;
+	}
+	result["tables"] = tables;
+
+	if (m_statistics)
+	{
+		mcp::json tickers = mcp::json::object();
+		for (auto const & t : rocksdb::TickersNameMap)
+		{
+			uint64_t value(m_statistics->getTickerCount(t.first));
+			if (value)
+				tickers[t.second] = value;
+		}
+		result["tickers"] = tickers;
+
+		mcp::json histograms = mcp::json::object();
+		for (auto const & h : rocksdb::HistogramsNameMap)
+		{
+			rocksdb::HistogramData data;
+			m_statistics->histogramData(h.first, &data);
+			if (!data.count)
+				continue;
+			mcp::json histogram;
+			histogram["count"] = data.count;
+			histogram["p50"] = data.median;
+			histogram["p95"] = data.percentile95;
+			histogram["p99"] = data.percentile99;
+			histogram["max"] = data.max;
+			histograms[h.second] = histogram;
+		}
+		result["histograms"] = histograms;
+	}
+	return result;
+}
+
+std::string mcp::db::database::get_telemetry_summary()
+{
+	std::string str;
+	for (auto handle : m_column->m_handles)
+	{
+		uint64_t pending(0), live(0), l0(0);
+		m_db->GetIntProperty(handle, rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &pending);
+		m_db->GetIntProperty(handle, rocksdb::DB::Properties::kEstimateLiveDataSize, &live);
+		std::string value;
+		if (m_db->GetProperty(handle, rocksdb::DB::Properties::kNumFilesAtLevelPrefix + std::string("0"), &value))
+			l0 = boost::lexical_cast<uint64_t>(value);
+		str += handle->GetName() + ":[live:" + std::to_string(live) + " , pending compaction:" + std::to_string(pending) + " , l0 files:" + std::to_string(l0) + "] ";
+	}
+
+	uint64_t delayed(0), stopped(0);
+	m_db->GetIntProperty(rocksdb::DB::Properties::kActualDelayedWriteRate, &delayed);
+	m_db->GetIntProperty(rocksdb::DB::Properties::kIsWriteStopped, &stopped);
+	str += "delayed write rate:" + std::to_string(delayed) + " , write stopped:" + std::to_string(stopped);
+	if (m_statistics)
+		str += " , stall:" + std::to_string(m_statistics->getTickerCount(rocksdb::STALL_MICROS) / 1000) + "ms";
+
+	/// slowest sampled gets
+	std::vector<std::pair<uint64_t, std::string>> slowest;
+	for (auto const & i : m_index)
+		if (i.second.metrics && i.second.metrics->latency[(size_t)perf_op::get]->count())
+			slowest.emplace_back(i.second.metrics->latency[(size_t)perf_op::get]->quantile(0.99), i.second.name);
+	std::sort(slowest.rbegin(), slowest.rend());
+	if (!slowest.empty())
+	{
+		str += " , get p99:";
+		for (size_t i = 0; i < slowest.size() && i < 5; i++)
+			str += " " + slowest[i].second + "=" + std::to_string(slowest[i].first) + "us";
+	}
+	return str;
+}
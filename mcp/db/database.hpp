@@ -8,11 +8,14 @@
 #include <mcp/db/db_transaction.hpp>
 #include <mcp/db/db_iterator.hpp>
 #include <mcp/db/column.hpp>
+#include <mcp/db/telemetry.hpp>
 #include <mcp/common/log.hpp>
 #include <rocksdb/advanced_cache.h>
 #include <rocksdb/sst_file_manager.h>
+#include <rocksdb/sst_file_writer.h>
 #include <rocksdb/rate_limiter.h>
 #include <rocksdb/slice_transform.h>
+#include <rocksdb/statistics.h>
 #include <mcp/common/mcp_json.hpp>
 
 namespace mcp
@@ -31,6 +34,46 @@ namespace mcp
 			}
 		};
 
+		/// rocksdb options of one column family
+		class table_profile
+		{
+		public:
+			void serialize_json(mcp::json &) const;
+			/// fields not in the json keep their value
+			bool deserialize_json(mcp::json const &);
+			static bool parse_compression(std::string const & name_a, rocksdb::CompressionType & type_a);
+
+			uint64_t block_size = 16; //KB
+			double bloom_bits = 10;
+			std::string compression = "lz4";
+			std::string bottommost_compression = "lz4";
+			uint64_t write_buffer = 128; //MB, memtable budget
+			uint32_t max_write_buffers = 2;
+			uint64_t target_file_size = 128; //MB
+		};
+
+		/// rocksdb options for a node role: a named preset with overrides, per column family where given
+		class db_profile
+		{
+		public:
+			/// validator, rpc-archive or sync-bootstrap, return true if unknown
+			static bool preset(std::string const & name_a, db_profile & profile_a);
+			void serialize_json(mcp::json &) const;
+			bool deserialize_json(mcp::json const &);
+			/// options of the named column family, the default table options if it has no overrides
+			table_profile const & table(std::string const & name_a) const;
+
+			std::string name = "validator";
+			uint64_t db_write_buffer = 512; //MB
+			uint32_t background_jobs = 8;
+			uint32_t subcompactions = 4;
+			uint64_t rate_limit = 0; //MB/s of flush and compaction writes, 0 is off
+			bool direct_io = false;
+			table_profile default_table;
+			/// column family name -> overrides
+			std::map<std::string, table_profile> tables;
+		};
+
 		class database_config
 		{
 		public:
@@ -41,6 +84,10 @@ namespace mcp
 			uint64_t cache_size; //MB
 			static uint64_t write_buffer_size; //MB
 			static bool cache_filter; //Caching Index and Filter Blocks
+			static bool archive; //Moving old stable blocks, transactions and receipts to append only archive files
+			static bool statistics; //RocksDB statistics and histograms
+			static uint32_t perf_sample; //Perf context of one in perf_sample operations per table, 0 is off
+			static db_profile profile; //Applied when databases are opened
 		};
 
 		struct index_info
@@ -48,6 +95,9 @@ namespace mcp
 			int col_index = 0;
 			bool shared = false;
 			std::string prefix = "";
+			/// logical table name in telemetry, the prefix if not named
+			std::string name = "";
+			std::shared_ptr<table_metrics> metrics;
 		};
 
 		class forward_iterator;
@@ -55,17 +105,23 @@ namespace mcp
 		enum class db_column_index;
 		class db_transaction;
 		class db_column;
+		class sst_loader;
 		class database
 		{
 			friend class write_batch;
 			friend class db_transaction;
 			friend class db_column;
 		public:
-			database(boost::filesystem::path const& path_a);
+			/// name_a labels the metrics of this database, e.g. db="chain"
+			database(boost::filesystem::path const& path_a, std::string const& name_a);
 			~database();
 			bool open();
 
 			std::string get_rocksdb_state(uint64_t limit);
+			/// statistics, per column family properties and sampled per table perf context
+			mcp::json get_telemetry();
+			/// one line for the periodic report
+			std::string get_telemetry_summary();
 
 			void put(int const& _index, dev::Slice const& _k, dev::Slice const& _v,
 				std::shared_ptr<rocksdb::WriteOptions> write_ops_a = nullptr);
@@ -77,6 +133,12 @@ namespace mcp
 				std::shared_ptr<rocksdb::WriteOptions> write_ops_a = nullptr);
 			bool exists(int const& _index, dev::Slice const& _k,
 				std::shared_ptr<rocksdb::ReadOptions> read_ops_a = nullptr);
+			/// writes sorted keys of a table to an sst file at file_a and ingests it, bypassing the WAL and memtables
+			void ingest(int const& _index, std::map<dev::bytes, dev::bytes> const& sorted_a, boost::filesystem::path const& file_a);
+			/// call after open. Creates the loader of db_transaction::put_bulk, sst files are built in path_a
+			void init_loader(boost::filesystem::path const& path_a, size_t const& min_bytes_a);
+			/// nullptr if there is none
+			sst_loader * loader() { return m_loader.get(); }
 			//bool merge(int const& _index, dev::Slice const & _k, dev::Slice const & _v,
 			//	std::shared_ptr<rocksdb::WriteOptions> write_ops_a = nullptr);
 
@@ -84,6 +146,8 @@ namespace mcp
 			mcp::db::db_transaction create_transaction(std::shared_ptr<rocksdb::WriteOptions> write_options_a = nullptr, std::shared_ptr<rocksdb::TransactionOptions> txn_ops_a = nullptr);
 			int create_column_family(std::string const& name_a, std::shared_ptr<rocksdb::ColumnFamilyOptions> cfops);
 			int set_column_family(int index_a, std::string const & name_a="");
+			/// call before open
+			void set_table_name(int index_a, std::string const & name_a);
 			std::shared_ptr<rocksdb::ManagedSnapshot> create_snapshot();
 			//void release_snapshot(std::shared_ptr<rocksdb::ManagedSnapshot> _snapshot) { m_db->ReleaseSnapshot(_snapshot.snapshot()); };
 
@@ -106,17 +170,25 @@ namespace mcp
 			//std::shared_ptr<rocksdb::WriteOptions> get_write_options() { return m_write_options; }
 
 			std::string m_path;
+			std::string const m_name;
 			rocksdb::TransactionDB* m_db;
 			std::shared_ptr<rocksdb::ReadOptions> m_read_options;
 			std::shared_ptr<rocksdb::WriteOptions> m_write_options;
 			std::shared_ptr<db_column> m_column;
 			static std::shared_ptr<rocksdb::Cache> table_cache;
 			static std::shared_ptr<rocksdb::SstFileManager> rocksdb_sst_file_manager;
+			/// shared by all databases, created on first open if the profile limits writes
+			static std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
 
 			int m_count;
 
 			std::map<int, index_info> m_index;
 
+			std::shared_ptr<rocksdb::Statistics> m_statistics;
+			/// per column family properties, sampled when metrics are scraped
+			std::vector<std::unique_ptr<mcp::metrics::callback_gauge>> m_gauges;
+			std::unique_ptr<sst_loader> m_loader;
+
 			mcp::log m_log = { mcp::log("db") };
 		};
 	}
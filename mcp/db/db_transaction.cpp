@@ -1,6 +1,13 @@
 #include "db_transaction.hpp"
+#include "sst_loader.hpp"
+#include <mcp/common/metrics.hpp>
 #include <boost/endian/conversion.hpp>
 
+namespace
+{
+	mcp::metrics::histogram commit_latency("mcp_db_commit_seconds", "rocksdb write transaction commit time");
+}
+
 mcp::db::db_transaction::db_transaction(mcp::db::database& m_db_a,
 	std::shared_ptr<rocksdb::WriteOptions> write_options_a,
 	std::shared_ptr<rocksdb::TransactionOptions> txn_ops_a
@@ -27,6 +34,8 @@ mcp::db::db_transaction::db_transaction(mcp::db::db_transaction && other_a):
 	other_a.m_txn = nullptr;
 	m_commited_or_rollbacked = other_a.m_commited_or_rollbacked;
 	m_read_only = other_a.m_read_only;
+	m_snapshot = std::move(other_a.m_snapshot);
+	m_bulk = std::move(other_a.m_bulk);
 }
 
 mcp::db::db_transaction::~db_transaction()
@@ -59,6 +68,7 @@ void mcp::db::db_transaction::put(int const& index, dev::Slice const& _k, dev::S
 		_k.copyTo(dev::SliceRef(&key));
 	}
 
+	mcp::db::perf_sample sample(info->metrics, mcp::db::perf_op::put);
 	rocksdb::Status status = m_txn->Put(
 		handle,
 		rocksdb::Slice(key.data(), key.size()),
@@ -69,6 +79,36 @@ void mcp::db::db_transaction::put(int const& index, dev::Slice const& _k, dev::S
 	check_status(status);
 }
 
+void mcp::db::db_transaction::put_bulk(int const& index, dev::Slice const& _k, dev::Slice const& _v)
+{
+	if (!m_db.loader())
+	{
+		put(index, _k, _v);
+		return;
+	}
+
+	m_bulk[index][dev::bytes(_k.begin(), _k.end())] = dev::bytes(_v.begin(), _v.end());
+}
+
+bool mcp::db::db_transaction::get_bulk(int const& index, dev::Slice const& _k, std::string& _v)
+{
+	if (!m_bulk.empty())
+	{
+		auto table(m_bulk.find(index));
+		if (table != m_bulk.end())
+		{
+			auto it(table->second.find(dev::bytes(_k.begin(), _k.end())));
+			if (it != table->second.end())
+			{
+				_v.assign(it->second.begin(), it->second.end());
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 /*	input:	_k is key, _v is value
 *	return
 *	true :	key exist , _v is data
@@ -78,6 +118,9 @@ bool mcp::db::db_transaction::get(int const& index, dev::Slice const& _k, std::s
 	std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a,
 	std::shared_ptr<rocksdb::ReadOptions> read_ops_a)
 {
+	if (get_bulk(index, _k, _v))
+		return true;
+
 	std::shared_ptr<mcp::db::index_info> info = std::make_shared<mcp::db::index_info>();
 	auto handle = m_db.get_column_family_handle(index, info);
 	
@@ -100,7 +143,10 @@ bool mcp::db::db_transaction::get(int const& index, dev::Slice const& _k, std::s
 
 	if (snapshot_a)
 		read_ops->snapshot = snapshot_a->snapshot();
+	else if (m_snapshot)
+		read_ops->snapshot = m_snapshot->snapshot();
 
+	mcp::db::perf_sample sample(info->metrics, mcp::db::perf_op::get);
 	rocksdb::Status status = m_txn->Get(
 		*read_ops,
 		handle,
@@ -120,6 +166,9 @@ bool mcp::db::db_transaction::get(int const& index, dev::Slice const& _k, std::s
 
 void mcp::db::db_transaction::del(int const& index, dev::Slice const& _k)
 {
+	if (!m_bulk.empty() && m_bulk.count(index))
+		m_bulk[index].erase(dev::bytes(_k.begin(), _k.end()));
+
 	std::shared_ptr<mcp::db::index_info> info = std::make_shared<mcp::db::index_info>();
 	auto handle = m_db.get_column_family_handle(index, info);
 	
@@ -136,6 +185,7 @@ void mcp::db::db_transaction::del(int const& index, dev::Slice const& _k)
 		_k.copyTo(dev::SliceRef(&key));
 	}
 
+	mcp::db::perf_sample sample(info->metrics, mcp::db::perf_op::del);
 	rocksdb::Status status = m_txn->Delete(
 		handle,
 		rocksdb::Slice(key.data(), key.size())
@@ -149,6 +199,10 @@ bool mcp::db::db_transaction::exists(int const& index, dev::Slice const & _k,
 	std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a,
 	std::shared_ptr<rocksdb::ReadOptions> read_ops_a)
 {
+	std::string bulk;
+	if (get_bulk(index, _k, bulk))
+		return true;
+
 	std::shared_ptr<mcp::db::index_info> info = std::make_shared<mcp::db::index_info>();
 	auto handle = m_db.get_column_family_handle(index, info);
 	
@@ -171,8 +225,11 @@ bool mcp::db::db_transaction::exists(int const& index, dev::Slice const & _k,
 
 	if (snapshot_a)
 		read_ops->snapshot = snapshot_a->snapshot();
+	else if (m_snapshot)
+		read_ops->snapshot = m_snapshot->snapshot();
 
 	std::string value;
+	mcp::db::perf_sample sample(info->metrics, mcp::db::perf_op::get);
 	rocksdb::Status status = m_txn->Get(
 		*read_ops,
 		handle,
@@ -235,6 +292,8 @@ uint64_t mcp::db::db_transaction::count_get(std::string const& _k, std::shared_p
 	std::shared_ptr<rocksdb::ReadOptions> read_ops = mcp::db::database::default_read_options();
 	if (snapshot_a)
 		read_ops->snapshot = snapshot_a->snapshot();
+	else if (m_snapshot)
+		read_ops->snapshot = m_snapshot->snapshot();
 	std::string value = "";
 
 	rocksdb::Status status = m_txn->Get(
@@ -258,14 +317,34 @@ uint64_t mcp::db::db_transaction::count_get(std::string const& _k, std::shared_p
 	return i_value;
 }
 
+void mcp::db::db_transaction::set_snapshot(std::shared_ptr<rocksdb::ManagedSnapshot> const & snapshot_a)
+{
+	m_snapshot = snapshot_a;
+}
+
 void mcp::db::db_transaction::commit()
 {
 	if (m_commited_or_rollbacked)
 		return;
 
 	m_commited_or_rollbacked = true;
+	if (!m_bulk.empty())
+	{
+		sst_loader::batch bulk(std::move(m_bulk));
+		m_bulk.clear();
+		/// ingested and synced first, what is committed never references keys that are not durable
+		if (m_db.loader()->worth_loading(bulk))
+			m_db.loader()->load(bulk);
+		else
+		{
+			for (auto const & table : bulk)
+				for (auto const & kv : table.second)
+					put(table.first, dev::Slice((char const *)kv.first.data(), kv.first.size()), dev::Slice((char const *)kv.second.data(), kv.second.size()));
+		}
+	}
 	if (!m_read_only)
 	{
+		mcp::metrics::timer_guard tg(commit_latency);
 		rocksdb::Status status = m_txn->Commit();
 		check_status(status);
 	}
@@ -277,6 +356,7 @@ void mcp::db::db_transaction::rollback()
 		return;
 
 	m_commited_or_rollbacked = true;
+	m_bulk.clear();
 	rocksdb::Status status = m_txn->Rollback();
 	check_status(status);
 }
@@ -299,6 +379,8 @@ mcp::db::forward_iterator mcp::db::db_transaction::begin(int const& index,
 	read_ops->fill_cache = false;
 	if (snapshot_a != nullptr)
 		read_ops->snapshot = snapshot_a->snapshot();
+	else if (m_snapshot)
+		read_ops->snapshot = m_snapshot->snapshot();
 
 	auto it = m_txn->GetIterator(*read_ops, handle);
 	return forward_iterator(it);
@@ -319,6 +401,8 @@ mcp::db::forward_iterator mcp::db::db_transaction::begin(int const& index,
 	read_ops->fill_cache = false;
 	if (snapshot_a != nullptr)
 		read_ops->snapshot = snapshot_a->snapshot();
+	else if (m_snapshot)
+		read_ops->snapshot = m_snapshot->snapshot();
 	
 	dev::Slicebytes key;
 	if (info->shared)
@@ -358,6 +442,8 @@ mcp::db::backward_iterator mcp::db::db_transaction::rbegin(int const& index,
 	read_ops->fill_cache = false;
 	if (snapshot_a != nullptr)
 		read_ops->snapshot = snapshot_a->snapshot();
+	else if (m_snapshot)
+		read_ops->snapshot = m_snapshot->snapshot();
 
 	auto it = m_txn->GetIterator(*read_ops, handle);
 	return backward_iterator(it);
@@ -378,6 +464,8 @@ mcp::db::backward_iterator mcp::db::db_transaction::rbegin(int const& index,
 	read_ops->fill_cache = false;
 	if (snapshot_a != nullptr)
 		read_ops->snapshot = snapshot_a->snapshot();
+	else if (m_snapshot)
+		read_ops->snapshot = m_snapshot->snapshot();
 
 	dev::Slicebytes key;
 	if (info->shared)
@@ -424,6 +512,8 @@ mcp::db::db_transaction & mcp::db::db_transaction::operator= (mcp::db::db_transa
 
 	m_commited_or_rollbacked = other_a.m_commited_or_rollbacked;
 	m_read_only = other_a.m_read_only;
+	m_snapshot = std::move(other_a.m_snapshot);
+	m_bulk = std::move(other_a.m_bulk);
 	return *this;
 }
 
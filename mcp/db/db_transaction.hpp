@@ -27,6 +27,9 @@ namespace mcp
 			static std::shared_ptr<rocksdb::TransactionOptions> default_trans_options();
 
 			void put(int const& index, dev::Slice const& _k, dev::Slice const& _v);
+			/// for bulk loaded tables: kept in the transaction and ingested by the database loader when it commits,
+			/// before its other writes, dropped if it rolls back. A plain put if the database has no loader
+			void put_bulk(int const& index, dev::Slice const& _k, dev::Slice const& _v);
 			bool get(int const& index, dev::Slice const& _k, std::string& _v, 
 				std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a = nullptr, 
 				std::shared_ptr<rocksdb::ReadOptions> read_ops_a = nullptr
@@ -42,6 +45,9 @@ namespace mcp
 			void count_del(std::string const& _k);
 			uint64_t count_get(std::string const& _k, std::shared_ptr<rocksdb::ManagedSnapshot> snapshot_a = nullptr);
 
+			/// reads that do not pass a snapshot see this one, null reads the latest data
+			void set_snapshot(std::shared_ptr<rocksdb::ManagedSnapshot> const & snapshot_a);
+
 			void commit();
 			void rollback();
 
@@ -67,10 +73,15 @@ namespace mcp
 
 			mcp::db::db_transaction & operator= (mcp::db::db_transaction && other_a);
 		private:
+			/// bulk puts of this transaction, iterators do not see them before commit
+			bool get_bulk(int const& index, dev::Slice const& _k, std::string& _v);
+
 			database& m_db;
 			rocksdb::Transaction* m_txn;
 			bool m_commited_or_rollbacked;
 			bool m_read_only;
+			std::shared_ptr<rocksdb::ManagedSnapshot> m_snapshot;
+			std::map<int, std::map<dev::bytes, dev::bytes>> m_bulk;
 		};	
 	}
 }
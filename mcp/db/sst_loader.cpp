@@ -0,0 +1,44 @@
+#include "sst_loader.hpp"
+
+mcp::db::sst_loader::sst_loader(mcp::db::database & db_a, boost::filesystem::path const & path_a, size_t const & min_bytes_a) :
+	m_db(db_a),
+	m_path(path_a),
+	m_min_bytes(min_bytes_a),
+	m_files(mcp::metrics::registry::instance().counter("mcp_db_ingested_files_total", "sst files bulk loaded into rocksdb", "")),
+	m_ingested_keys(mcp::metrics::registry::instance().counter("mcp_db_ingested_keys_total", "keys bulk loaded into rocksdb", "")),
+	m_ingest_time(mcp::metrics::registry::instance().histogram("mcp_db_ingest_seconds", "time writing and ingesting the sst files of one commit", ""))
+{
+	/// files left here were never ingested, the commits they belonged to failed
+	boost::filesystem::remove_all(m_path);
+	boost::filesystem::create_directories(m_path);
+}
+
+bool mcp::db::sst_loader::worth_loading(batch const & batch_a) const
+{
+	size_t bytes(0);
+	for (auto const & table : batch_a)
+		for (auto const & kv : table.second)
+			bytes += kv.first.size() + kv.second.size();
+	return bytes >= m_min_bytes;
+}
+
+void mcp::db::sst_loader::load(batch const & batch_a)
+{
+	mcp::metrics::timer_guard timer(m_ingest_time);
+	for (auto const & table : batch_a)
+	{
+		boost::filesystem::path file(m_path / (std::to_string(m_file_number++) + ".sst"));
+		try
+		{
+			m_db.ingest(table.first, table.second, file);
+		}
+		catch (...)
+		{
+			boost::system::error_code ec;
+			boost::filesystem::remove(file, ec);
+			throw;
+		}
+		m_files.add();
+		m_ingested_keys.add(table.second.size());
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <mcp/db/database.hpp>
+#include <mcp/common/metrics.hpp>
+
+#include <atomic>
+
+namespace mcp
+{
+	namespace db
+	{
+		/// Bulk load of derived write once tables: the puts of a committing transaction are written to sorted sst files
+		/// and ingested before the rest of the transaction is committed, bypassing the WAL and memtables. Ingestion syncs
+		/// the files and the manifest, commit never returns while a key is only in memory. A crash between ingestion and
+		/// commit leaves keys that nothing references yet, so only tables whose keys are rewritten with the same value
+		/// when the commit is replayed may be bulk loaded.
+		class sst_loader
+		{
+		public:
+			/// table index -> sorted keys
+			using batch = std::map<int, std::map<dev::bytes, dev::bytes>>;
+
+			/// sst files are built in path_a, it is emptied first. Batches of less than min_bytes_a are not worth
+			/// an sst file each and are put through the transaction
+			sst_loader(mcp::db::database & db_a, boost::filesystem::path const & path_a, size_t const & min_bytes_a);
+
+			void enable(bool const & enable_a) { m_enabled = enable_a; }
+			bool enabled() const { return m_enabled; }
+
+			/// true if batch_a is to be ingested rather than put through the transaction
+			bool worth_loading(batch const & batch_a) const;
+			/// writes and ingests batch_a. Throws on error, tables ingested before stay as after a crash
+			void load(batch const & batch_a);
+
+		private:
+			mcp::db::database & m_db;
+			boost::filesystem::path const m_path;
+			size_t const m_min_bytes;
+			std::atomic<bool> m_enabled = { false };
+			std::atomic<uint64_t> m_file_number = { 0 };
+
+			mcp::metrics::counter & m_files;
+			mcp::metrics::counter & m_ingested_keys;
+			mcp::metrics::histogram & m_ingest_time;
+		};
+	}
+}
@@ -0,0 +1,62 @@
+#include "telemetry.hpp"
+#include "database.hpp"
+
+#include <rocksdb/iostats_context.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
+
+namespace
+{
+	std::string const op_names[] = { "get", "put", "del" };
+
+	thread_local uint64_t operations(0);
+}
+
+mcp::db::table_metrics::table_metrics(std::string const & db_a, std::string const & table_a) :
+	table(table_a),
+	samples(mcp::metrics::registry::instance().counter("mcp_db_table_samples_total", "rocksdb operations sampled for perf context", "db=\"" + db_a + "\",table=\"" + table_a + "\"")),
+	block_reads(mcp::metrics::registry::instance().counter("mcp_db_table_block_reads_total", "sst blocks read from disk by sampled operations", "db=\"" + db_a + "\",table=\"" + table_a + "\"")),
+	block_read_bytes(mcp::metrics::registry::instance().counter("mcp_db_table_block_read_bytes_total", "bytes of sst blocks read from disk by sampled operations", "db=\"" + db_a + "\",table=\"" + table_a + "\"")),
+	block_cache_hits(mcp::metrics::registry::instance().counter("mcp_db_table_block_cache_hits_total", "block cache hits of sampled operations", "db=\"" + db_a + "\",table=\"" + table_a + "\"")),
+	memtable_hits(mcp::metrics::registry::instance().counter("mcp_db_table_memtable_hits_total", "sampled gets answered from a memtable", "db=\"" + db_a + "\",table=\"" + table_a + "\"")),
+	file_read_bytes(mcp::metrics::registry::instance().counter("mcp_db_table_file_read_bytes_total", "file bytes read by sampled operations", "db=\"" + db_a + "\",table=\"" + table_a + "\"")),
+	block_read_time(mcp::metrics::registry::instance().histogram("mcp_db_table_block_read_seconds", "time reading sst blocks of sampled operations", "db=\"" + db_a + "\",table=\"" + table_a + "\""))
+{
+	for (size_t i = 0; i < latency.size(); i++)
+		latency[i] = &mcp::metrics::registry::instance().histogram("mcp_db_table_op_seconds", "latency of sampled rocksdb operations",
+			"db=\"" + db_a + "\",table=\"" + table_a + "\",op=\"" + op_names[i] + "\"");
+}
+
+mcp::db::perf_sample::perf_sample(std::shared_ptr<table_metrics> const & metrics_a, perf_op const & op_a) :
+	m_metrics(nullptr),
+	m_op(op_a)
+{
+	uint32_t const & rate(mcp::db::database_config::perf_sample);
+	if (!metrics_a || !rate || ++operations % rate)
+		return;
+
+	m_metrics = metrics_a.get();
+	rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeExceptForMutex);
+	rocksdb::get_perf_context()->Reset();
+	rocksdb::get_iostats_context()->Reset();
+	m_start = std::chrono::steady_clock::now();
+}
+
+mcp::db::perf_sample::~perf_sample()
+{
+	if (!m_metrics)
+		return;
+
+	m_metrics->latency[(size_t)m_op]->record(std::chrono::steady_clock::now() - m_start);
+	rocksdb::PerfContext const * perf(rocksdb::get_perf_context());
+	rocksdb::IOStatsContext const * iostats(rocksdb::get_iostats_context());
+	m_metrics->samples.add();
+	m_metrics->block_reads.add(perf->block_read_count);
+	m_metrics->block_read_bytes.add(perf->block_read_byte);
+	m_metrics->block_cache_hits.add(perf->block_cache_hit_count);
+	m_metrics->memtable_hits.add(perf->get_from_memtable_count);
+	m_metrics->file_read_bytes.add(iostats->bytes_read);
+	if (perf->block_read_count)
+		m_metrics->block_read_time.record(perf->block_read_time / 1000);
+	rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mcp/common/metrics.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace mcp
+{
+	namespace db
+	{
+		enum class perf_op : uint8_t
+		{
+			get = 0,
+			put = 1,
+			del = 2
+		};
+
+		/// sampled latency and rocksdb perf context of one logical table
+		class table_metrics
+		{
+		public:
+			table_metrics(std::string const & db_a, std::string const & table_a);
+
+			std::string const table;
+			std::array<mcp::metrics::histogram *, 3> latency;
+			mcp::metrics::counter & samples;
+			mcp::metrics::counter & block_reads;
+			mcp::metrics::counter & block_read_bytes;
+			mcp::metrics::counter & block_cache_hits;
+			mcp::metrics::counter & memtable_hits;
+			mcp::metrics::counter & file_read_bytes;
+			mcp::metrics::histogram & block_read_time;
+		};
+
+		/// Captures rocksdb perf and io stats context of one in database_config::perf_sample operations
+		/// of the calling thread, over the lifetime of the guard. Does nothing if sampling is off.
+		class perf_sample
+		{
+		public:
+			perf_sample(std::shared_ptr<table_metrics> const & metrics_a, perf_op const & op_a);
+			~perf_sample();
+
+		private:
+			/// nullptr if this operation is not sampled
+			table_metrics * m_metrics;
+			perf_op m_op;
+			std::chrono::steady_clock::time_point m_start;
+		};
+	}
+}
@@ -258,6 +258,8 @@ namespace mcp
 				std::swap(works, m_unverified);
 			}
 
+			batchVerify(works);
+
 			while (!works.empty())
 			{
 				UnverifiedApprove work = std::move(works.front());
@@ -292,15 +294,9 @@ namespace mcp
 
 		mcp::db::db_transaction transaction(m_store.create_transaction());
 		mcp::block_hash hash;
-		if (_approve->epoch() <= 1) {
-			hash = mcp::genesis::block_hash;
-		}
-		else {
-			bool ret = m_store.main_chain_get(transaction, (_approve->epoch() - 1)*epoch_period, hash);
-			if (ret) {
-				LOG(m_log.debug) << "[validateApprove] epoch is too high";
-				return ImportResult::EpochIsTooHigh;
-			}
+		if (!vrfMessage(transaction, _approve->epoch(), hash)) {
+			LOG(m_log.debug) << "[validateApprove] epoch is too high";
+			return ImportResult::EpochIsTooHigh;
 		}
 		_approve->vrf_verify(hash);
 		if (m_chain->last_stable_epoch() < _approve->epoch()) ///have no staking list of this epoch
@@ -319,6 +315,42 @@ namespace mcp
 		return ImportResult::Success;
 	}
 
+	bool ApproveQueue::vrfMessage(mcp::db::db_transaction & _transaction, Epoch _epoch, mcp::block_hash & _hash)
+	{
+		if (_epoch <= 1) {
+			_hash = mcp::genesis::block_hash;
+			return true;
+		}
+		return !m_store.main_chain_get(_transaction, (_epoch - 1)*epoch_period, _hash);
+	}
+
+	void ApproveQueue::batchVerify(std::deque<UnverifiedApprove> const& _works)
+	{
+		try
+		{
+			std::vector<std::shared_ptr<approve>> approves;
+			std::vector<mcp::block_hash> msgs;
+			mcp::db::db_transaction transaction(m_store.create_transaction());
+			for (auto const& work : _works)
+			{
+				if (work.in == source::request || work.in == source::sync)///approve liked,not checked by import
+					continue;
+				mcp::block_hash hash;
+				if (!vrfMessage(transaction, work.ap->epoch(), hash))
+					continue;
+				approves.push_back(work.ap);
+				msgs.push_back(hash);
+			}
+			if (approves.size() > 1)
+				approve::vrf_verify_batch(approves, msgs);
+		}
+		catch (...)
+		{
+			/// only a shortcut, import verifies every approve again
+			LOG(m_log.debug) << "Batch verify approves failed:" << boost::current_exception_diagnostic_information();
+		}
+	}
+
 	std::string ApproveQueue::getInfo()
 	{
 		UpgradableGuard l(m_lock);
@@ -76,7 +76,7 @@ namespace mcp
 		{
 			UnverifiedApprove() {}
 			UnverifiedApprove(std::shared_ptr<approve> _p, p2p::node_id const& _nodeId, source _in) : ap(_p), nodeId(std::move(_nodeId)), in(std::move(_in)) {}
-			UnverifiedApprove(UnverifiedApprove&& _p) : ap(std::move(_p.ap)), nodeId(std::move(_p.nodeId)) {}
+			UnverifiedApprove(UnverifiedApprove&& _p) : ap(std::move(_p.ap)), in(std::move(_p.in)), nodeId(std::move(_p.nodeId)) {}
 			UnverifiedApprove& operator=(UnverifiedApprove&& _other)
 			{
 				assert(&_other != this);
@@ -102,6 +102,10 @@ namespace mcp
 
 		void validateApprove(std::shared_ptr<approve> _approve);
 		ImportResult checkApprove(std::shared_ptr<approve> _approve, source _in);/// epoch check
+		/// main chain block hash proved by approves of @a _epoch, false if the epoch is too high
+		bool vrfMessage(mcp::db::db_transaction & _transaction, Epoch _epoch, mcp::block_hash & _hash);
+		/// verify the proofs of the works import will check in one batch, outside of m_lock
+		void batchVerify(std::deque<UnverifiedApprove> const& _works);
 
 		mutable SharedMutex m_lock;  ///< General lock.
 		h256Hash m_known;            ///< Headers of transactions in both sets.
@@ -8,6 +8,9 @@ constexpr uint32_t tx_timeout_ms = 1000;
 constexpr unsigned max_mt_count = 16;
 constexpr unsigned max_pending_size = 5000;
 constexpr unsigned max_local_processing_size = 100;
+/// recent stable blocks stay in the database
+constexpr uint64_t archive_lag = 1000;
+constexpr size_t archive_batch_size = 1000;
 
 mcp::late_message_info::late_message_info(std::shared_ptr<mcp::block_processor_item> item_a) :
 	item(item_a),
@@ -108,12 +111,17 @@ mcp::block_processor::block_processor(bool & error_a,
 
 	m_tq->onReady([this](h256 const& _h) { onTransactionReady(_h); });
 	m_aq->onReady([this](h256 const& _h) { onApproveImported(_h); });
+}
 
+void mcp::block_processor::start()
+{
 	m_mt_process_block_thread = std::thread([this]() { this->mt_process_blocks(); });
 	m_process_block_thread = std::thread([this]() { this->process_blocks(); });
 	m_ready_hashs_thread = std::thread([this]() { this->process_ready_func(); });
 
 	ongoing_retry_late_message();
+	if (mcp::db::database_config::archive)
+		m_archive_thread = std::thread([this]() { this->ongoing_archive(); });
 }
 
 mcp::block_processor::~block_processor()
@@ -144,12 +152,30 @@ void mcp::block_processor::stop()
 		m_ready_hashs_condition.notify_all();
 	}
 
+	{
+		std::lock_guard<std::mutex> lock(m_archive_mutex);
+		m_archive_condition.notify_all();
+	}
+
 	if (m_mt_process_block_thread.joinable())
 		m_mt_process_block_thread.join();
 	if (m_process_block_thread.joinable())
 		m_process_block_thread.join();
 	if (m_ready_hashs_thread.joinable())
 		m_ready_hashs_thread.join();
+	if (m_archive_thread.joinable())
+		m_archive_thread.join();
+
+	try
+	{
+		mcp::db::db_transaction transaction(m_store.create_transaction());
+		m_cache->save_hot_blocks(transaction);
+		transaction.commit();
+	}
+	catch (std::exception const & e)
+	{
+		LOG(m_log.error) << "Save hot blocks error: " << e.what();
+	}
 }
 
 bool mcp::block_processor::is_full()
@@ -388,6 +414,26 @@ void mcp::block_processor::add_to_process(std::shared_ptr<mcp::block_processor_i
 	m_process_condition.notify_all();
 }
 
+void mcp::block_processor::add_to_process_front(std::vector<std::shared_ptr<mcp::block_processor_item>> const & items_a)
+{
+	/// released from unhandle, they went through add_to_process before and a catchup was requested then if needed.
+	/// Keep their topological order, local items go back to the local queue
+	std::vector<std::shared_ptr<mcp::block_processor_item>> remote;
+	std::vector<std::shared_ptr<mcp::block_processor_item>> local;
+	for (auto const & item : items_a)
+	{
+		if (item->is_local())
+			local.push_back(item);
+		else
+			remote.push_back(item);
+	}
+
+	std::lock_guard<std::mutex> lock(m_process_mutex);
+	m_blocks_pending.insert(m_blocks_pending.begin(), remote.begin(), remote.end());
+	m_local_blocks_pending.insert(m_local_blocks_pending.begin(), local.begin(), local.end());
+	m_process_condition.notify_all();
+}
+
 void mcp::block_processor::process_blocks()
 {
 	//try to do advance first
@@ -698,7 +744,10 @@ void mcp::block_processor::do_process_dag_item(mcp::timeout_db_transaction & tim
 
 void mcp::block_processor::process_missing(std::shared_ptr<mcp::block_processor_item> item_a, std::unordered_set<mcp::block_hash> const & missings, h256Hash const & transactions, h256Hash const & approves)
 {
-	unhandle_add_result r(unhandle->add(item_a, missings, transactions, approves));
+	std::vector<std::shared_ptr<mcp::block_processor_item>> ready_items;
+	unhandle_add_result r(unhandle->add(item_a, missings, transactions, approves, ready_items));
+	if (!ready_items.empty())
+		add_to_process_front(ready_items);
 	/// if the block links too much,request_catchup exec before this function, modify_syncing status, ensures that the block's missing transactions are requested.
 	if (m_sync->is_syncing())
 		return;
@@ -735,7 +784,7 @@ void mcp::block_processor::process_missing(std::shared_ptr<mcp::block_processor_
 	}
 	else if (r == unhandle_add_result::Retry)
 	{
-		m_blocks_pending.push_front(item_a);
+		add_to_process_front({ item_a });
 	}
 }
 
@@ -794,16 +843,9 @@ void mcp::block_processor::process_existing_missing(mcp::p2p::node_id const & re
 
 void mcp::block_processor::try_process_unhandle(std::shared_ptr<mcp::block_processor_item> item_a)
 {
-	std::unordered_set<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_dependency(item_a->block_hash);
+	std::vector<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_dependency(item_a->block_hash);
 	if (!unhandle_items.empty())
-	{
-		std::lock_guard<std::mutex> lock(m_process_mutex);
-		for (auto const & p : unhandle_items)
-		{
-			std::shared_ptr<mcp::block_processor_item> u_item(p);
-			m_blocks_pending.push_front(u_item);
-		}
-	}
+		add_to_process_front(unhandle_items);
 }
 
 void mcp::block_processor::try_remove_invalid_unhandle(mcp::block_hash const & block_hash_a)
@@ -815,7 +857,7 @@ void mcp::block_processor::try_remove_invalid_unhandle(mcp::block_hash const & b
 		mcp::block_hash const &invalid_hash(invalid_hashs.front());
 		invalid_hashs.pop();
 		InvalidBlockCache.add(invalid_hash);
-		std::unordered_set<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_dependency(invalid_hash);
+		std::vector<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_dependency(invalid_hash);
 		for (auto const &p : unhandle_items)
 		{
 			mcp::block_hash const &i_hash(p->block_hash);
@@ -862,25 +904,15 @@ void mcp::block_processor::process_ready_func()
 
 			if (!ts.empty())
 			{
-				std::unordered_set<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_transaction_dependency(ts);
+				std::vector<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_transaction_dependency(ts);
 				if (!unhandle_items.empty())
-				{
-					for (auto const & p : unhandle_items)
-					{
-						add_to_process(p,true);
-					}
-				}
+					add_to_process_front(unhandle_items);
 			}
 			if (!as.empty())
 			{
-				std::unordered_set<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_approve_dependency(as);
+				std::vector<std::shared_ptr<mcp::block_processor_item>> unhandle_items = unhandle->release_approve_dependency(as);
 				if (!unhandle_items.empty())
-				{
-					for (auto const & p : unhandle_items)
-					{
-						add_to_process(p, true);
-					}
-				}
+					add_to_process_front(unhandle_items);
 			}
 			
 			m_ready_hashs_processing.clear();
@@ -919,7 +951,8 @@ void mcp::block_processor::after_db_commit_event()
 		m_ok_local_promises.pop_front();
 	}
 
-	//m_chain->notify_observers();
+	m_onCommitted();
+	m_chain->notify_observers();
 }
 
 std::string mcp::block_processor::get_processor_info()
@@ -954,4 +987,32 @@ void mcp::block_processor::ongoing_retry_late_message()
 	});
 }
 
+void mcp::block_processor::ongoing_archive()
+{
+	std::unique_lock<std::mutex> lock(m_archive_mutex);
+	while (!m_stopped)
+	{
+		size_t archived(0);
+		uint64_t last_stable_index(m_chain->last_stable_index());
+		/// archived once at the tip, catching up has the disk to itself
+		if (last_stable_index > archive_lag && !mcp::node_sync::is_syncing())
+		{
+			lock.unlock();
+			try
+			{
+				archived = m_store.archive_stable(last_stable_index - archive_lag, archive_batch_size);
+			}
+			catch (std::exception const & e)
+			{
+				LOG(m_log.error) << "Archive stable blocks error: " << e.what();
+			}
+			lock.lock();
+		}
+
+		/// catching up goes on right away
+		if (!m_stopped)
+			m_archive_condition.wait_for(lock, archived ? std::chrono::milliseconds(10) : std::chrono::milliseconds(5000));
+	}
+}
+
 
@@ -72,17 +72,25 @@ namespace mcp
 			boost::asio::io_service &io_service_a, std::shared_ptr<mcp::alarm> alarm_a
 		);
 		~block_processor();
+		/// starts the processing threads. Signals are not thread safe, handlers of onCommitted and of the chain
+		/// and queue signals fired here must all be registered before
+		void start();
 		void stop();
 
 		void add_many_to_mt_process(std::queue<std::shared_ptr<mcp::block_processor_item>> items_a);
 		void add_to_mt_process(std::shared_ptr<mcp::block_processor_item> item_a);
 		void add_to_process(std::shared_ptr<mcp::block_processor_item> item_a, bool ready = false);
+		/// ready blocks, processed next in the given order
+		void add_to_process_front(std::vector<std::shared_ptr<mcp::block_processor_item>> const & items_a);
 		
 		void on_sync_completed(mcp::p2p::node_id const & remote_node_id_a);
 
 		/// Register a handler that will be called once asynchronous verification is comeplte an block has been imported
 		void onImport(std::function<void(ImportResult, p2p::node_id const&)> const& _t) { m_onImport.add(_t); }
 
+		/// Register a handler that will be called after blocks are committed, the dag tips may have changed
+		void onCommitted(std::function<void()> const& _t) { m_onCommitted.add(_t); }
+
 		void onTransactionReady(h256 const& _t);
 
 		void onApproveImported(h256 const& _t);
@@ -112,6 +120,8 @@ namespace mcp
 		void after_db_commit_event();
 
 		void ongoing_retry_late_message();
+		/// moves old stable blocks to the archive on its own thread, archiving syncs files and must not hold up the alarm
+		void ongoing_archive();
 
 		mcp::block_store m_store;
 		std::shared_ptr<mcp::block_cache> m_cache;
@@ -154,9 +164,14 @@ namespace mcp
 		void process_ready_func();
 
 		Signal<ImportResult, p2p::node_id const&> m_onImport;			///< Called for each import attempt. Arguments are result.
+		Signal<> m_onCommitted;			///< Called after each commit of processed blocks.
 
 		std::thread m_process_block_thread;
 
+		std::mutex m_archive_mutex;
+		std::condition_variable m_archive_condition;
+		std::thread m_archive_thread;
+
 		std::deque<std::shared_ptr<std::promise<mcp::validate_status>>> m_ok_local_promises;
 		std::chrono::time_point<std::chrono::steady_clock> m_last_request_unknown_missing_time;
 
@@ -2,6 +2,7 @@
 #include <mcp/core/genesis.hpp>
 #include <mcp/core/param.hpp>
 #include <mcp/common/stopwatch.hpp>
+#include <mcp/common/metrics.hpp>
 #include <mcp/common/Exceptions.h>
 #include <mcp/node/debug.hpp>
 #include <mcp/node/evm/Executive.hpp>
@@ -14,6 +15,13 @@
 
 #include <queue>
 
+namespace
+{
+	mcp::metrics::histogram advance_stable_mci_latency("mcp_chain_advance_stable_mci_seconds", "time to stabilize one main chain index");
+	mcp::metrics::counter stable_blocks("mcp_chain_stable_blocks_total", "blocks set stable");
+	mcp::metrics::histogram execution_latency("mcp_transaction_execution_seconds", "time to execute one transaction, including calls and gas estimation");
+}
+
 mcp::chain::chain(mcp::block_store& store_a, std::shared_ptr<mcp::block_cache> cache_a) :
 	m_store(store_a),
 	m_cache(cache_a),
@@ -42,8 +50,7 @@ void mcp::chain::init(bool & error_a, mcp::timeout_db_transaction & timeout_tx_a
 				precompiled_accounts[acc] = std::make_shared<mcp::account_state>(acc, h256(0), h256(0), 0, 0);
 			}
 
-			mcp::overlay_db db(transaction, m_store);
-			mcp::commit(transaction, precompiled_accounts, &db, cache_a, m_store, h256(0));
+			mcp::genesis::put_accounts(transaction, m_store, precompiled_accounts, h256(0));
 
 			///init system contract
 			auto gstate = m_store.block_state_get(transaction, mcp::genesis::block_hash);
@@ -104,8 +111,8 @@ void mcp::chain::init(bool & error_a, mcp::timeout_db_transaction & timeout_tx_a
 
 	m_last_stable_index_internal = m_store.last_stable_index_get(transaction);
 	m_advance_info = m_store.advance_info_get(transaction);
-	init_vrf_outputs(transaction);
-	InitWork(transaction, cache_a);
+	init_warm_state(transaction, cache_a);
+	block_cache_a->load_hot_blocks(transaction);
 	m_last_stable_epoch = mcp::epoch(m_last_stable_mci_internal);
 
 	update_cache();
@@ -180,7 +187,7 @@ void mcp::chain::save_dag_block(mcp::timeout_db_transaction & timeout_tx_a, std:
 				m_store.advance_info_put(transaction, m_advance_info);
 			}
 
-			//m_new_blocks.push(block_a);
+			m_new_blocks.push(block_a);
 		}
 		catch (std::exception const & e)
 		{
@@ -305,6 +312,33 @@ void mcp::chain::UpdateCommittee(mcp::timeout_db_transaction & timeout_tx_a, Epo
 	}
 	mcp::param::add_witness_param(transaction_a, useepoch, p_param);
 	vrf_outputs.erase(vrfepoch);
+	m_store.epoch_vrf_outputs_del(transaction_a, vrfepoch);
+}
+
+void mcp::chain::init_warm_state(mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::process_block_cache> cache_a)
+{
+	if (m_store.warm_state_exists(transaction_a))
+	{
+		m_store.epoch_vrf_outputs_get(transaction_a, vrf_outputs);
+		std::map<dev::Address, std::pair<int, int>> statistics;
+		m_store.work_statistics_get(transaction_a, statistics);
+		for (auto const& it : statistics)
+			m_statistics.Set(it.first, it.second.first, it.second.second);
+		LOG(m_log.info) << "Warm state loaded, vrf output epochs:" << vrf_outputs.size() << " ,witness statistics:" << statistics.size();
+		return;
+	}
+
+	/// first start of this database, rebuild once and keep it in step with the chain from now on
+	init_vrf_outputs(transaction_a);
+	InitWork(transaction_a, cache_a);
+	for (auto const& epoch_outputs : vrf_outputs)
+	{
+		for (auto const& output : epoch_outputs.second)
+			m_store.epoch_vrf_output_put(transaction_a, epoch_outputs.first, output.first, output.second);
+	}
+	for (auto const& it : m_statistics.values())
+		m_store.work_statistics_put(transaction_a, it.first, it.second.OnMci, it.second.NotOnMci);
+	m_store.warm_state_put(transaction_a);
 }
 
 void mcp::chain::init_vrf_outputs(mcp::db::db_transaction & transaction_a)
@@ -409,6 +443,8 @@ void mcp::chain::ApplyWorkTransaction(mcp::timeout_db_transaction & timeout_tx_a
 		_v.insert(std::make_pair(it.first, a * precision));
 	}
 
+	for (auto const& it : m_statistics.values())
+		m_store.work_statistics_del(transaction_a, it.first);
 	m_statistics.clear();
 
 	dev::eth::McInfo mc_info = GetMcInfo(timeout_tx_a, cache_a, mci);
@@ -853,6 +889,7 @@ void mcp::chain::update_latest_included_mci(mcp::db::db_transaction & transactio
 
 void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a, std::shared_ptr<mcp::process_block_cache> cache_a, uint64_t const &mci, mcp::block_hash const & block_hash_a)
 {
+	mcp::metrics::timer_guard tg(advance_stable_mci_latency);
 	mcp::db::db_transaction & transaction_a(timeout_tx_a.get_transaction());
 
 	mcp::block_hash mc_stable_hash;
@@ -887,6 +924,7 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 
 			m_last_stable_index_internal++;
 			std::vector<bytes> receipts;
+			std::vector<uint32_t> executed_links;
 			{
 				//mcp::stopwatch_guard sw("advance_stable_mci2_1");
 
@@ -970,6 +1008,7 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 
 					std::shared_ptr<mcp::TransactionAddress> td(std::make_shared<mcp::TransactionAddress>(dag_stable_block_hash, index));
 					cache_a->transaction_address_put(transaction_a, link_hash, td);
+					executed_links.push_back(i);
 					/// exec transaction can reduce, if two or more block linked a transaction,reduce once.
 					m_store.transaction_unstable_count_reduce(transaction_a);
 					index++;
@@ -977,6 +1016,34 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 
 				///handle approve stable block 
 				auto approves(dag_stable_block->approves());
+				std::vector<std::shared_ptr<mcp::approve>> aps(approves.size());
+				std::vector<mcp::block_hash> vrf_msgs(approves.size());
+				{
+					/// reboot system. approves read from db have no cached outputs, verify them in one batch
+					std::vector<std::shared_ptr<mcp::approve>> unverified;
+					std::vector<mcp::block_hash> unverified_msgs;
+					for (auto i = 0; i < approves.size(); i++)
+					{
+						if (cache_a->approve_receipt_get(transaction_a, approves[i]))
+							continue;
+						aps[i] = cache_a->approve_get(transaction_a, approves[i]);
+						assert_x(aps[i]);
+						if (aps[i]->outputs() != h256(0))
+							continue;
+						if (aps[i]->epoch() <= 1) {
+							vrf_msgs[i] = mcp::genesis::block_hash;
+						}
+						else {
+							bool exists(!m_store.main_chain_get(transaction_a, (aps[i]->epoch() - 1)*epoch_period, vrf_msgs[i]));
+							assert_x(exists);
+						}
+						unverified.push_back(aps[i]);
+						unverified_msgs.push_back(vrf_msgs[i]);
+					}
+					if (unverified.size() > 1)
+						mcp::approve::vrf_verify_batch(unverified, unverified_msgs);
+				}
+
 				for (auto i = 0; i < approves.size(); i++)
 				{
 					h256 const& approve_hash = approves[i];
@@ -990,8 +1057,7 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 						continue;
 					}
 
-					auto ap = cache_a->approve_get(transaction_a, approve_hash);
-					assert_x(ap);
+					auto ap = aps[i];
 					/// exec approves
 					try{
 						/// exec approve can reduce, if two or more block linked a approve,reduce once.
@@ -1000,15 +1066,7 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 
 						if (ap->outputs() == h256(0))/// reboot system. approve read from db,but not cache outputs
 						{
-							mcp::block_hash hash;
-							if (ap->epoch() <= 1) {
-								hash = mcp::genesis::block_hash;
-							}
-							else {
-								bool exists(!m_store.main_chain_get(transaction_a, (ap->epoch() - 1)*epoch_period, hash));
-								assert_x(exists);
-							}
-							ap->vrf_verify(hash);///cached outputs.must successed.
+							ap->vrf_verify(vrf_msgs[i]);///cached outputs.must successed.
 						}
 						bool apStatus = false;
 						if (IsStakingList(transaction_a, ap->epoch(), ap->sender()))///staking completed.
@@ -1023,6 +1081,7 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 						if (ap->epoch() == epoch(mci) && apStatus)
 						{
 							vrf_outputs[ap->epoch()].insert(std::make_pair(ap->outputs(), *preceipt));
+							m_store.epoch_vrf_output_put(transaction_a, ap->epoch(), ap->outputs(), *preceipt);
 						}
 
 						RLPStream receiptRLP;
@@ -1041,7 +1100,7 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 			{
 				h256 receiptsRoot = dev::orderedTrieRoot(receipts);
 				//mcp::stopwatch_guard sw("advance_stable_mci2_2");
-				set_block_stable(timeout_tx_a, cache_a, dag_stable_block_hash, mci, mc_timestamp, mc_last_summary_mci, stable_timestamp, m_last_stable_index_internal, receiptsRoot);
+				set_block_stable(timeout_tx_a, cache_a, dag_stable_block_hash, mci, mc_timestamp, mc_last_summary_mci, stable_timestamp, m_last_stable_index_internal, receiptsRoot, executed_links);
 			}
 		}
 	}
@@ -1049,8 +1108,9 @@ void mcp::chain::advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a,
 
 void mcp::chain::set_block_stable(mcp::timeout_db_transaction & timeout_tx_a, std::shared_ptr<mcp::process_block_cache> cache_a, mcp::block_hash const & stable_block_hash, 
 	uint64_t const & mci, uint64_t const & mc_timestamp, uint64_t const & mc_last_summary_mci, 
-	uint64_t const & stable_timestamp, uint64_t const & stable_index, h256 receiptsRoot)
+	uint64_t const & stable_timestamp, uint64_t const & stable_index, h256 receiptsRoot, std::vector<uint32_t> const & executed_links)
 {
+	stable_blocks.add();
 	mcp::db::db_transaction & transaction_a(timeout_tx_a.get_transaction());
 	try
 	{
@@ -1177,14 +1237,28 @@ void mcp::chain::set_block_stable(mcp::timeout_db_transaction & timeout_tx_a, st
 			m_store.summary_block_put(transaction_a, summary_hash, stable_block_hash);
 			m_store.PutBlockReceiptsRoot(transaction_a, stable_block_hash, receiptsRoot);
 
+			///range readers scan these in stable index order instead of point reads per block
+			mcp::stable_block_bundle bundle;
+			bundle.block = stable_block;
+			bundle.state = *stable_block_state_copy;
+			bundle.summary = summary_hash;
+			bundle.previous_summary = previous_summary_hash;
+			bundle.parent_summaries = p_summary_hashs;
+			bundle.receipts_root = receiptsRoot;
+			bundle.skiplist = block_skiplist;
+			bundle.skiplist_summaries = summary_skiplist;
+			bundle.executed_links = executed_links;
+			m_store.stable_block_bundle_put(transaction_a, stable_index, bundle);
+
 #pragma endregion
 
 			///Statistical witness block
 			///if fork, this block was sent much later than the other nodes, invalid.
-			m_statistics.Insert(stable_block->from(), stable_block_state_copy->is_on_main_chain);
+			auto const& details = m_statistics.Insert(stable_block->from(), stable_block_state_copy->is_on_main_chain);
+			m_store.work_statistics_put(transaction_a, stable_block->from(), details.OnMci, details.NotOnMci);
 		}
 
-		//m_stable_blocks.push(stable_block);
+		m_stable_blocks.push(stable_block);
 	}
 	catch (std::exception const & e)
 	{
@@ -1316,27 +1390,30 @@ mcp::Epoch mcp::chain::last_stable_epoch()
 //		return false;
 //}
 
-//void mcp::chain::notify_observers()
+void mcp::chain::notify_observers()
+{
+	std::lock_guard<std::mutex> lock(m_observer_mutex);
+	while (!m_new_blocks.empty())
+	{
+		for (auto it = m_new_block_observer.begin(); it != m_new_block_observer.end(); it++)
+		{
+			(*it)(m_new_blocks.front());
+		}
+		m_new_blocks.pop();
+	}
+
+	while (!m_stable_blocks.empty())
+	{
+		for (auto it = m_stable_block_observer.begin(); it != m_stable_block_observer.end(); it++)
+		{
+			(*it)(m_stable_blocks.front());
+		}
+		m_stable_blocks.pop();
+	}
+}
+
+//void mcp::chain::notify_stable_mci_observers()
 //{
-//	while (!m_new_blocks.empty())
-//	{
-//		for (auto it = m_new_block_observer.begin(); it != m_new_block_observer.end(); it++)
-//		{
-//			(*it)(m_new_blocks.front());
-//		}
-//		m_new_blocks.pop();
-//	}
-//
-//
-//	while (!m_stable_blocks.empty())
-//	{
-//		for (auto it = m_stable_block_observer.begin(); it != m_stable_block_observer.end(); it++)
-//		{
-//			(*it)(m_stable_blocks.front());
-//		}
-//		m_stable_blocks.pop();
-//	}
-//
 //	while (!m_stable_mcis.empty())
 //	{
 //		for (auto it = m_stable_mci_observer.begin(); it != m_stable_mci_observer.end(); it++)
@@ -1378,7 +1455,7 @@ std::pair<u256, mcp::ExecutionResult> mcp::chain::estimate_gas(mcp::db::db_trans
 		auto chain_ptr(shared_from_this());
 		chain_state c_state(transaction_a, 0, m_store, chain_ptr, cache_a);
 
-		auto _T([this, c_state, _from, _value, _dest, _data, gasPrice](int64_t const & gas)
+		auto _execute([&c_state, &env, _from, _value, _dest, _data, gasPrice](int64_t const & gas)
 		{
 			u256 n = c_state.getNonce(_from);
 			Transaction t;
@@ -1388,41 +1465,56 @@ std::pair<u256, mcp::ExecutionResult> mcp::chain::estimate_gas(mcp::db::db_trans
 				t = Transaction(_value, gasPrice, gas, _data, n);
 			t.setSignature(h256(0), h256(0), 0);
 			t.forceSender(_from);
-			return t;
+
+			c_state.ts = t;
+			c_state.addBalance(_from, gas * gasPrice + _value);
+			return c_state.execute(env, Permanence::Reverted, t, dev::eth::OnOpFunc()).first;
 		});
 
 		/// return if used lowerBound successed.
-		{
-			Transaction t = _T(lowerBound);
-			c_state.ts = t;
-			c_state.addBalance(_from, lowerBound * gasPrice + _value);
-			er = c_state.execute(env, Permanence::Reverted, t, dev::eth::OnOpFunc()).first;
-			if (er.excepted == TransactionException::None)
-				return std::make_pair(lowerBound, er);
-		}
+		er = _execute(lowerBound);
+		if (er.excepted == TransactionException::None)
+			return std::make_pair(lowerBound, er);
 
 		/// Reject the transaction as invalid if it still fails at the highest allowance
+		er = _execute(upperBound);
+		/// If the error is not nil(consensus error), it means the provided message
+		/// call or transaction will never be accepted no matter how much gas it is
+		/// assigned. Return the error directly, don't struggle any more.
+		if (er.excepted != TransactionException::None)
+			return std::make_pair(u256(), er);
+
+		/// The execution at the highest allowance tells what the gas limit has to cover: the gas used before
+		/// refunds (refunds are capped at half of it) and the slack calls need under the 63/64 rule.
+		/// Try that first, then once more with a call stipend of margin, and bisect only if both fail.
+		int64_t used = static_cast<int64_t>(er.gasUsed + std::min(er.gasRefunded, er.gasUsed));
+		int64_t hinted = used + static_cast<int64_t>(er.gasCallSlack);
+		lowerBound = std::max(lowerBound, used - 1);
+		for (int64_t candidate : { hinted, hinted + hinted / 63 + (int64_t)dev::eth::EVMSchedule().callStipend })
 		{
-			Transaction t = _T(upperBound);
-			c_state.ts = t;
-			c_state.addBalance(_from, upperBound * gasPrice + _value);
-			er = c_state.execute(env, Permanence::Reverted, t, dev::eth::OnOpFunc()).first;
-			/// If the error is not nil(consensus error), it means the provided message
-			/// call or transaction will never be accepted no matter how much gas it is
-			/// assigned. Return the error directly, don't struggle any more.
-
-			if (er.excepted != TransactionException::None)
-				return std::make_pair(u256(), er);
+			if (candidate <= lowerBound || candidate >= upperBound)
+				continue;
+
+			ExecutionResult result = _execute(candidate);
+			if (result.excepted == TransactionException::None)
+			{
+				lowerBound = candidate - 1;
+				upperBound = candidate;
+				er = result;
+			}
+			else
+				lowerBound = candidate;
+			if (_callback)
+				_callback(GasEstimationProgress{ lowerBound, upperBound });
+			if (lowerBound + 1 == upperBound)
+				break;
 		}
+
 		/// Execute the binary search and hone in on an executable gas limit
 		while (lowerBound + 1 < upperBound)
 		{
 			int64_t mid = (lowerBound + upperBound) / 2;
-			Transaction t = _T(mid);
-			c_state.ts = t;
-			c_state.addBalance(_from, mid * gasPrice + _value);
-
-			ExecutionResult result = c_state.execute(env, Permanence::Reverted, t, dev::eth::OnOpFunc()).first;
+			ExecutionResult result = _execute(mid);
 			if (result.excepted != TransactionException::None
 				/*|| result.codeDeposit == CodeDeposit::Failed*/ /// throw exception if failed. not used yet?
 				)
@@ -1460,6 +1552,7 @@ std::pair<u256, mcp::ExecutionResult> mcp::chain::estimate_gas(mcp::db::db_trans
 /// be called other methods except chain::set_block_stable
 std::pair<mcp::ExecutionResult, dev::eth::TransactionReceipt> mcp::chain::execute(mcp::db::db_transaction& transaction_a, std::shared_ptr<mcp::iblock_cache> cache_a, Transaction const& _t, dev::eth::McInfo const & mc_info_a, Permanence _p, dev::eth::OnOpFunc const& _onOp)
 {
+	mcp::metrics::timer_guard tg(execution_latency);
 	dev::eth::EnvInfo env(transaction_a, m_store, cache_a, mc_info_a, mcp::chainID());
 	/// sichaoy: startNonce = 0
 	auto chain_ptr(shared_from_this());
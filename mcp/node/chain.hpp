@@ -7,6 +7,8 @@
 #include <memory>
 #include <set>
 #include <queue>
+#include <list>
+#include <mutex>
 #include <mcp/node/chain_state.hpp>
 #include <mcp/node/sync.hpp>
 #include <mcp/core/approve_receipt.hpp>
@@ -28,7 +30,7 @@ namespace mcp
 			int NotOnMci = 0;
 		};
 	public:
-		void Insert(dev::Address const& _a, bool const& _onMci)
+		Details const& Insert(dev::Address const& _a, bool const& _onMci)
 		{
 			if (!m.count(_a))
 				m[_a] = Details();
@@ -37,6 +39,12 @@ namespace mcp
 				m[_a].OnMci++;
 			else
 				m[_a].NotOnMci++;
+			return m[_a];
+		}
+		void Set(dev::Address const& _a, int const& _onMci, int const& _notOnMci)
+		{
+			m[_a].OnMci = _onMci;
+			m[_a].NotOnMci = _notOnMci;
 		}
 		std::map<dev::Address, Details> values()
 		{
@@ -96,18 +104,22 @@ namespace mcp
 			return m_precompiled.at(account_a).execute(in_a);
 		}
 
-		//void notify_observers();
+		/// called after each commit of the block processor, blocks saved or stabilized by the commit are passed to the observers
+		void notify_observers();
 
 		std::vector<uint64_t> cal_skip_list_mcis(uint64_t const &);
 
-		//void set_ws_new_block_func(std::function<void(std::shared_ptr<mcp::block>)> new_block_observer_a)
-		//{
-		//	m_new_block_observer.push_back(new_block_observer_a);
-		//}
-		//void set_ws_stable_block_func(std::function<void(std::shared_ptr<mcp::block>)> stable_block_observer_a)
-		//{
-		//	m_stable_block_observer.push_back(stable_block_observer_a);
-		//}
+		/// observers run on the block processor thread and must not block, callable any time
+		void set_ws_new_block_func(std::function<void(std::shared_ptr<mcp::block>)> new_block_observer_a)
+		{
+			std::lock_guard<std::mutex> lock(m_observer_mutex);
+			m_new_block_observer.push_back(new_block_observer_a);
+		}
+		void set_ws_stable_block_func(std::function<void(std::shared_ptr<mcp::block>)> stable_block_observer_a)
+		{
+			std::lock_guard<std::mutex> lock(m_observer_mutex);
+			m_stable_block_observer.push_back(stable_block_observer_a);
+		}
 		//void set_ws_stable_mci_func(std::function<void(uint64_t const&)> stable_mci_observer_a)
 		//{
 		//	m_stable_mci_observer.push_back(stable_mci_observer_a);
@@ -124,10 +136,11 @@ namespace mcp
 		void update_mci(mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::process_block_cache> cache_a, std::shared_ptr<mcp::block> block_a, uint64_t const & retreat_mci, std::list<mcp::block_hash> const & new_mc_block_hashs);
 		void update_latest_included_mci(mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::process_block_cache> cache_a, std::shared_ptr<mcp::block> block_a, bool const &is_mci_retreat, uint64_t const & retreat_mci, uint64_t const &retreat_level);
 		void advance_stable_mci(mcp::timeout_db_transaction & timeout_tx_a, std::shared_ptr<mcp::process_block_cache> cache_a, uint64_t const & mci, mcp::block_hash const & block_hash_a);
-		void set_block_stable(mcp::timeout_db_transaction & timeout_tx_a, std::shared_ptr<mcp::process_block_cache> cache_a, mcp::block_hash const & stable_block_hash, uint64_t const & mci, uint64_t const & mc_timestamp, uint64_t const & mc_last_summary_mci, uint64_t const & stable_timestamp, uint64_t const & stable_index, h256 receiptsRoot);
+		void set_block_stable(mcp::timeout_db_transaction & timeout_tx_a, std::shared_ptr<mcp::process_block_cache> cache_a, mcp::block_hash const & stable_block_hash, uint64_t const & mci, uint64_t const & mc_timestamp, uint64_t const & mc_last_summary_mci, uint64_t const & stable_timestamp, uint64_t const & stable_index, h256 receiptsRoot, std::vector<uint32_t> const & executed_links);
 		void search_stable_block(mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::process_block_cache> cache_a, mcp::block_hash const & block_hash, uint64_t const & mci, std::map<uint64_t, std::set<mcp::block_hash>>& stable_block_hashs);
 		void UpdateCommittee(mcp::timeout_db_transaction & timeout_tx_a, Epoch const& epoch);
 		void init_vrf_outputs(mcp::db::db_transaction & transaction_a);
+		void init_warm_state(mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::process_block_cache> cache_a);
 		dev::eth::McInfo GetMcInfo(mcp::timeout_db_transaction & timeout_tx_a, std::shared_ptr<mcp::process_block_cache> cache_a, uint64_t const &mci);
 		void InitWork(mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::process_block_cache> cache_a);
 		void ApplyWorkTransaction(mcp::timeout_db_transaction & timeout_tx_a, std::shared_ptr<mcp::process_block_cache> cache_a, Epoch const& epoch, uint64_t const &mci, mcp::block_hash const& hash);
@@ -139,10 +152,12 @@ namespace mcp
 		mcp::block_store m_store;
 		std::shared_ptr<mcp::block_cache> m_cache;
 		std::shared_ptr<mcp::TransactionQueue> m_tq;
-		//std::list<std::function<void(std::shared_ptr<mcp::block>)> > m_new_block_observer;
-		//std::queue<std::shared_ptr<mcp::block>> m_new_blocks;
-		//std::list<std::function<void(std::shared_ptr<mcp::block>)> > m_stable_block_observer;
-		//std::queue<std::shared_ptr<mcp::block>> m_stable_blocks;
+		std::mutex m_observer_mutex;
+		std::list<std::function<void(std::shared_ptr<mcp::block>)> > m_new_block_observer;
+		std::list<std::function<void(std::shared_ptr<mcp::block>)> > m_stable_block_observer;
+		/// written on the block processor thread, notified once committed
+		std::queue<std::shared_ptr<mcp::block>> m_new_blocks;
+		std::queue<std::shared_ptr<mcp::block>> m_stable_blocks;
 		//std::list<std::function<void(uint64_t const&)> > m_stable_mci_observer;
 		//std::queue<uint64_t> m_stable_mcis;
 
@@ -1,6 +1,7 @@
 #include "chain_state.hpp"
 #include <mcp/node/evm/Executive.hpp>
 #include <mcp/common/Exceptions.h>
+#include <mcp/common/code_cache.hpp>
 #include <mcp/common/stopwatch.hpp>
 
 mcp::chain_state::chain_state(mcp::db::db_transaction& transaction_a, u256 const& _accountStartNonce, mcp::block_store& store_a,
@@ -398,9 +399,15 @@ dev::bytes const& mcp::chain_state::code(Address const& _addr) const
 
     if (a->code().empty())
     {
-        // Load the code from the backend.
+        // Load the code from the shared code cache, or from the backend.
 		std::shared_ptr<mcp::account_state> mutableAccount = a;
-        mutableAccount->noteCode(m_db.lookup(a->codeHash()));
+		mcp::code_cache::code_ptr shared_code(mcp::code_cache::instance().get(a->codeHash()));
+		if (!shared_code)
+		{
+			shared_code = std::make_shared<dev::bytes const>(dev::asBytes(m_db.lookup(a->codeHash())));
+			mcp::code_cache::instance().put(a->codeHash(), shared_code);
+		}
+        mutableAccount->noteCode(shared_code);
         CodeSizeCache::instance().store(a->codeHash(), a->code().size());
     }
 
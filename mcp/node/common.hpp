@@ -25,7 +25,9 @@ namespace mcp
 		hello_info, //12
 		hello_info_request, //13
 		hello_info_ack, //14
-		packet_count = 0x10
+		transaction_hashes, //15
+		transactions_request, //16
+		packet_count = 0x20
 	};
 
 	class requesting_item
@@ -71,6 +73,9 @@ namespace mcp
 		uint64_t  send_transaction = 0;
 		uint64_t  transaction = 0;
 
+		uint64_t  transaction_hashes = 0;	/// hash announcement
+		uint64_t  transactions_request = 0;	/// pull announced hashes
+
 		uint64_t  broadcast_approve = 0;
 		uint64_t  approve_request = 0;
 		uint64_t  send_approve = 0;
@@ -22,6 +22,23 @@ mcp::composer::~composer()
 {
 }
 
+std::chrono::milliseconds const mcp::composer::max_stable_wait(100);
+uint64_t const mcp::composer::block_gas_target(20 * mcp::tx_max_gas);
+
+void mcp::composer::on_committed()
+{
+	std::lock_guard<std::mutex> lock(m_committed_mutex);
+	m_committed++;
+	m_committed_condition.notify_all();
+}
+
+void mcp::composer::wait_committed()
+{
+	std::unique_lock<std::mutex> lock(m_committed_mutex);
+	uint64_t committed(m_committed);
+	m_committed_condition.wait_for(lock, max_stable_wait, [this, committed]() { return m_committed != committed; });
+}
+
 std::shared_ptr<mcp::block> mcp::composer::compose_block(dev::Address const & from_a, dev::Secret const& s)
 {
 	mcp::stopwatch_guard sw("compose:compose_block");
@@ -58,7 +75,7 @@ void mcp::composer::pick_parents_and_last_summary_and_wl_block(mcp::db::db_trans
 	{
 		mcp::stopwatch_guard sw("compose:pick_parents2");
 
-		links = m_tq->topTransactions(4096);
+		links = m_tq->topTransactions(4096, block_gas_target);
 	}
 
 	auto snapshot = m_store.create_snapshot();
@@ -90,7 +107,7 @@ void mcp::composer::pick_parents_and_last_summary_and_wl_block(mcp::db::db_trans
 				last_summary_block_state = m_cache->block_state_get(transaction_a, last_summary_block);
 				if (last_summary_block_state && last_summary_block_state->is_stable)
 					break;
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				wait_committed();
 			} while (true);
 
 			break;
@@ -100,7 +117,7 @@ void mcp::composer::pick_parents_and_last_summary_and_wl_block(mcp::db::db_trans
 		if (count % 10 == 0)
 			LOG(m_log.warning) << "composer: last summary not exists, check count:" << count;
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		wait_committed();
 		if (m_stopped)
 		{
 			BOOST_THROW_EXCEPTION(BadComposeBlock()
@@ -6,6 +6,8 @@
 #include "transaction_queue.hpp"
 #include "approve_queue.hpp"
 
+#include <condition_variable>
+
 namespace mcp
 {
 	class composer
@@ -16,6 +18,8 @@ namespace mcp
 		);
 		~composer();
 		std::shared_ptr<mcp::block> compose_block(dev::Address const & from_a, dev::Secret const& s);
+		/// blocks were committed, wakes a compose waiting for its last summary block to be stable
+		void on_committed();
 
 	private:
 		mcp::block_hash get_latest_block(mcp::db::db_transaction &  transaction_a, dev::Address const & account_a);
@@ -28,5 +32,14 @@ namespace mcp
         mcp::log m_log = { mcp::log("node") };
 		void stop() { m_stopped = true; }
 		bool m_stopped = false;
+
+		/// waits at most max_stable_wait for a commit
+		void wait_committed();
+		static std::chrono::milliseconds const max_stable_wait;
+		/// gas the links of one block are filled up to, the protocol limits only the number of links
+		static uint64_t const block_gas_target;
+		std::mutex m_committed_mutex;
+		std::condition_variable m_committed_condition;
+		uint64_t m_committed = 0;
 	};
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <libevm/LegacyVM.h>
 #include <libevm/VMFactory.h>
+#include <libinterpreter/CodeHash.h>
 #include <mcp/common/Exceptions.h>
 #include <mcp/common/stopwatch.hpp>
 
@@ -359,6 +360,8 @@ bool mcp::Executive::go(dev::eth::OnOpFunc const& _onOp)
             }
             else
             {
+                /// contract code runs from the analysis shared by its hash, init code is run once
+                dev::eth::CodeHashScope codeHashScope(&m_ext->code, m_ext->codeHash);
                 m_output = vm->exec(m_gas, *m_ext, _onOp);
 
 				//call trace result 
@@ -468,6 +471,7 @@ bool mcp::Executive::finalize()
         m_res->excepted = m_excepted; // TODO: m_except is used only in ExtVM::call
         m_res->newAddress = m_newAddress;
         m_res->gasRefunded = m_ext ? m_ext->sub.refunds : 0;
+        m_res->gasCallSlack = callGasSlack();
     }
     return (m_excepted == TransactionException::None);
 }
@@ -487,5 +491,10 @@ mcp::uint256_t mcp::Executive::gasUsed() const
     return m_t.gas() - m_gas;
 }
 
+u256 mcp::Executive::callGasSlack() const
+{
+    return m_ext ? m_ext->callGasSlack : 0;
+}
+
 
 mcp::log mcp::Executive::m_log = { mcp::log("vm") };
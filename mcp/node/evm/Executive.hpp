@@ -47,6 +47,9 @@ namespace mcp
         /// @returns gas remaining after the transaction/operation. Valid after the transaction has been executed.
         u256 gas() const { return m_gas; }
 
+        /// @returns gas beyond gasUsed() the calls of this operation need under the 63/64 rule. Valid after go().
+        u256 callGasSlack() const;
+
         /// @returns the new address for the created contract in the CREATE operation.
         Address newAddress() const { return m_newAddress; }
 
@@ -121,18 +121,27 @@ evmc_status_code transactionExceptionToEvmcStatusCode(TransactionException ex) n
     }
 }
 
+/// The slack a caller needs for a callee that used _used gas and needed _slack more for its own calls:
+/// the callee is given at most 63/64 of what the caller holds.
+u256 calleeGasSlack(u256 const& _used, u256 const& _slack)
+{
+    return _slack + (_used + _slack + 62) / 63;
+}
+
 } // anonymous namespace
 
 
 CallResult ExtVM::call(CallParameters& _p)
 {   
     Executive e(m_s, envInfo(), m_s.traces, depth);
+    u256 gas = _p.gas;
     if (!e.call(_p, 1, origin))
     {
         go(depth, e, _p.onOp);
         e.accrueSubState(sub);
     }
     _p.gas = e.gas();
+    callGasSlack = std::max(callGasSlack, calleeGasSlack(gas - e.gas(), e.callGasSlack()));
 
     return {transactionExceptionToEvmcStatusCode(e.getException()), e.takeOutput()};
 }
@@ -155,6 +164,7 @@ void ExtVM::setStore(u256 _n, u256 _v)
 CreateResult ExtVM::create(u256 _endowment, u256& io_gas, bytesConstRef _code, Instruction _op, u256 _salt, OnOpFunc const& _onOp)
 {
     Executive e(m_s, envInfo(), m_s.traces, depth);
+    u256 gas = io_gas;
     bool result = false;
     if (_op == Instruction::CREATE)
         result = e.createOpcode(myAddress, _endowment, 1, io_gas, _code, origin);
@@ -170,6 +180,7 @@ CreateResult ExtVM::create(u256 _endowment, u256& io_gas, bytesConstRef _code, I
         e.accrueSubState(sub);
     }
     io_gas = e.gas();
+    callGasSlack = std::max(callGasSlack, calleeGasSlack(gas - e.gas(), e.callGasSlack()));
     return {transactionExceptionToEvmcStatusCode(e.getException()), e.takeOutput(), e.newAddress()};
 }
 
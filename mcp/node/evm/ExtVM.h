@@ -103,6 +103,9 @@ public:
     /// Hash of a block if within the last 256 blocks, or h256() otherwise.
     h256 blockHash(u256 _number) final;
 
+    /// Gas beyond this frame's own usage that its calls need, because a caller keeps back 1/64 of its gas.
+    u256 callGasSlack = 0;
+
 private:
     EVMSchedule const& initEvmSchedule(int64_t _mci, u256 const& _version) const
     {
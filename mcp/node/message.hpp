@@ -138,6 +138,26 @@ public:
 	h256 hash;
 };
 
+/// used by transaction_hashes (announce) and transactions_request (pull)
+class transaction_hashes_message
+{
+public:
+	transaction_hashes_message() = default;
+	transaction_hashes_message(h256s const& _hashes) :hashes(_hashes) {}
+	transaction_hashes_message(bool &error_a, dev::RLP const &r)
+	{
+		error_a = !r.isList() || r.itemCount() > max_hashes;
+		if (error_a)
+			return;
+		for (auto const& h : r)
+			hashes.push_back((h256)h);
+	}
+	void stream_RLP(dev::RLPStream &s) const { s.appendList(hashes.size()); for (auto const& h : hashes) s << h; }
+
+	static constexpr size_t max_hashes = 256;
+	h256s hashes;
+};
+
 class approve_request_message
 {
 public:
@@ -1,7 +1,10 @@
 #include "node_capability.hpp"
 #include "requesting.hpp"
 #include "arrival.hpp"
+#include <algorithm>
+#include <unordered_set>
 #include <fstream>
+#include <cmath>
 
 mcp::node_capability::node_capability(
 	boost::asio::io_service& io_service_a, mcp::block_store& store_a,
@@ -21,6 +24,7 @@ mcp::node_capability::node_capability(
     m_genesis(0)
 {
 	m_request_timer = std::make_unique<ba::deadline_timer>(m_io_service);
+	m_announce_timer = std::make_unique<ba::deadline_timer>(m_io_service);
 	m_tq->onImport([this](ImportResult _ir, p2p::node_id const& _nodeId) { onTransactionImported(_ir, _nodeId); });
 	m_aq->onImport([this](ImportResult _ir, p2p::node_id const& _nodeId) { onTransactionImported(_ir, _nodeId); });
 }
@@ -36,6 +40,8 @@ void mcp::node_capability::stop()
 	boost::system::error_code ec;
 	if (m_request_timer)
 		m_request_timer->cancel(ec);
+	if (m_announce_timer)
+		m_announce_timer->cancel(ec);
 
 	m_stopped = true;
 }
@@ -79,6 +85,11 @@ void mcp::node_capability::on_connect(std::shared_ptr<p2p::peer> peer_a, unsigne
 	{
 		request_block_timeout();
 	}
+
+	if (!m_announcing.test_and_set())
+	{
+		flush_transaction_announces();
+	}
 }
 
 void mcp::node_capability::on_disconnect(std::shared_ptr<p2p::peer> peer_a)
@@ -134,8 +145,9 @@ void mcp::node_capability::request_block_timeout()
 		
 		if (!exist)
 		{
-			auto hash(std::make_shared<mcp::block_hash>(it.m_request_hash));
-			mcp::requesting_item request_item(it.m_node_id, it.m_request_hash, mcp::requesting_block_cause::new_unknown, now);
+			/// stalled, retry from the best scored peer other than the stalled one
+			record_timeout(it.m_node_id);
+			mcp::requesting_item request_item(select_peer(it.m_node_id), it.m_request_hash, mcp::requesting_block_cause::new_unknown, now);
 			if (it.m_type == mcp::sub_packet_type::transaction_request)
 				m_sync->request_new_missing_transactions(request_item, true);
 			else if (it.m_type == mcp::sub_packet_type::approve_request)
@@ -149,7 +161,9 @@ void mcp::node_capability::request_block_timeout()
 		}
 	}
 
-	m_request_timer->expires_from_now(boost::posix_time::seconds(20));
+	drop_slow_peers();
+
+	m_request_timer->expires_from_now(boost::posix_time::seconds(5));
 	m_request_timer->async_wait([this](boost::system::error_code const & error)
 	{
 		if (!error)
@@ -288,9 +302,12 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
 			auto _f = source::broadcast;
 			mcp::block_hash block_hash(joint.block->hash());
 			{
-				if (RequestingMageger.try_erase(block_hash)) /// is missing blocks,it's doesn't matter whether it's broadcast or requested 
+				mcp::requesting_item item;
+				if (RequestingMageger.try_erase(block_hash, item)) /// is missing blocks,it's doesn't matter whether it's broadcast or requested 
 				{
 					_f = source::request;
+					if (item.m_node_id == peer_a->remote_node_id())
+						record_response(item.m_node_id, item.m_time, r[0].data().size());
 					if (joint.request_id != mcp::sync_request_hash(0))
 						joint.request_id.clear(); ///broadcast do not need id
 				}
@@ -337,11 +354,20 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
 				Transaction t(r[0], CheckTransaction::Cheap);///Signature will be checked later
 				auto _f = source::broadcast;
 				{
-					if (RequestingMageger.try_erase(t.sha3()))
+					mcp::requesting_item item;
+					if (RequestingMageger.try_erase(t.sha3(), item))
+					{
 						_f = source::request;
+						if (item.m_node_id == peer_a->remote_node_id())
+							record_response(item.m_node_id, item.m_time, r[0].data().size());
+					}
 				}
 				if (mcp::node_sync::is_syncing() && _f == source::broadcast)
 					return true;
+				{
+					std::lock_guard<std::mutex> lock(m_pulling_mutex);
+					m_pulling_transactions.erase(t.sha3());
+				}
 				mark_as_known_transaction(peer_a->remote_node_id(), t.sha3());
 				mcp::CapMetricsRecieved.transaction++;
 				m_tq->enqueue(std::make_shared<Transaction>(t), peer_a->remote_node_id(), _f);
@@ -372,6 +398,48 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
 
 			break;
 		}
+		case mcp::sub_packet_type::transaction_hashes:
+		{
+			bool error(r.itemCount() != 1);
+			mcp::transaction_hashes_message message(error, r[0]);
+
+			if (error)
+			{
+				LOG(m_log.error) << "Invalid transaction hashes message rlp: " << r[0];
+				peer_a->disconnect(p2p::disconnect_reason::bad_protocol);
+				return true;
+			}
+			if (mcp::node_sync::is_syncing())
+				return true;
+
+			mcp::CapMetricsRecieved.transaction_hashes++;
+			for (auto const& h : message.hashes)
+				mark_as_known_transaction(peer_a->remote_node_id(), h);
+			m_async_task->sync_async([this, peer_a, message]() {
+				transaction_hashes_handler(peer_a->remote_node_id(), message);
+			});
+
+			break;
+		}
+		case mcp::sub_packet_type::transactions_request:
+		{
+			bool error(r.itemCount() != 1);
+			mcp::transaction_hashes_message request(error, r[0]);
+
+			if (error)
+			{
+				LOG(m_log.error) << "Invalid transactions request message rlp: " << r[0];
+				peer_a->disconnect(p2p::disconnect_reason::bad_protocol);
+				return true;
+			}
+
+			mcp::CapMetricsRecieved.transactions_request++;
+			m_async_task->sync_async([this, peer_a, request]() {
+				m_sync->transactions_request_handler(peer_a->remote_node_id(), request);
+			});
+
+			break;
+		}
 		case mcp::sub_packet_type::approve:
 		{
 			if (r.itemCount() != 1)
@@ -385,8 +453,13 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
 				approve ap(r[0], CheckTransaction::Cheap);///Signature will be checked later
 				auto _f = source::broadcast;
 				{
-					if (RequestingMageger.try_erase(ap.sha3()))
+					mcp::requesting_item item;
+					if (RequestingMageger.try_erase(ap.sha3(), item))
+					{
 						_f = source::request;
+						if (item.m_node_id == peer_a->remote_node_id())
+							record_response(item.m_node_id, item.m_time, r[0].data().size());
+					}
 				}
 				if (mcp::node_sync::is_syncing() && _f == source::broadcast)
 					return true;
@@ -437,8 +510,9 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
             //    << ", first_catchup_chain_summary: " << request.first_catchup_chain_summary.to_string();
 
 			mcp::CapMetricsRecieved.catchup_request++;
-			m_async_task->sync_async([this, peer_a, request]() {
-				m_sync->catchup_chain_request_handler(peer_a->remote_node_id(), request);
+			p2p::node_id id(peer_a->remote_node_id());
+			handle_bulk_request(peer_a, [this, id, request]() {
+				m_sync->catchup_chain_request_handler(id, request);
 			});
 
             break;
@@ -464,7 +538,7 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
                 return true;
             }
 
-			if (m_sync->response_for_sync_request(peer_a->remote_node_id(), mcp::sub_packet_type::catchup_request))
+			if (m_sync->response_for_sync_request(peer_a->remote_node_id(), mcp::sub_packet_type::catchup_request, r[0].data().size()))
 			{
 				mcp::CapMetricsRecieved.catchup_response++;
 				m_async_task->sync_async([this, peer_a, response]() {
@@ -490,8 +564,9 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
             //    << ", to_summary: " << request.to_summary.to_string();
 
 			mcp::CapMetricsRecieved.hash_tree_request++;
-			m_async_task->sync_async([this, peer_a, request]() {
-				m_sync->hash_tree_request_handler(peer_a->remote_node_id(), request);
+			p2p::node_id id(peer_a->remote_node_id());
+			handle_bulk_request(peer_a, [this, id, request]() {
+				m_sync->hash_tree_request_handler(id, request);
 			});
 
             break;
@@ -516,7 +591,7 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
             }
 
 			mcp::CapMetricsRecieved.hash_tree_response++;
-			if (m_sync->response_for_sync_request(peer_a->remote_node_id(), mcp::sub_packet_type::hash_tree_request))
+			if (m_sync->response_for_sync_request(peer_a->remote_node_id(), mcp::sub_packet_type::hash_tree_request, r[0].data().size()))
 			{
 				m_async_task->sync_async([this, peer_a, response]() {
 					m_sync->hash_tree_response_handler(peer_a->remote_node_id(), response);
@@ -673,6 +748,12 @@ bool mcp::node_capability::read_packet(std::shared_ptr<p2p::peer> peer_a, unsign
             }
 
             mcp::block_hash genesis_hash_remote = (mcp::block_hash)r[0][0];
+			uint64_t features = r[0].itemCount() > 2 ? r[0][2].toInt<uint64_t>() : 0;
+			{
+				std::lock_guard<std::mutex> lock(m_peers_mutex);
+				if (m_peers.count(peer_a->remote_node_id()))
+					m_peers.at(peer_a->remote_node_id()).transaction_announce = features & (uint64_t)hello_feature::transaction_announce;
+			}
 
             if (check_remotenode_hello(genesis_hash_remote))
             {
@@ -763,6 +844,8 @@ void mcp::node_capability::broadcast_transaction(mcp::Transaction const & messag
 		mcp::CapMetricsSend.broadcast_transaction++;
 		auto hash(message.sha3());
 		std::lock_guard<std::mutex> lock(m_peers_mutex);
+		std::vector<mcp::peer_info*> announce_peers;
+		size_t full_count(0);
 		for (auto it = m_peers.begin(); it != m_peers.end();)
 		{
 			mcp::peer_info &pi(it->second);
@@ -772,18 +855,270 @@ void mcp::node_capability::broadcast_transaction(mcp::Transaction const & messag
 				if (pi.is_known_transaction(hash))
 					continue;
 
+				if (pi.transaction_announce)
+				{
+					announce_peers.push_back(&pi);
+					continue;
+				}
+
+				/// peer can not pull, push full transaction
 				dev::RLPStream s;
 				p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::transaction, 1);
 				message.streamRLP(s);
-				p->send(s);
+				p->send(s, mcp::p2p::send_class::gossip);
+				pi.mark_as_known_transaction(hash);
+				full_count++;
 			}
 			else
 				it = m_peers.erase(it);
 		}
+
+		/// push full transaction to sqrt(n) peers, announce hash to the rest
+		size_t push_count = (size_t)std::sqrt(full_count + announce_peers.size());
+		push_count = push_count > full_count ? push_count - full_count : 0;
+		for (size_t i = 0; i < announce_peers.size(); i++)
+		{
+			if (i < push_count)
+			{
+				std::swap(announce_peers[i], announce_peers[mcp::random_pool.GenerateWord32(i, announce_peers.size() - 1)]);
+				mcp::peer_info &pi(*announce_peers[i]);
+				if (auto p = pi.try_lock_peer())
+				{
+					dev::RLPStream s;
+					p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::transaction, 1);
+					message.streamRLP(s);
+					p->send(s, mcp::p2p::send_class::gossip);
+				}
+			}
+			else
+				announce_peers[i]->pending_announces.push_back(hash);
+			announce_peers[i]->mark_as_known_transaction(hash);
+		}
 	}
 	catch (const std::exception& e)
 	{
-		LOG(m_log.error) << "broadcast_block error, error: " << e.what();
+		LOG(m_log.error) << "broadcast_transaction error, error: " << e.what();
+		throw;
+	}
+}
+
+void mcp::node_capability::flush_transaction_announces()
+{
+	if (m_stopped)
+		return;
+
+	try
+	{
+		std::lock_guard<std::mutex> lock(m_peers_mutex);
+		for (auto & it : m_peers)
+		{
+			mcp::peer_info &pi(it.second);
+			if (pi.pending_announces.empty())
+				continue;
+			if (auto p = pi.try_lock_peer())
+			{
+				for (size_t i = 0; i < pi.pending_announces.size(); i += mcp::transaction_hashes_message::max_hashes)
+				{
+					auto end = std::min(i + mcp::transaction_hashes_message::max_hashes, pi.pending_announces.size());
+					send_transaction_hashes(p, pi, h256s(pi.pending_announces.begin() + i, pi.pending_announces.begin() + end));
+				}
+			}
+			pi.pending_announces.clear();
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LOG(m_log.error) << "flush_transaction_announces error, error: " << e.what();
+	}
+
+	retry_pulling_transactions();
+	run_deferred_bulk_requests();
+
+	m_announce_timer->expires_from_now(boost::posix_time::milliseconds(ANNOUNCE_INTERVAL));
+	m_announce_timer->async_wait([this](boost::system::error_code const & error)
+	{
+		if (!error)
+			flush_transaction_announces();
+	});
+}
+
+void mcp::node_capability::handle_bulk_request(std::shared_ptr<p2p::peer> peer_a, std::function<void()> const & handler_a)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_deferred_bulk_mutex);
+		bool waiting(std::any_of(m_deferred_bulk_requests.begin(), m_deferred_bulk_requests.end(),
+			[&peer_a](deferred_bulk_request const & r) { return r.peer.lock() == peer_a; }));
+		if (waiting || peer_a->bulk_full())
+		{
+			m_deferred_bulk_requests.push_back(deferred_bulk_request{ peer_a, handler_a });
+			return;
+		}
+	}
+	m_async_task->sync_async(handler_a);
+}
+
+void mcp::node_capability::run_deferred_bulk_requests()
+{
+	std::vector<std::function<void()>> ready;
+	{
+		std::lock_guard<std::mutex> lock(m_deferred_bulk_mutex);
+		/// a peer still full keeps its later requests waiting too
+		std::unordered_set<std::shared_ptr<p2p::peer>> full;
+		for (auto it = m_deferred_bulk_requests.begin(); it != m_deferred_bulk_requests.end();)
+		{
+			auto p(it->peer.lock());
+			if (!p)
+			{
+				it = m_deferred_bulk_requests.erase(it);
+				continue;
+			}
+			if (full.count(p) || p->bulk_full())
+			{
+				full.insert(p);
+				it++;
+				continue;
+			}
+			ready.push_back(it->handler);
+			it = m_deferred_bulk_requests.erase(it);
+		}
+	}
+	for (auto const & handler : ready)
+		m_async_task->sync_async(handler);
+}
+
+void mcp::node_capability::send_transaction_hashes(std::shared_ptr<p2p::peer> p, mcp::peer_info const & pi, h256s const & hashes)
+{
+	mcp::CapMetricsSend.transaction_hashes++;
+
+	dev::RLPStream s;
+	p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::transaction_hashes, 1);
+	mcp::transaction_hashes_message(hashes).stream_RLP(s);
+	p->send(s, mcp::p2p::send_class::gossip);
+}
+
+void mcp::node_capability::send_transactions_request(std::shared_ptr<p2p::peer> p, mcp::peer_info const & pi, h256s const & hashes)
+{
+	mcp::CapMetricsSend.transactions_request++;
+
+	dev::RLPStream s;
+	p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::transactions_request, 1);
+	mcp::transaction_hashes_message(hashes).stream_RLP(s);
+	/// pulled again only after ANNOUNCE_PULL_TIMEOUT, it must not be dropped
+	p->send(s);
+}
+
+void mcp::node_capability::retry_pulling_transactions()
+{
+	std::unordered_map<p2p::node_id, h256s> retries;
+	uint64_t now = SteadyClock.now_since_epoch();
+	{
+		std::lock_guard<std::mutex> lock(m_pulling_mutex);
+		for (auto it = m_pulling_transactions.begin(); it != m_pulling_transactions.end();)
+		{
+			pulling_transaction & pulling(it->second);
+			if (now <= pulling.time + ANNOUNCE_PULL_TIMEOUT)
+			{
+				it++;
+				continue;
+			}
+			if (pulling.announcers.empty())
+			{
+				it = m_pulling_transactions.erase(it);
+				continue;
+			}
+			pulling.time = now;
+			pulling.from = pulling.announcers.front();
+			pulling.announcers.pop_front();
+			retries[pulling.from].push_back(it->first);
+			it++;
+		}
+	}
+
+	if (retries.empty())
+		return;
+
+	try
+	{
+		std::lock_guard<std::mutex> lock(m_peers_mutex);
+		for (auto const & r : retries)
+		{
+			/// a disconnected announcer times out again, then the next one is tried
+			auto it(m_peers.find(r.first));
+			if (it == m_peers.end())
+				continue;
+			mcp::peer_info &pi(it->second);
+			if (auto p = pi.try_lock_peer())
+			{
+				for (size_t i = 0; i < r.second.size(); i += mcp::transaction_hashes_message::max_hashes)
+				{
+					auto end = std::min(i + mcp::transaction_hashes_message::max_hashes, r.second.size());
+					send_transactions_request(p, pi, h256s(r.second.begin() + i, r.second.begin() + end));
+				}
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LOG(m_log.error) << "retry_pulling_transactions error, error: " << e.what();
+	}
+}
+
+void mcp::node_capability::transaction_hashes_handler(p2p::node_id const & id, mcp::transaction_hashes_message const & message)
+{
+	try
+	{
+		mcp::stopwatch_guard sw("capability:transaction_hashes_handler");
+
+		if (m_stopped)
+			return;
+
+		h256s unknown;
+		uint64_t now = SteadyClock.now_since_epoch();
+		mcp::db::db_transaction transaction(m_store.create_transaction());
+		for (auto const& h : message.hashes)
+		{
+			if (m_tq->exist(h) || m_cache->transaction_exists(transaction, h))
+				continue;
+
+			std::lock_guard<std::mutex> lock(m_pulling_mutex);
+			auto it = m_pulling_transactions.find(h);
+			if (it != m_pulling_transactions.end())
+			{
+				pulling_transaction & pulling(it->second);
+				if (now <= pulling.time + ANNOUNCE_PULL_TIMEOUT) /// pulling from other peer
+				{
+					/// pulled from it if the pull times out
+					if (id != pulling.from && pulling.announcers.size() < MAX_TRANSACTION_ANNOUNCERS
+						&& std::find(pulling.announcers.begin(), pulling.announcers.end(), id) == pulling.announcers.end())
+						pulling.announcers.push_back(id);
+					continue;
+				}
+				pulling.time = now;
+				pulling.from = id;
+			}
+			else
+			{
+				if (m_pulling_transactions.size() >= MAX_PULLING_TRANSACTIONS)
+					break;
+				m_pulling_transactions.emplace(h, pulling_transaction{ now, id, {} });
+			}
+			unknown.push_back(h);
+		}
+
+		if (unknown.empty())
+			return;
+
+		std::lock_guard<std::mutex> lock(m_peers_mutex);
+		if (m_peers.count(id))
+		{
+			mcp::peer_info &pi(m_peers.at(id));
+			if (auto p = pi.try_lock_peer())
+				send_transactions_request(p, pi, unknown);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LOG(m_log.error) << "transaction_hashes_handler error:" << e.what();
 		throw;
 	}
 }
@@ -858,6 +1193,92 @@ uint64_t mcp::node_capability::num_peers()
     return m_peers.size();
 }
 
+void mcp::node_capability::record_response(p2p::node_id const & id, uint64_t const & request_time_a, uint64_t const & bytes_a)
+{
+	uint64_t now = SteadyClock.now_since_epoch();
+	std::lock_guard<std::mutex> lock(m_peers_mutex);
+	if (m_peers.count(id))
+	{
+		if (auto p = m_peers.at(id).try_lock_peer())
+			p->score().on_response(std::chrono::milliseconds(now > request_time_a ? now - request_time_a : 0), bytes_a);
+	}
+}
+
+void mcp::node_capability::record_timeout(p2p::node_id const & id)
+{
+	std::lock_guard<std::mutex> lock(m_peers_mutex);
+	if (m_peers.count(id))
+	{
+		if (auto p = m_peers.at(id).try_lock_peer())
+			p->score().on_timeout();
+	}
+}
+
+/// best scored peer except exclude_a, exclude_a returned if no other peer
+mcp::p2p::node_id mcp::node_capability::select_peer(p2p::node_id const & exclude_a)
+{
+	p2p::node_id ret(exclude_a);
+	double best(0);
+	std::lock_guard<std::mutex> lock(m_peers_mutex);
+	for (auto const & it : m_peers)
+	{
+		if (it.first == exclude_a || m_wait_confirm_remote_node.count(it.first))
+			continue;
+
+		if (auto p = it.second.try_lock_peer())
+		{
+			double score(p->score().score());
+			if (score > best)
+			{
+				best = score;
+				ret = it.first;
+			}
+		}
+	}
+	return ret;
+}
+
+bool mcp::node_capability::is_slow_peer(p2p::node_id const & id)
+{
+	std::lock_guard<std::mutex> lock(m_peers_mutex);
+	if (m_peers.count(id))
+	{
+		if (auto p = m_peers.at(id).try_lock_peer())
+			return p->score().is_slow();
+	}
+	return false;
+}
+
+void mcp::node_capability::drop_slow_peers()
+{
+	std::list<std::shared_ptr<p2p::peer>> slows;
+	{
+		std::lock_guard<std::mutex> lock(m_peers_mutex);
+		if (m_peers.size() <= MIN_PEERS_TO_DROP_SLOW)
+			return;
+
+		size_t max_drop(m_peers.size() - MIN_PEERS_TO_DROP_SLOW);
+		for (auto const & it : m_peers)
+		{
+			if (slows.size() >= max_drop)
+				break;
+			if (auto p = it.second.try_lock_peer())
+			{
+				if (p->score().is_slow())
+					slows.push_back(p);
+			}
+		}
+	}
+
+	/// disconnect call on_disconnect, which locks m_peers_mutex
+	for (auto const & p : slows)
+	{
+		LOG(m_log.info) << "Drop slow peer: " << p->remote_node_id().hex() << ", rtt: " << p->score().rtt()
+			<< "ms, success rate: " << p->score().success_rate();
+		p->disconnect(p2p::disconnect_reason::useless_peer);
+	}
+}
+
 void mcp::node_capability::send_hello_info(p2p::node_id const &id)
 {
     std::lock_guard<std::mutex> lock(m_peers_mutex);
@@ -870,9 +1291,10 @@ void mcp::node_capability::send_hello_info(p2p::node_id const &id)
 
             dev::RLPStream s;
             p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::hello_info, 1);
-            s.appendList(2);
+            s.appendList(3);
             s << m_genesis;
             s << desc.version;
+            s << (uint64_t)hello_feature::transaction_announce;
             p->send(s);
         }
     }
@@ -8,7 +8,9 @@
 #include <mcp/p2p/peer.hpp>
 #include <mcp/node/sync.hpp>
 #include <mcp/common/async_task.hpp>
+#include <mcp/common/rolling_filter.hpp>
 
+#include <deque>
 #include <thread>
 
 namespace mcp
@@ -19,9 +21,9 @@ namespace mcp
 		peer_info(std::shared_ptr<p2p::peer> peer_a, unsigned const & offset_a):
 			peer(peer_a),
 			offset(offset_a),
-			known_blocks(100),
-			known_transactions(10000),
-			known_approves(10000),
+			known_blocks(p2p::p2p_config::known_blocks),
+			known_transactions(p2p::p2p_config::known_transactions),
+			known_approves(p2p::p2p_config::known_approves),
 			last_hanlde_peer_info_request_time(std::chrono::steady_clock::now()),
 			last_peer_info_request_time(std::chrono::steady_clock::now())
 		{
@@ -69,10 +71,21 @@ namespace mcp
 		std::chrono::steady_clock::time_point last_hanlde_peer_info_request_time;
 		std::chrono::steady_clock::time_point last_peer_info_request_time;
 
+		/// remote understands transaction_hashes/transactions_request, learned from hello info
+		bool transaction_announce = false;
+		/// transaction hashes waiting to be announced to this peer
+		h256s pending_announces;
+
 	private:
-		mcp::mru_list<mcp::block_hash, std::mutex> known_blocks;
-		mcp::mru_list<h256, std::mutex> known_transactions;
-		mcp::mru_list<h256, std::mutex> known_approves;
+		mcp::rolling_filter known_blocks;
+		mcp::rolling_filter known_transactions;
+		mcp::rolling_filter known_approves;
+	};
+
+	/// features advertised in hello info, old nodes ignore them
+	enum class hello_feature : uint64_t
+	{
+		transaction_announce = 1
 	};
 
     class local_remote_ack_hello {   
@@ -122,6 +135,12 @@ namespace mcp
 
         //sync
         static const int COLLECT_PEER_INFO_INTERVAL = 10 * 1000; //ms
+
+		//transaction announce
+		static const int ANNOUNCE_INTERVAL = 100; //ms
+		static const int ANNOUNCE_PULL_TIMEOUT = 5000; //ms, pull again from another announcer
+		static const size_t MAX_PULLING_TRANSACTIONS = 40960;
+		static const size_t MAX_TRANSACTION_ANNOUNCERS = 8; /// other announcers kept per pulled hash
 		const boost::posix_time::milliseconds no_joint_interval = boost::posix_time::milliseconds(10000);
 
         void send_hello_info(p2p::node_id const & );
@@ -132,6 +151,13 @@ namespace mcp
 
 		uint64_t num_peers();
 
+		//peer score
+		void record_response(p2p::node_id const & id, uint64_t const & request_time_a, uint64_t const & bytes_a);
+		void record_timeout(p2p::node_id const & id);
+		p2p::node_id select_peer(p2p::node_id const & exclude_a);
+		bool is_slow_peer(p2p::node_id const & id);
+		static const size_t MIN_PEERS_TO_DROP_SLOW = 4; /// keep slow peers if too few connected
+
         uint64_t del_joint_in_asso_count = 0;
         uint64_t add_joint_in_asso_count = 0;    
 
@@ -157,6 +183,40 @@ namespace mcp
 		std::unique_ptr<boost::asio::deadline_timer> m_request_timer;
 		std::atomic_flag m_request_associng = ATOMIC_FLAG_INIT;
 		void request_block_timeout();
+		void drop_slow_peers();
+
+		//transaction announce
+		void flush_transaction_announces();
+		void send_transaction_hashes(std::shared_ptr<p2p::peer> p, mcp::peer_info const & pi, h256s const & hashes);
+		void send_transactions_request(std::shared_ptr<p2p::peer> p, mcp::peer_info const & pi, h256s const & hashes);
+		void transaction_hashes_handler(p2p::node_id const & id, mcp::transaction_hashes_message const & message);
+		/// pulls that timed out go to the next announcer, hashes no announcer is left for are forgotten
+		void retry_pulling_transactions();
+		std::unique_ptr<boost::asio::deadline_timer> m_announce_timer;
+		std::atomic_flag m_announcing = ATOMIC_FLAG_INIT;
+		class pulling_transaction
+		{
+		public:
+			uint64_t time;
+			p2p::node_id from;
+			/// announced by them too while pulling, they take it for known and do not announce it again
+			std::deque<p2p::node_id> announcers;
+		};
+		std::unordered_map<h256, pulling_transaction> m_pulling_transactions;
+		std::mutex m_pulling_mutex;
+
+		/// sync requests are answered with bulk packets. Those of a peer whose bulk queue is full wait here,
+		/// in order, and run once it drains instead of queueing responses up to the send buffer limit
+		void handle_bulk_request(std::shared_ptr<p2p::peer> peer_a, std::function<void()> const & handler_a);
+		void run_deferred_bulk_requests();
+		class deferred_bulk_request
+		{
+		public:
+			std::weak_ptr<p2p::peer> peer;
+			std::function<void()> handler;
+		};
+		std::deque<deferred_bulk_request> m_deferred_bulk_requests;
+		std::mutex m_deferred_bulk_mutex;
 
 		mcp::log m_log = { mcp::log("p2p") };
 
@@ -35,6 +35,7 @@ bool mcp::requesting_mageger::add(mcp::requesting_item& item_a, bool const& coun
 			///upgrade request time
 			mcp::requesting_item item(*it);
 			item.m_time = item_a.m_time;
+			item.m_node_id = item_a.m_node_id; ///retry may be routed to another peer
 			if (count_a)
 				item.m_request_count++;
 
@@ -58,11 +59,18 @@ bool mcp::requesting_mageger::add(mcp::requesting_item& item_a, bool const& coun
 }
 
 bool mcp::requesting_mageger::try_erase(h256 const & _h)
+{
+	mcp::requesting_item item;
+	return try_erase(_h, item);
+}
+
+bool mcp::requesting_mageger::try_erase(h256 const & _h, mcp::requesting_item& item_a)
 {
 	UpgradableGuard l(m_lock);
 	auto it(m_request_info.get<0>().find(_h));
 	if (it != m_request_info.get<0>().end())
 	{
+		item_a = *it;
 		UpgradeGuard ul(l);
 		m_request_info.get<0>().erase(it);
 		return true;
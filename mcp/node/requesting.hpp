@@ -10,6 +10,7 @@ namespace mcp
 		requesting_mageger();
 		bool add(mcp::requesting_item& item_a, bool const& count_a = false);
 		bool try_erase(h256 const& _h);
+		bool try_erase(h256 const& _h, mcp::requesting_item& item_a); ///erased item returned, used to score the responding peer
 		std::list<requesting_item> clear_by_time(uint64_t const& time_a);
 		uint64_t size() { return m_request_info.size(); }
 
@@ -162,6 +162,30 @@ void mcp::node_sync::transaction_request_handler(p2p::node_id const &id, mcp::tr
 	}
 }
 
+void mcp::node_sync::transactions_request_handler(p2p::node_id const &id, mcp::transaction_hashes_message const &request)
+{
+	try
+	{
+		mcp::stopwatch_guard sw("sync:transactions_request_handler");
+
+		if (m_stoped)
+			return;
+
+		/// only pooled transactions are announced, so do not search in db
+		for (auto const& h : request.hashes)
+		{
+			std::shared_ptr<mcp::Transaction> t = m_tq->get(h);
+			if (nullptr != t)
+				send_transaction(id, *t);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LOG(log_sync.error) << "transactions_request_handler error:" << e.what();
+		throw;
+	}
+}
+
 void mcp::node_sync::approve_request_handler(p2p::node_id const &id, mcp::approve_request_message const &request)
 {
 	try
@@ -191,7 +215,7 @@ void mcp::node_sync::approve_request_handler(p2p::node_id const &id, mcp::approv
 	}
 }
 
-void mcp::node_sync::request_catchup(p2p::node_id const& id)
+void mcp::node_sync::request_catchup(p2p::node_id const& id_a)
 {
 	try
 	{
@@ -199,6 +223,9 @@ void mcp::node_sync::request_catchup(p2p::node_id const& id)
 		if (m_stoped)
 			return;
 
+		/// do not sync from a consistently slow peer
+		p2p::node_id id(m_capability->is_slow_peer(id_a) ? m_capability->select_peer(id_a) : id_a);
+
 		mcp::sync_status st = mcp::sync_status::ok;
 		if(!m_status.compare_exchange_strong(st, mcp::sync_status::pending))
 			return;
@@ -353,7 +380,7 @@ void mcp::node_sync::send_catchup_request(p2p::node_id const& id, mcp::catchup_r
 			dev::RLPStream s;
 			p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::catchup_request, 1);
 			message.stream_RLP(s);
-			p->send(s);
+			p->send(s, mcp::p2p::send_class::bulk);
 		}
 	}
 	else
@@ -604,15 +631,16 @@ void mcp::node_sync::send_catchup_response(p2p::node_id const& id, mcp::catchup_
 			dev::RLPStream s;
 			p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::catchup_response, 1);
 			message.stream_RLP(s);
-			p->send(s);
+			p->send(s, mcp::p2p::send_class::bulk);
 		}
 	}
 }
 
-bool mcp::node_sync::response_for_sync_request(p2p::node_id const & request_node_id_a, mcp::sub_packet_type const & request_type_a)
+bool mcp::node_sync::response_for_sync_request(p2p::node_id const & request_node_id_a, mcp::sub_packet_type const & request_type_a, uint64_t const & bytes_a)
 {
 	//LOG(log_sync.info) << "response_for_sync_request : success:" << request_node_id_a.to_string() << ",request_type:" << unsigned(request_type_a);
 	bool exist = false;
+	uint64_t request_time(0);
 	mcp::sync_request_status sync_request_time_out(request_node_id_a, request_type_a);
 	{
 		std::lock_guard<std::mutex> lock(m_capability->m_peers_mutex);
@@ -622,6 +650,7 @@ bool mcp::node_sync::response_for_sync_request(p2p::node_id const & request_node
 			{
 				m_sync_requests.erase(it->first);
 				exist = true;
+				request_time = m_sync_request_time;
 
 				boost::system::error_code ec;
 				if (m_sync_request_timer)	//recieved cancel timer
@@ -631,6 +660,9 @@ bool mcp::node_sync::response_for_sync_request(p2p::node_id const & request_node
 		}
 		m_task_clear_flag = true;
 	}
+
+	if (exist)
+		m_capability->record_response(request_node_id_a, request_time, bytes_a);
 	
 	return exist;
 }
@@ -656,11 +688,14 @@ void mcp::node_sync::catchup_chain_response_handler(p2p::node_id const& id, mcp:
 		{
 			LOG(log_sync.info) << "process_catchup_chain_debug:check fail start next request catch up";
 			m_status = mcp::sync_status::ok;
+			m_store.bulk_load(false);
 			m_request_info.unstable_mc_joints.clear();
 			return;
 		}
 
         m_status = mcp::sync_status::syncing;
+        /// stable ranges of the catchup chain are verified by summaries, their bundles are bulk loaded
+        m_store.bulk_load(true);
 
 		if (response.is_catchup_chain_complete)
 		{
@@ -762,6 +797,7 @@ mcp::sync_result mcp::node_sync::request_next_hash_tree(p2p::node_id const& id,
 			mcp::sync_result result = mcp::sync_result::request_next_hash_tree_no_summary;
 			m_request_info.clear();
 			m_status = mcp::sync_status::ok;
+			m_store.bulk_load(false);
 			return result;
 		}
 
@@ -812,7 +848,7 @@ void mcp::node_sync::send_hash_tree_request(p2p::node_id const & id, mcp::hash_t
 			dev::RLPStream s;
 			p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::hash_tree_request, 1);
 			message.stream_RLP(s);
-			p->send(s);
+			p->send(s, mcp::p2p::send_class::bulk);
 		}
 	}
 	else
@@ -1186,12 +1222,10 @@ void mcp::node_sync::read_hash_tree(mcp::hash_tree_request_message const& hash_t
 
 	dev::h256Hash _tmp;///deduplicate.
 	uint64_t all_approve_size = 0;
+	/// stable block bundles are read in one ordered scan, indexes without one fall back to point reads
+	mcp::db::forward_iterator bundle_it(m_store.stable_block_bundle_begin(transaction, from_index));
 	for (uint64_t index = from_index; index <= to_index; index++)
 	{
-		mcp::block_hash bh;
-		bool exists(!m_store.stable_block_get(transaction, index, bh));
-		assert_x(exists);
-
 		if (hash_tree_response.arr_summaries.size() >= mcp::p2p::max_summary_items
 			|| _tmp.size() > 4096 || all_approve_size > 4096)
 		{
@@ -1200,34 +1234,79 @@ void mcp::node_sync::read_hash_tree(mcp::hash_tree_request_message const& hash_t
 			break;
 		}
 
-		std::shared_ptr<mcp::block> block_ptr = m_cache->block_get(transaction, bh);
-		std::shared_ptr<mcp::block_state> bs(m_cache->block_state_get(transaction, bh));
+		mcp::block_hash bh;
+		std::shared_ptr<mcp::block> block_ptr;
+		std::shared_ptr<mcp::block_state> bs;
 		mcp::summary_hash sh;
-		m_cache->block_summary_get(transaction, bh, sh);
-
-		//previous summary hash
 		mcp::summary_hash previous_summary(0);
-		if (block_ptr->previous() != mcp::block_hash(0))
-		{
-			bool previous_summary_hash_error(m_cache->block_summary_get(transaction, block_ptr->previous(), previous_summary));
-			assert_x(!previous_summary_hash_error);
-		}
-
 		std::list<mcp::summary_hash> p_summaries;
 		std::set<mcp::summary_hash> s_summaries;
+		h256 receiptsRoot;
+		mcp::skiplist_info s_info;
 
-		// check if all the parent have summaries
-		std::vector<mcp::block_hash> const & parents(block_ptr->parents());
-		for (auto it = parents.begin(); it != parents.end(); ++it)
+		std::shared_ptr<mcp::stable_block_bundle> bundle(m_store.stable_block_bundle_get(bundle_it, index));
+		if (bundle)
+		{
+			block_ptr = bundle->block;
+			bh = block_ptr->hash();
+			bs = std::make_shared<mcp::block_state>(bundle->state);
+			sh = bundle->summary;
+			previous_summary = bundle->previous_summary;
+			p_summaries = bundle->parent_summaries;
+			receiptsRoot = bundle->receipts_root;
+			s_info.list = bundle->skiplist;
+			s_summaries = bundle->skiplist_summaries;
+		}
+		else
 		{
-			mcp::summary_hash sh;
-			if (m_cache->block_summary_get(transaction, *it, sh))
+			bool exists(!m_store.stable_block_get(transaction, index, bh));
+			assert_x(exists);
+
+			block_ptr = m_cache->block_get(transaction, bh);
+			bs = m_cache->block_state_get(transaction, bh);
+			m_cache->block_summary_get(transaction, bh, sh);
+
+			//previous summary hash
+			if (block_ptr->previous() != mcp::block_hash(0))
+			{
+				bool previous_summary_hash_error(m_cache->block_summary_get(transaction, block_ptr->previous(), previous_summary));
+				assert_x(!previous_summary_hash_error);
+			}
+
+			// check if all the parent have summaries
+			std::vector<mcp::block_hash> const & parents(block_ptr->parents());
+			for (auto it = parents.begin(); it != parents.end(); ++it)
+			{
+				mcp::summary_hash sh;
+				if (m_cache->block_summary_get(transaction, *it, sh))
+				{
+					LOG(log_sync.info) << "read_hash_tree: some parents have no summaries";
+					p_summaries.clear();
+					return;
+				}
+				p_summaries.push_back(sh);
+			}
+
+			if (!m_store.GetBlockReceiptsRoot(transaction, bh, receiptsRoot))
 			{
-				LOG(log_sync.info) << "read_hash_tree: some parents have no summaries";
-				p_summaries.clear();
+				LOG(log_sync.info) << "read_hash_tree: transaction receiptRoot have no summaries";
 				return;
 			}
-			p_summaries.push_back(sh);
+
+			// check if all the blocks on skiplist have summaries
+			m_store.skiplist_get(transaction, bh, s_info);
+			for (auto it = s_info.list.begin(); it != s_info.list.end(); it++)
+			{
+				mcp::summary_hash sh;
+				if (m_cache->block_summary_get(transaction, *it, sh))
+				{
+					LOG(log_sync.info) << "read_hash_tree:some skiplist blocks have no summaries";
+					s_summaries.clear();
+					return;
+				}
+				//LOG(log_sync.debug)  << "skiplist summary: " << sh.to_string() ;
+				s_summaries.insert(sh);
+			}
 		}
 
 		// check if all the links have summaries
@@ -1260,29 +1339,6 @@ void mcp::node_sync::read_hash_tree(mcp::hash_tree_request_message const& hash_t
 		}
 		all_approve_size += block_ptr->approves().size();
 
-		h256 receiptsRoot;
-		if (!m_store.GetBlockReceiptsRoot(transaction, bh, receiptsRoot))
-		{
-			LOG(log_sync.info) << "read_hash_tree: transaction receiptRoot have no summaries";
-			return;
-		}
-
-		// check if all the blocks on skiplist have summaries
-		mcp::skiplist_info s_info;
-		m_store.skiplist_get(transaction, bh, s_info);
-		for (auto it = s_info.list.begin(); it != s_info.list.end(); it++)
-		{
-			mcp::summary_hash sh;
-			if (m_cache->block_summary_get(transaction, *it, sh))
-			{
-				LOG(log_sync.info) << "read_hash_tree:some skiplist blocks have no summaries";
-				s_summaries.clear();
-				return;
-			}
-			//LOG(log_sync.debug)  << "skiplist summary: " << sh.to_string() ;
-			s_summaries.insert(sh);
-		}
-
 		// fill the summary items
 		mcp::hash_tree_response_message::summary_items s(bh, sh, previous_summary, p_summaries, receiptsRoot, s_summaries, bs->status, bs->stable_index, bs->mc_timestamp, bs->level, block_ptr, trannsactions, approves, *bs->main_chain_index, s_info.list);
 		hash_tree_response.arr_summaries.insert(s);
@@ -1312,7 +1368,7 @@ void mcp::node_sync::send_hash_tree_response(p2p::node_id const& id, mcp::hash_t
 			dev::RLPStream s;
 			p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::hash_tree_response, 1);
 			message.stream_RLP(s);
-			p->send(s);
+			p->send(s, mcp::p2p::send_class::bulk);
 		}
 	}
 }
@@ -1350,6 +1406,7 @@ void mcp::node_sync::process_hash_tree(p2p::node_id const &id, mcp::hash_tree_re
 			else
 			{
 				m_status = mcp::sync_status::ok;
+				m_store.bulk_load(false);
 				LOG(log_sync.error) << "process_hash_tree:timer error: " << error.message();
 			}
 		});
@@ -1623,6 +1680,7 @@ void mcp::node_sync::clear_catchup_info(bool lock)
 		m_sync_request_timer->cancel(ec);
 
     m_status = mcp::sync_status::ok;
+    m_store.bulk_load(false);
 
 	m_block_processor->on_sync_completed(m_request_info.id);
 }
@@ -1820,6 +1878,7 @@ size_t mcp::node_sync::move_free_iterator_random(mcp::db::forward_iterator & it,
 void mcp::node_sync::add_task_sync_request_timer(p2p::node_id const & request_node_id_a, mcp::sub_packet_type const & request_type_a)
 {
 	m_sync_requests[m_sync_request_id] = mcp::sync_request_status(request_node_id_a, request_type_a);
+	m_sync_request_time = SteadyClock.now_since_epoch();
 	if (mcp::sub_packet_type::hash_tree_request == request_type_a)
 		m_sync_request_timer->expires_from_now(boost::posix_time::seconds(30));
 	else
@@ -1829,6 +1888,9 @@ void mcp::node_sync::add_task_sync_request_timer(p2p::node_id const & request_no
 	{
 		if (!error)
 		{
+			if (!m_task_clear_flag)
+				m_capability->record_timeout(request_node_id_a);
+
 			std::lock_guard<std::mutex> lock(m_capability->m_peers_mutex);
 			if (m_task_clear_flag)
 				return;
@@ -2045,7 +2107,7 @@ void mcp::node_sync::send_peer_info_request(p2p::node_id id)
 					p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::peer_info_request, 1);
 					mcp::peer_info_request_message message;
 					message.stream_RLP(s);
-					p->send(s);
+					p->send(s, mcp::p2p::send_class::gossip);
 					// LOG(log_sync.debug) << "send_peer_info_request:node id:" << id.hex();
 				}
 			}
@@ -2095,7 +2157,7 @@ void mcp::node_sync::send_peer_info(p2p::node_id const & id, mcp::peer_info_mess
 			dev::RLPStream s;
 			p->prep(s, pi.offset + (unsigned)mcp::sub_packet_type::peer_info, 1);
 			message.stream_RLP(s);
-			p->send(s);
+			p->send(s, mcp::p2p::send_class::gossip);
 		}
 	}
 }
@@ -98,7 +98,7 @@ namespace mcp
 		mcp::sync_request_hash get_current_request_id() { return m_current_request_id; }
 		void request_catchup(p2p::node_id const& id);
 		void catchup_chain_request_handler(p2p::node_id const& id, mcp::catchup_request_message const& request);
-		bool response_for_sync_request(p2p::node_id const & request_node_id_a, mcp::sub_packet_type const & request_type_a);
+		bool response_for_sync_request(p2p::node_id const & request_node_id_a, mcp::sub_packet_type const & request_type_a, uint64_t const & bytes_a = 0);
 		void catchup_chain_response_handler(p2p::node_id const& id, mcp::catchup_response_message const& response);
 		void hash_tree_request_handler(p2p::node_id const& id, mcp::hash_tree_request_message const& message);
 		void hash_tree_response_handler(p2p::node_id const &, mcp::hash_tree_response_message const &);
@@ -110,6 +110,7 @@ namespace mcp
 
 		void joint_request_handler(p2p::node_id const &, mcp::joint_request_message const &);
 		void transaction_request_handler(p2p::node_id const &, mcp::transaction_request_message const &);
+		void transactions_request_handler(p2p::node_id const &, mcp::transaction_hashes_message const &);
 		void approve_request_handler(p2p::node_id const &, mcp::approve_request_message const &);
 		void send_peer_info_request(p2p::node_id id);
 		void send_peer_info(p2p::node_id const &, mcp::peer_info_message const &);
@@ -166,6 +167,7 @@ namespace mcp
 
 		std::map<uint64_t, mcp::sync_request_status> m_sync_requests;
 		std::atomic<uint64_t> m_sync_request_id = { 0 };
+		uint64_t m_sync_request_time = 0; ///used to score the responding peer, guarded by m_capability->m_peers_mutex like m_sync_requests
 		mcp::sync_request_hash m_current_request_id = mcp::sync_request_hash(0);
 		mcp::catchup_request_message m_current_catchup_request;
 		std::unique_ptr<boost::asio::deadline_timer> m_sync_timer;
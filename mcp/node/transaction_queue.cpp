@@ -1,5 +1,6 @@
 #include "transaction_queue.hpp"
 #include <thread>
+#include <queue>
 
 namespace mcp
 {
@@ -100,17 +101,43 @@ namespace mcp
 		return import(_transaction, source::local);
 	}
 
-	h256s TransactionQueue::topTransactions(unsigned _limit) const
+	h256s TransactionQueue::topTransactions(unsigned _limit, u256 const& _gasTarget) const
 	{
-		/// todo: link accounts randomly and limit the maximum number of transactions in a single block links 
+		/// next transaction of the nonce chain of one account, only the ready queue is merged, pending accounts are gapped
+		struct chainHead
+		{
+			std::map<u256, std::shared_ptr<Transaction>>::const_iterator it;
+			std::map<u256, std::shared_ptr<Transaction>>::const_iterator end;
+			bool operator<(chainHead const& _other) const
+			{
+				if (it->second->gasPrice() != _other.it->second->gasPrice())
+					return it->second->gasPrice() < _other.it->second->gasPrice();
+				/// any fixed order for equal price, composes stay deterministic
+				return it->second->sha3() > _other.it->second->sha3();
+			}
+		};
+
 		ReadGuard l(m_lock);
-		h256s ret;
+		std::priority_queue<chainHead> heads;
 		for (auto cs = queue.begin(); cs != queue.end(); ++cs)
+			if (!cs->second.txs.empty())
+				heads.push(chainHead{ cs->second.txs.begin(), cs->second.txs.end() });
+
+		h256s ret;
+		u256 gas = 0;
+		while (!heads.empty() && ret.size() < _limit)
 		{
-			auto r = cs->second.transactionHashs(_limit - ret.size());
-			ret.insert(ret.end(), r.begin(), r.end());
-			if (ret.size() == _limit)
-				break;
+			chainHead head(heads.top());
+			heads.pop();
+
+			std::shared_ptr<Transaction> const& t(head.it->second);
+			if (_gasTarget - gas < t->gas())
+				continue;
+
+			gas += t->gas();
+			ret.push_back(t->sha3());
+			if (++head.it != head.end)
+				heads.push(head);
 		}
 		return ret;
 	}
@@ -59,12 +59,13 @@ namespace mcp
 
 		/// Get top transactions from the queue. Returned transactions are not removed from the queue automatically.
 		/// @param _limit Max number of transactions to return.
-		/// @returns up to _limit transactions ordered by nonce and gas price.
-		/// @returns account A : b2, b3, b4, b5
-		///          account B : b1, b2, b3
-		///          account c : c2, c3
-		/// @returns accounts disorder,but transactions of account is order by nonce
-		h256s topTransactions(unsigned _limit) const;
+		/// @param _gasTarget Max sum of gas of the returned transactions.
+		/// @returns up to _limit transactions, the nonce chains of accounts merged by the gas price of their next transaction.
+		/// @returns account A : a2(9), a3(2)
+		///          account B : b1(5), b2(7)
+		///          order : a2, b1, b2, a3
+		/// A transaction over the remaining gas ends the chain of its account, later nonces can not be linked without it.
+		h256s topTransactions(unsigned _limit, u256 const& _gasTarget = Invalid256) const;
 
 		/// Determined transaction exist.
 		/// @param Address.
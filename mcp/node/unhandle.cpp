@@ -1,5 +1,6 @@
 #include "unhandle.hpp"
 #include "arrival.hpp"
+#include <algorithm>
 #include <queue>
 
 constexpr size_t c_maxBlockPendingSize = 1000;
@@ -8,10 +9,10 @@ constexpr size_t c_maxBlockPendingSize = 1000;
 mcp::unhandle_add_result mcp::unhandle_cache::add(std::shared_ptr<mcp::block_processor_item> item_a,
 	h256Hash const &bks,
 	h256Hash const &transactions,
-	h256Hash const &approves)
+	h256Hash const &approves,
+	std::vector<std::shared_ptr<mcp::block_processor_item>> & ready_a)
 {
 	auto hash_a = item_a->block_hash;
-	std::lock_guard<std::mutex> lock (m_mutux);
 	assert_x(!bks.count(hash_a));
 
 	/// Determine if a transaction exists
@@ -33,313 +34,342 @@ mcp::unhandle_add_result mcp::unhandle_cache::add(std::shared_ptr<mcp::block_pro
 	if (bks.empty() && _txs.empty() && _aps.empty())
 		return unhandle_add_result::Retry;
 
-    bool exists(m_pending.count(hash_a));
-    if (exists)
-    {
-		unhandle_exist_count++;
-        return unhandle_add_result::Exist;
-    }
-
-	/// only accept unknown dependencies when size reach at half of capacity
-	if (is_full() && item_a->is_broadCast())
 	{
-		unhandle_full_count++;
-        return unhandle_add_result::Exist;
-	}
-	
-	add_unhandle_ok_count++;
+		shard & s(shard_of(hash_a));
+		std::lock_guard<std::mutex> lock(s.mutex);
+		bool exists(s.pending.count(hash_a));
+		if (exists)
+		{
+			unhandle_exist_count++;
+			return unhandle_add_result::Exist;
+		}
 
-	mcp::unhandle_item u_item(item_a, bks, _txs, _aps);
-	m_pending[hash_a] = u_item;
+		/// only accept unknown dependencies when size reach at half of capacity
+		if (is_full() && item_a->is_broadCast())
+		{
+			unhandle_full_count++;
+			return unhandle_add_result::Exist;
+		}
+
+		s.pending[hash_a] = mcp::unhandle_item(item_a, bks, _txs, _aps, m_sequence++);
+		m_size++;
+
+		///delete unknown dependency. 3<-4<-5, 3,4 in missing, received 4
+		s.missings.erase(hash_a);
+	}
 
-	///delete unknown dependency. 3<-4<-5, 3,4 in missing, received 4
-	if (m_missings.count(hash_a))
-		m_missings.erase(hash_a);
+	add_unhandle_ok_count++;
 
 	bool allExist = true;
-	for (mcp::block_hash const &bk : u_item.bks)
+	for (mcp::block_hash const &bk : bks)
 	{
-		m_dependencies[bk].insert(hash_a);
+		shard & s(shard_of(bk));
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.dependencies[bk].insert(hash_a);
 
 		/// add unknown dependency
-		if (!m_pending.count(bk))
+		if (!s.pending.count(bk))
 		{
-			m_missings.insert(bk);
+			s.missings.insert(bk);
 			allExist = false;
 		}
 	}
 
-	for (h256 const &h : u_item.txs)
+	for (h256 const &h : _txs)
 	{
-		m_transactions[h].insert(hash_a);
+		shard & s(shard_of(h));
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.transactions[h].insert(hash_a);
 		/// add unknown dependency
-		m_light_missings.insert(h);/// maybe failed because exist,unimportance.
+		s.light_missings.insert(h);/// maybe failed because exist,unimportance.
 	}
 
-	for (h256 const &h : u_item.aps)
+	for (h256 const &h : _aps)
 	{
-		m_approves[h].insert(hash_a);
+		shard & s(shard_of(h));
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.approves[h].insert(hash_a);
 		/// add unknown dependency
-		m_approve_missings.insert(h);/// maybe failed because exist,unimportance.
+		s.approve_missings.insert(h);/// maybe failed because exist,unimportance.
 	}
 
-	if (m_pending.size() > c_maxBlockPendingSize)
-	{
-		m_pending.clear();
-		m_dependencies.clear();
-		m_transactions.clear();
-		m_approves.clear();
-		m_missings.clear();
-		m_light_missings.clear();
-		m_approve_missings.clear();
+	/// a transaction or approve imported after the check above found no dependency to release, release it here
+	size_t from(ready_a.size());
+	for (h256 const &h : _txs)
+		if (m_tq->exist(h))
+			release(h, dependency_type::transaction, ready_a);
+	for (h256 const &h : _aps)
+		if (m_aq->exist(h))
+			release(h, dependency_type::approve, ready_a);
+	release_descendants(ready_a, from);
+
+	size_t size(m_size);
+	if (size > c_maxBlockPendingSize)
+		evict(size - c_maxBlockPendingSize + c_maxBlockPendingSize / 10, hash_a);
+
+	/// the block itself may be released, all its dependencies are there
+	if (std::find(ready_a.begin() + from, ready_a.end(), item_a) != ready_a.end())
 		return unhandle_add_result::Nothing;
-	}
 
 	///dependice block,transaction,approves exist,need request existed missings.
-	if (allExist && !u_item.txs.size()&& !u_item.aps.size())
+	if (allExist && !_txs.size() && !_aps.size())
 	{
 		return unhandle_add_result::Exist;
 	}
     return unhandle_add_result::Success;
 }
 
-std::unordered_set<std::shared_ptr<mcp::block_processor_item>> mcp::unhandle_cache::release_dependency(mcp::block_hash const &dependency_hash_a)
+void mcp::unhandle_cache::release(h256 const & hash_a, dependency_type const & type_a, std::vector<std::shared_ptr<mcp::block_processor_item>> & ready_a)
 {
-	std::lock_guard<std::mutex> lock(m_mutux);
-	std::unordered_set<std::shared_ptr<mcp::block_processor_item>> result;
-
-	if (m_dependencies.count(dependency_hash_a))
+	h256Hash pending_hashs;
 	{
-		h256Hash pending_hashs = m_dependencies[dependency_hash_a];
-		for (auto _h : pending_hashs)
-		{
-			assert_x(m_pending.count(_h));
-			auto &unhandle = m_pending[_h];
-			unhandle.bks.erase(dependency_hash_a);
-			if (unhandle.ready())
-			{
-				result.insert(unhandle.item);
-				m_pending.erase(_h);
-			}
-		}
-        
+		shard & s(shard_of(hash_a));
+		std::lock_guard<std::mutex> lock(s.mutex);
+		std::unordered_map<h256, h256Hash> & index(type_a == dependency_type::block ? s.dependencies :
+			type_a == dependency_type::transaction ? s.transactions : s.approves);
+		auto it(index.find(hash_a));
+		if (it == index.end())
+			return;
+
+		pending_hashs = std::move(it->second);
 		//delete dependency
-		m_dependencies.erase(dependency_hash_a);
+		index.erase(it);
 		//delete unknown dependencies
-		m_missings.erase(dependency_hash_a);
+		(type_a == dependency_type::block ? s.missings : type_a == dependency_type::transaction ? s.light_missings : s.approve_missings).erase(hash_a);
 	}
 
-	return result;
-}
-
-std::unordered_set<std::shared_ptr<mcp::block_processor_item>> mcp::unhandle_cache::release_transaction_dependency(h256Hash const &hashs)
-{
-	std::lock_guard<std::mutex> lock(m_mutux);
-	std::unordered_set<std::shared_ptr<mcp::block_processor_item>> result;
-	for (auto h : hashs)
+	for (auto const & _h : pending_hashs)
 	{
-		if (!m_transactions.count(h))
+		shard & s(shard_of(_h));
+		std::lock_guard<std::mutex> lock(s.mutex);
+		auto it(s.pending.find(_h));
+		/// evicted, or released by a concurrent release of another of its dependencies
+		if (it == s.pending.end())
 			continue;
 
-		h256Hash pending_hashs = m_transactions[h];
-		for (auto _h : pending_hashs)
+		auto &unhandle = it->second;
+		(type_a == dependency_type::block ? unhandle.bks : type_a == dependency_type::transaction ? unhandle.txs : unhandle.aps).erase(hash_a);
+		if (unhandle.ready())
 		{
-			assert_x(m_pending.count(_h));
-			auto &unhandle = m_pending[_h];
-			unhandle.txs.erase(h);
-			if (unhandle.ready())
-			{
-				result.insert(unhandle.item);
-				m_pending.erase(_h);
-			}
+			ready_a.push_back(unhandle.item);
+			s.pending.erase(it);
+			m_size--;
 		}
-
-		//delete dependency
-		m_transactions.erase(h);
-		//delete unknown dependencies
-		m_light_missings.erase(h);
 	}
+}
 
+void mcp::unhandle_cache::release_descendants(std::vector<std::shared_ptr<mcp::block_processor_item>> & ready_a, size_t from_a)
+{
+	/// a block is appended once its last dependency is released, after all blocks it depends on
+	for (; from_a < ready_a.size(); from_a++)
+		release(ready_a[from_a]->block_hash, dependency_type::block, ready_a);
+}
+
+std::vector<std::shared_ptr<mcp::block_processor_item>> mcp::unhandle_cache::release_dependency(mcp::block_hash const &dependency_hash_a)
+{
+	std::vector<std::shared_ptr<mcp::block_processor_item>> result;
+	release(dependency_hash_a, dependency_type::block, result);
+	release_descendants(result, 0);
 	return result;
 }
 
-std::unordered_set<std::shared_ptr<mcp::block_processor_item>> mcp::unhandle_cache::release_approve_dependency(h256Hash const &hashs)
+std::vector<std::shared_ptr<mcp::block_processor_item>> mcp::unhandle_cache::release_transaction_dependency(h256Hash const &hashs)
 {
-	std::lock_guard<std::mutex> lock(m_mutux);
+	std::vector<std::shared_ptr<mcp::block_processor_item>> result;
+	for (auto const & h : hashs)
+		release(h, dependency_type::transaction, result);
+	release_descendants(result, 0);
+	return result;
+}
 
-	std::unordered_set<std::shared_ptr<mcp::block_processor_item>> result;
+std::vector<std::shared_ptr<mcp::block_processor_item>> mcp::unhandle_cache::release_approve_dependency(h256Hash const &hashs)
+{
+	std::vector<std::shared_ptr<mcp::block_processor_item>> result;
+	for (auto const & h : hashs)
+		release(h, dependency_type::approve, result);
+	release_descendants(result, 0);
+	return result;
+}
 
-	for (auto h : hashs)
+void mcp::unhandle_cache::evict(size_t const & count_a, mcp::block_hash const & keep_a)
+{
+	class candidate
+	{
+	public:
+		mcp::block_hash hash;
+		bool broadcast;
+		uint64_t sequence;
+	};
+
+	std::vector<candidate> candidates;
+	for (shard & s : m_shards)
 	{
-		if (!m_approves.count(h))
-			return result;
+		std::lock_guard<std::mutex> lock(s.mutex);
+		for (auto const & p : s.pending)
+			if (p.first != keep_a)
+				candidates.push_back(candidate{ p.first, p.second.item->is_broadCast(), p.second.sequence });
+	}
+
+	size_t count(std::min(count_a, candidates.size()));
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), [](candidate const & a, candidate const & b)
+	{
+		if (a.broadcast != b.broadcast)
+			return a.broadcast;
+		return a.sequence < b.sequence;
+	});
 
-		h256Hash pending_hashs = m_approves[h];
-		for (auto _h : pending_hashs)
+	for (size_t i = 0; i < count; i++)
+	{
+		mcp::block_hash const & hash(candidates[i].hash);
+		mcp::unhandle_item item;
 		{
-			assert_x(m_pending.count(_h));
-			auto &unhandle = m_pending[_h];
-			unhandle.aps.erase(h);
-			if (unhandle.ready())
-			{
-				result.insert(unhandle.item);
-				m_pending.erase(_h);
-			}
+			shard & s(shard_of(hash));
+			std::lock_guard<std::mutex> lock(s.mutex);
+			auto it(s.pending.find(hash));
+			if (it == s.pending.end())
+				continue;
+			item = std::move(it->second);
+			s.pending.erase(it);
+			m_size--;
+			/// blocks depending on it wait for it again
+			if (s.dependencies.count(hash))
+				s.missings.insert(hash);
 		}
-
-		//delete dependency
-		m_approves.erase(h);
-		//delete unknown dependencies
-		m_approve_missings.erase(h);
+		unhandle_evicted_count++;
+
+		for (auto const & h : item.bks)
+			remove_dependent(h, dependency_type::block, hash);
+		for (auto const & h : item.txs)
+			remove_dependent(h, dependency_type::transaction, hash);
+		for (auto const & h : item.aps)
+			remove_dependent(h, dependency_type::approve, hash);
 	}
 
-	return result;
+	LOG(m_log.debug) << "Unhandle evicted " << count << " blocks";
+}
+
+void mcp::unhandle_cache::remove_dependent(h256 const & hash_a, dependency_type const & type_a, mcp::block_hash const & dependent_a)
+{
+	shard & s(shard_of(hash_a));
+	std::lock_guard<std::mutex> lock(s.mutex);
+	std::unordered_map<h256, h256Hash> & index(type_a == dependency_type::block ? s.dependencies :
+		type_a == dependency_type::transaction ? s.transactions : s.approves);
+	auto it(index.find(hash_a));
+	if (it == index.end())
+		return;
+
+	it->second.erase(dependent_a);
+	if (it->second.empty())
+	{
+		index.erase(it);
+		(type_a == dependency_type::block ? s.missings : type_a == dependency_type::transaction ? s.light_missings : s.approve_missings).erase(hash_a);
+	}
 }
 
 void mcp::unhandle_cache::get_missings(size_t const & missing_limit_a, std::vector<mcp::block_hash> & missings_a, std::vector<h256> & light_missings_a, std::vector<h256>& approve_missings_a)
 {
-	std::lock_guard<std::mutex> lock(m_mutux);
+	/// shards are visited from a random one, so that requests rotate over all missings
+	size_t const start(mcp::random_pool.GenerateWord32(0, shard_count - 1));
 
-	if (m_missings.size() == 0 && m_pending.size() > 0)
+	for (size_t i = 0; i < shard_count && missings_a.size() < missing_limit_a; i++)
 	{
-		auto it = m_pending.begin();
-		size_t offset = mcp::random_pool.GenerateWord32(0, m_pending.size() - 1);
-		for (; offset > 0; offset--)
-			it++;
-		mcp::block_hash start(0);
-		while (missings_a.size() < 50 && start != it->first)
+		shard & s(m_shards[(start + i) % shard_count]);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		for (auto const &d : s.missings)
 		{
-			missings_a.push_back(it->first);
-			if (start == mcp::block_hash(0))
-				start = it->first;
-			it++;
-			if (it == m_pending.end())
-				it = m_pending.begin();
+			if (missings_a.size() >= missing_limit_a)
+				break;
+			if (!s.pending.count(d))
+				missings_a.push_back(d);
 		}
 	}
-	else
+
+	if (missings_a.empty() && m_size > 0)
 	{
-		if (m_missings.size() <= missing_limit_a)
-		{
-			for (auto const &d : m_missings)
-			{
-				if (!m_pending.count(d))
-					missings_a.push_back(d);
-			}
-		}
-		else
+		for (size_t i = 0; i < shard_count && missings_a.size() < 50; i++)
 		{
-			auto it = m_missings.begin();
-			size_t offset = mcp::random_pool.GenerateWord32(0, m_missings.size() - 1);
-			for (; offset > 0; offset--)
-				it++;
-			mcp::block_hash start(0);
-			while (missings_a.size() < missing_limit_a && start != *it)
+			shard & s(m_shards[(start + i) % shard_count]);
+			std::lock_guard<std::mutex> lock(s.mutex);
+			for (auto const &p : s.pending)
 			{
-				if (!m_pending.count(*it))
-					missings_a.push_back(*it);
-				if (start == mcp::block_hash(0))
-					start = *it;
-				it++;
-				if (it == m_missings.end())
-					it = m_missings.begin();
+				if (missings_a.size() >= 50)
+					break;
+				missings_a.push_back(p.first);
 			}
 		}
 	}
 
-	size_t light_missing_limit = missing_limit_a - missings_a.size();
+	size_t light_missing_limit = missing_limit_a > missings_a.size() ? missing_limit_a - missings_a.size() : 0;
 
 	h256Hash knowns;
 	{
 		/// will locked transaction queue
 		knowns = m_tq->knownTransactions();
 	}
-	if (m_light_missings.size() <= light_missing_limit)
+	for (size_t i = 0; i < shard_count && light_missings_a.size() < light_missing_limit; i++)
 	{
-		for (auto const &d : m_light_missings)
+		shard & s(m_shards[(start + i) % shard_count]);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		for (auto const &d : s.light_missings)
 		{
+			if (light_missings_a.size() >= light_missing_limit)
+				break;
 			if (!knowns.count(d))
 				light_missings_a.push_back(d);
 		}
 	}
-	else
-	{
-		auto it = m_light_missings.begin();
-		size_t offset = mcp::random_pool.GenerateWord32(0, m_light_missings.size() - 1);
-		for (; offset > 0; offset--)
-		{
-			it++;
-		}
-
-		h256 start(0);
-		while (light_missings_a.size() < light_missing_limit && start != *it)
-		{
-			if (!knowns.count(*it))
-				light_missings_a.push_back(*it);
-			if (start == h256(0))
-				start = *it;
-			it++;
-			if (it == m_light_missings.end())
-				it = m_light_missings.begin();
-		}
-	}
 
 	size_t approve_missing_limit = missing_limit_a / 4;
 
-	if (m_approve_missings.size() <= approve_missing_limit)
+	for (size_t i = 0; i < shard_count && approve_missings_a.size() < approve_missing_limit; i++)
 	{
-		for (auto const &d : m_approve_missings)
+		shard & s(m_shards[(start + i) % shard_count]);
+		std::lock_guard<std::mutex> lock(s.mutex);
+		for (auto const &d : s.approve_missings)
 		{
+			if (approve_missings_a.size() >= approve_missing_limit)
+				break;
 			approve_missings_a.push_back(d);
 		}
 	}
-	else
-	{
-		auto it = m_approve_missings.begin();
-		size_t offset = mcp::random_pool.GenerateWord32(0, m_approve_missings.size() - 1);
-		for (; offset > 0; offset--)
-		{
-			it++;
-		}
-
-		h256 start(0);
-		while (approve_missings_a.size() < approve_missing_limit && start != *it)
-		{
-			approve_missings_a.push_back(*it);
-			if (start == h256(0))
-				start = *it;
-			it++;
-			if (it == m_approve_missings.end())
-				it = m_approve_missings.begin();
-		}
-	}
 }
 
 bool mcp::unhandle_cache::exists(mcp::block_hash const & block_hash_a)
 {
-	std::lock_guard<std::mutex> lock(m_mutux);
+	shard & s(shard_of(block_hash_a));
+	std::lock_guard<std::mutex> lock(s.mutex);
 
-	auto it(m_pending.find(block_hash_a));
-	return it != m_pending.end();
+	auto it(s.pending.find(block_hash_a));
+	return it != s.pending.end();
 }
 
 bool mcp::unhandle_cache::is_full()
 {
-	return m_pending.size() >= (c_maxBlockPendingSize / 2);
+	return m_size >= (c_maxBlockPendingSize / 2);
 }
 
 std::string mcp::unhandle_cache::getInfo()
 {
-	std::string str = "pending size:" + std::to_string(m_pending.size())
-		+ " ,dependency size:" + std::to_string(m_dependencies.size())
-		+ " ,missing size:" + std::to_string(m_missings.size())
-		+ " ,txs :" + std::to_string(m_light_missings.size())
-		+ " ,apx :" + std::to_string(m_approve_missings.size())
+	size_t dependencies(0), missings(0), light_missings(0), approve_missings(0);
+	for (shard & s : m_shards)
+	{
+		std::lock_guard<std::mutex> lock(s.mutex);
+		dependencies += s.dependencies.size();
+		missings += s.missings.size();
+		light_missings += s.light_missings.size();
+		approve_missings += s.approve_missings.size();
+	}
+
+	std::string str = "pending size:" + std::to_string(m_size)
+		+ " ,dependency size:" + std::to_string(dependencies)
+		+ " ,missing size:" + std::to_string(missings)
+		+ " ,txs :" + std::to_string(light_missings)
+		+ " ,apx :" + std::to_string(approve_missings)
 		+ " ,ok:" + std::to_string(add_unhandle_ok_count)
 		+ " ,full:" + std::to_string(unhandle_full_count)
 		+ " ,exist:" + std::to_string(unhandle_exist_count)
+		+ " ,evicted:" + std::to_string(unhandle_evicted_count)
 		;
 
 	return str;
 }
-
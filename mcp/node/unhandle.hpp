@@ -3,6 +3,8 @@
 #include <mcp/node/message.hpp>
 #include <mcp/common/log.hpp>
 
+#include <array>
+#include <atomic>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -16,7 +18,7 @@ namespace mcp
 {
 	enum unhandle_add_result : int
 	{
-		/// clear cache, go to sync
+		/// clear cache, go to sync, or the block was released at once
 		Nothing,
 
 		/// block in unhandle,need request exist missing,not block missing
@@ -34,55 +36,97 @@ class unhandle_item
   public:
 	unhandle_item() = default;
 	unhandle_item(std::shared_ptr<mcp::block_processor_item> item_a,
-		h256Hash const &bks_a, h256Hash const &txs_a, h256Hash const &aps_a
-	):item(item_a), bks(bks_a), txs(txs_a), aps(aps_a) {}
+		h256Hash const &bks_a, h256Hash const &txs_a, h256Hash const &aps_a, uint64_t const & sequence_a
+	):item(item_a), bks(bks_a), txs(txs_a), aps(aps_a), sequence(sequence_a) {}
 
 	bool ready() { return bks.empty() && txs.empty() && aps.empty(); }
 	std::shared_ptr<mcp::block_processor_item> item;
 	h256Hash bks;
 	h256Hash txs;
 	h256Hash aps;
+	/// order of adding, older items are evicted first
+	uint64_t sequence = 0;
 };
 
+/// Blocks waiting for missing blocks, transactions or approves. Sharded by hash, a pending block and the
+/// blocks depending on it are found in the shard of its hash, the blocks depending on a transaction or an
+/// approve in the shard of that hash. At most one shard is locked at a time.
+/// A released block releases its descendants at once, before it is validated. They are queued right after it and
+/// processed after it on the processing thread, so a dependency stored by a released block is there for them.
+/// If it turns out invalid they fail with an invalid parent. If it goes back here for something still missing,
+/// they are validated for nothing, find it missing and come back as well. Waiting for each block to be stored
+/// would cost a round through the queues per level of the dag, while an invalid or incomplete parent is rare.
 class unhandle_cache
 {
   public:
 	  unhandle_cache(std::shared_ptr<TransactionQueue> tq, std::shared_ptr<ApproveQueue> aq):
 		  m_tq(tq),m_aq(aq) {}
 
-	unhandle_add_result add(std::shared_ptr<mcp::block_processor_item> item_a, h256Hash const &bks, h256Hash const &transactions, h256Hash const &approves);
-	std::unordered_set<std::shared_ptr<mcp::block_processor_item>> release_dependency(mcp::block_hash const &dependency_hash_a);
-	std::unordered_set<std::shared_ptr<mcp::block_processor_item>> release_transaction_dependency(h256Hash const &hashs);
-	std::unordered_set<std::shared_ptr<mcp::block_processor_item>> release_approve_dependency(h256Hash const &hashs);
+	/// Blocks released by transactions or approves imported while adding are appended to ready_a, in topological order.
+	unhandle_add_result add(std::shared_ptr<mcp::block_processor_item> item_a, h256Hash const &bks, h256Hash const &transactions, h256Hash const &approves,
+		std::vector<std::shared_ptr<mcp::block_processor_item>> & ready_a);
+	/// Released blocks are in topological order. Blocks depending only on released blocks are released with them,
+	/// a block is released after the blocks it depends on, so the whole ready sub-DAG is processed in one batch.
+	std::vector<std::shared_ptr<mcp::block_processor_item>> release_dependency(mcp::block_hash const &dependency_hash_a);
+	std::vector<std::shared_ptr<mcp::block_processor_item>> release_transaction_dependency(h256Hash const &hashs);
+	std::vector<std::shared_ptr<mcp::block_processor_item>> release_approve_dependency(h256Hash const &hashs);
 	void get_missings(size_t const & missing_limit_a, std::vector<mcp::block_hash>& missings_a, std::vector<h256>& light_missings_a, std::vector<h256>& approve_missings_a);
 
 	bool exists(mcp::block_hash const & block_hash_a);
 	bool is_full();
 	std::string getInfo();
   private:
-	/// unhandle hash -> unhandle item
-	std::unordered_map<mcp::block_hash, mcp::unhandle_item> m_pending;
-	/// dependency hash -> unhandle block hashs
-	/// All blocks that depend on the block. such as, the parent of block C is block A, and the previous of block D is block A too.
-	std::unordered_map<mcp::block_hash, h256Hash> m_dependencies;
-	/// dependency hash -> unhandle transaction hashs
-	/// All blocks that depend on the transaction. maybe block A depend on T1,and block B depend on T1 too.
-	std::unordered_map<h256, h256Hash> m_transactions;
-	/// dependency hash -> unhandle approve hashs
-	/// All blocks that depend on the approve. maybe block A depend on approve1,and block B depend on approve1 too.
-	std::unordered_map<h256, h256Hash> m_approves;
-
-	h256Hash m_missings;
-	h256Hash m_light_missings;
-	h256Hash m_approve_missings;
-
-	std::mutex m_mutux;
+	enum class dependency_type
+	{
+		block,
+		transaction,
+		approve
+	};
+
+	class shard
+	{
+	public:
+		std::mutex mutex;
+		/// unhandle hash -> unhandle item
+		std::unordered_map<mcp::block_hash, mcp::unhandle_item> pending;
+		/// dependency hash -> unhandle block hashs
+		/// All blocks that depend on the block. such as, the parent of block C is block A, and the previous of block D is block A too.
+		std::unordered_map<mcp::block_hash, h256Hash> dependencies;
+		/// dependency hash -> unhandle transaction hashs
+		/// All blocks that depend on the transaction. maybe block A depend on T1,and block B depend on T1 too.
+		std::unordered_map<h256, h256Hash> transactions;
+		/// dependency hash -> unhandle approve hashs
+		/// All blocks that depend on the approve. maybe block A depend on approve1,and block B depend on approve1 too.
+		std::unordered_map<h256, h256Hash> approves;
+
+		h256Hash missings;
+		h256Hash light_missings;
+		h256Hash approve_missings;
+	};
+
+	static size_t const shard_count = 16;
+	shard & shard_of(h256 const & hash_a) { return m_shards[hash_a[0] % shard_count]; }
+
+	/// removes the dependency from the blocks depending on it, blocks now ready are appended to ready_a
+	void release(h256 const & hash_a, dependency_type const & type_a, std::vector<std::shared_ptr<mcp::block_processor_item>> & ready_a);
+	/// releases the blocks depending on ready_a from position from_a on, appending them. They are released
+	/// before the blocks they depend on are validated, see the class comment
+	void release_descendants(std::vector<std::shared_ptr<mcp::block_processor_item>> & ready_a, size_t from_a);
+	/// evicts the lowest priority blocks but keep_a: broadcast before requested ones, older before newer
+	void evict(size_t const & count_a, mcp::block_hash const & keep_a);
+	void remove_dependent(h256 const & hash_a, dependency_type const & type_a, mcp::block_hash const & dependent_a);
+
+	std::array<shard, shard_count> m_shards;
+	std::atomic<size_t> m_size = { 0 };
+	std::atomic<uint64_t> m_sequence = { 0 };
+
 	std::shared_ptr<TransactionQueue> m_tq;                  ///< Maintains a list of incoming transactions not yet in a block on the blockchain.
 	std::shared_ptr<ApproveQueue> m_aq;                  ///< Maintains a list of incoming approves not yet in a block on the blockchain.
 
-	uint64_t add_unhandle_ok_count = 0;
-	uint64_t unhandle_full_count = 0;
-	uint64_t unhandle_exist_count = 0;
+	std::atomic<uint64_t> add_unhandle_ok_count = { 0 };
+	std::atomic<uint64_t> unhandle_full_count = { 0 };
+	std::atomic<uint64_t> unhandle_exist_count = { 0 };
+	std::atomic<uint64_t> unhandle_evicted_count = { 0 };
     mcp::log m_log = { mcp::log("node") };
 };
 
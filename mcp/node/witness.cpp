@@ -10,7 +10,8 @@ mcp::witness::witness(mcp::error_message & error_msg,
 	std::shared_ptr<mcp::block_processor> block_processor_a,
 	std::shared_ptr<mcp::block_cache> cache_a, std::shared_ptr<TransactionQueue> tq,
 	std::shared_ptr<ApproveQueue> aq,
-	std::string const & account_or_file_text, std::string const & password_a
+	std::string const & account_or_file_text, std::string const & password_a,
+	uint32_t const & min_delay_a, uint32_t const & max_delay_a
 ) :
 	m_store(store_a),
 	m_alarm(alarm_a),
@@ -21,7 +22,10 @@ mcp::witness::witness(mcp::error_message & error_msg,
 	m_tq(tq),
 	m_aq(aq),
 	m_last_witness_time(std::chrono::steady_clock::now()),
-	m_witness_interval(std::chrono::milliseconds(m_max_witness_interval))
+	m_witness_interval(std::chrono::milliseconds(m_max_witness_interval)),
+	m_min_delay(min_delay_a),
+	m_max_delay(max_delay_a),
+	m_scheduled(std::chrono::steady_clock::time_point::max())
 {
 	m_chain->onMciStable([this](uint64_t const& mci) { try_create_approve(mci); });
 	bool error(!mcp::isAddress(account_or_file_text));
@@ -75,14 +79,66 @@ mcp::witness::witness(mcp::error_message & error_msg,
 void mcp::witness::start()
 {
 	std::weak_ptr<mcp::witness> this_w(shared_from_this());
-	
-	uint32_t ms = mcp::mcp_network == mcp::mcp_networks::mcp_mini_test_network ? 50 : mcp::random_pool.GenerateWord32(500, 1000);
+	m_tq->onReady([this_w](h256 const &) {
+		if (auto this_l = this_w.lock())
+			this_l->on_event();
+	});
+	m_chain->onMciStable([this_w](uint64_t const &) {
+		if (auto this_l = this_w.lock())
+			this_l->on_event();
+	});
+	m_block_processor->onCommitted([this_w]() {
+		if (auto this_l = this_w.lock())
+			this_l->on_event();
+	});
+
+	ongoing_check();
+}
+
+void mcp::witness::ongoing_check()
+{
+	std::weak_ptr<mcp::witness> this_w(shared_from_this());
+
+	/// randomized so that witnesses do not check in step
+	uint32_t ms = mcp::mcp_network == mcp::mcp_networks::mcp_mini_test_network ? 50 : mcp::random_pool.GenerateWord32(m_max_delay.count() / 2, m_max_delay.count());
 	m_alarm->add(std::chrono::steady_clock::now() + std::chrono::milliseconds(ms), [this_w]() {
 		if (auto this_l = this_w.lock())
 		{
             //LOG(this_l->m_log.info) << "Witness :is time to check_and_witness";
+			this_l->schedule(std::chrono::steady_clock::now());
+			this_l->ongoing_check();
+		}
+	});
+}
+
+void mcp::witness::on_event()
+{
+	/// witnesses see the same commits and stable mcis, the jitter keeps them from composing at the same moment
+	std::chrono::milliseconds jitter(mcp::random_pool.GenerateWord32(0, m_min_delay.count()));
+	schedule(std::chrono::steady_clock::now() + m_min_delay + jitter);
+}
+
+void mcp::witness::schedule(std::chrono::steady_clock::time_point const & time_a)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_schedule_mutex);
+		if (time_a >= m_scheduled)
+			return;
+		m_scheduled = time_a;
+	}
+
+	std::weak_ptr<mcp::witness> this_w(shared_from_this());
+	m_alarm->add(time_a, [this_w, time_a]() {
+		if (auto this_l = this_w.lock())
+		{
+			{
+				std::lock_guard<std::mutex> lock(this_l->m_schedule_mutex);
+				/// replaced by an earlier one
+				if (this_l->m_scheduled != time_a)
+					return;
+				this_l->m_scheduled = std::chrono::steady_clock::time_point::max();
+			}
 			this_l->check_and_witness();
-			this_l->start();
 		}
 	});
 }
@@ -97,6 +153,8 @@ void mcp::witness::check_and_witness()
 	{
 		witness_interval_count++;
 		m_is_witnessing.clear();
+		/// due once the interval since the last witness block is over
+		schedule(m_last_witness_time + m_witness_interval);
 		return;
 	}
 
@@ -294,7 +352,9 @@ uint32_t const mcp::witness::m_max_do_witness_interval(1000);
 uint64_t const mcp::witness::m_threshold_distance(50);
 
 mcp::witness_config::witness_config():
-    is_witness(false)
+    is_witness(false),
+    min_delay(20),
+    max_delay(1000)
 {
 }
 
@@ -303,6 +363,8 @@ void mcp::witness_config::serialize_json(mcp::json &json_a) const
     json_a["witness"] = is_witness ? "true":"false";
     json_a["witness_account"] = account_or_file;
     json_a["password"] = password;
+    json_a["witness_min_delay"] = min_delay;
+    json_a["witness_max_delay"] = max_delay;
 }
 
 bool mcp::witness_config::deserialize_json(mcp::json const & json_a)
@@ -336,6 +398,12 @@ bool mcp::witness_config::deserialize_json(mcp::json const & json_a)
         {
             error = true;
         }
+
+        if (json_a.count("witness_min_delay") && json_a["witness_min_delay"].is_number_unsigned())
+            min_delay = json_a["witness_min_delay"].get<uint32_t>();
+        if (json_a.count("witness_max_delay") && json_a["witness_max_delay"].is_number_unsigned())
+            max_delay = json_a["witness_max_delay"].get<uint32_t>();
+        error |= max_delay == 0 || min_delay > max_delay;
     }
     catch (std::runtime_error const &)
     {
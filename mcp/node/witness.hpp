@@ -19,6 +19,11 @@ namespace mcp
         bool is_witness;
         std::string account_or_file;
         std::string password;
+        /// ms an event waits for more before a witness block is checked, so bursts of transactions go in one block.
+        /// A random jitter of up to min_delay is added
+        uint32_t min_delay;
+        /// ms between checks when no event comes, randomized between half of it and max_delay
+        uint32_t max_delay;
     };
 	class witness : public std::enable_shared_from_this<mcp::witness>
 	{
@@ -30,8 +35,11 @@ namespace mcp
 			std::shared_ptr<mcp::block_processor> block_processor_a,
 			std::shared_ptr<mcp::block_cache> cache_a, std::shared_ptr<TransactionQueue> tq,
 			std::shared_ptr<ApproveQueue> aq,
-			std::string const & account_text, std::string const & password_a
+			std::string const & account_text, std::string const & password_a,
+			uint32_t const & min_delay_a, uint32_t const & max_delay_a
 		);
+		/// checks are driven by transaction arrivals, new stable mcis and committed blocks, with a periodic check when idle.
+		/// Registers on their signals, called before the block processor is started
 		void start();
 		void check_and_witness();
 		void try_create_approve(uint64_t const& mci);
@@ -39,6 +47,11 @@ namespace mcp
 
 	private:
 		void do_witness();
+		/// an event that may make a witness block due, checked after the min delay
+		void on_event();
+		/// check_and_witness at time_a unless one is scheduled earlier
+		void schedule(std::chrono::steady_clock::time_point const & time_a);
+		void ongoing_check();
 
 		mcp::block_store m_store;
 		std::shared_ptr<mcp::alarm> m_alarm;
@@ -57,6 +70,12 @@ namespace mcp
 		uint32_t const m_max_witness_interval = 2000;
 		std::chrono::milliseconds m_witness_interval ;
 
+		std::chrono::milliseconds const m_min_delay;
+		std::chrono::milliseconds const m_max_delay;
+		std::mutex m_schedule_mutex;
+		/// time_point::max() if none is scheduled
+		std::chrono::steady_clock::time_point m_scheduled;
+
 		static std::atomic_flag m_is_witnessing;
 		static uint32_t const m_max_do_witness_interval;
 		static uint64_t const m_threshold_distance;
@@ -80,6 +80,10 @@ p2p_config::p2p_config() :
 {
 }
 
+uint32_t p2p_config::known_blocks(100);
+uint32_t p2p_config::known_transactions(10000);
+uint32_t p2p_config::known_approves(10000);
+
 void p2p_config::serialize_json(mcp::json & json_a) const
 {
     json_a["host"] = listen_ip;
@@ -101,6 +105,9 @@ void p2p_config::serialize_json(mcp::json & json_a) const
     json_a["exemption_nodes"] = j_exemption_nodes;
 
     json_a["nat"] = nat ? "true":"false";
+    json_a["known_blocks"] = known_blocks;
+    json_a["known_transactions"] = known_transactions;
+    json_a["known_approves"] = known_approves;
 }
 
 bool p2p_config::deserialize_json(mcp::json const & json_a)
@@ -186,6 +193,13 @@ bool p2p_config::deserialize_json(mcp::json const & json_a)
             error = true;
         }
 
+        if (json_a.count("known_blocks") && json_a["known_blocks"].is_number_unsigned())
+            known_blocks = json_a["known_blocks"].get<uint32_t>();
+        if (json_a.count("known_transactions") && json_a["known_transactions"].is_number_unsigned())
+            known_transactions = json_a["known_transactions"].get<uint32_t>();
+        if (json_a.count("known_approves") && json_a["known_approves"].is_number_unsigned())
+            known_approves = json_a["known_approves"].get<uint32_t>();
+
     }
     catch (std::runtime_error const &)
     {
@@ -48,6 +48,11 @@ namespace mcp
 			std::vector<std::string> bootstrap_nodes;
 			std::vector<std::string> exemption_nodes;
 			bool nat;
+
+			/// hashes remembered per peer as known to it, sizes of its rolling filters
+			static uint32_t known_blocks;
+			static uint32_t known_transactions;
+			static uint32_t known_approves;
 		};
 
 		enum RLP_append
@@ -13,6 +13,7 @@ host::host(bool & error_a, p2p_config const & config_a, boost::asio::io_service
 	last_ping(std::chrono::steady_clock::time_point::min()),
 	last_try_connect(std::chrono::steady_clock::time_point::min()),
 	last_try_connect_exemption(std::chrono::steady_clock::time_point::min()),
+	last_standby_refill(std::chrono::steady_clock::time_point::min()),
 	m_peer_manager(std::make_shared<peer_manager>(error_a, application_path_a))
 {
 	if (error_a)
@@ -352,12 +353,26 @@ void host::connect(std::shared_ptr<node_info> const & ne)
 		}
 		m_connecting.push_back(handshake);
 	}
-	socket->async_connect(ep, [ne, ep, handshake, this](boost::system::error_code const& ec)
+	/// a dial to an unreachable address would otherwise wait for the os connect timeout
+	auto done(std::make_shared<std::atomic<bool>>(false));
+	auto timer(std::make_shared<ba::deadline_timer>(io_service));
+	timer->expires_from_now(handshake_timeout);
+	timer->async_wait([socket, done](boost::system::error_code const& ec)
 	{
-		if (ec)
+		if (ec || done->exchange(true))
+			return;
+		boost::system::error_code e;
+		socket->close(e);
+	});
+	socket->async_connect(ep, [ne, ep, handshake, timer, done, this](boost::system::error_code const& ec)
+	{
+		bool timed_out(done->exchange(true));
+		timer->cancel();
+		if (ec || timed_out)
 		{
 			//LOG(m_log.debug) << "Connection refused to node " << ne->id.hex() << "@" << ep << ", message: " << ec.message();
 			//m_peer_manager->record_connect(ne->id, disconnect_reason::tcp_error);
+			m_peer_manager->dial_failed(ne->id);
 		}
 		else
 		{
@@ -423,7 +438,19 @@ void host::keep_alive_peers()
 
 void host::try_connect_nodes()
 {
-	if (std::chrono::steady_clock::now() - try_connect_interval < last_try_connect)
+	size_t peer_count(0);
+	{
+		std::lock_guard<std::mutex> lock(m_peers_mutex);
+		for (auto& i : m_peers)
+			if (auto p = i.second.lock())
+				if (p->is_connected())
+					peer_count++;
+	}
+	/// a dropped peer is replaced at once, not at the next interval
+	bool dropped(peer_count < m_last_peer_count);
+	m_last_peer_count = peer_count;
+
+	if (!dropped && std::chrono::steady_clock::now() - try_connect_interval < last_try_connect)
 		return;
 
 	size_t avaliable_count = avaliable_peer_count(peer_type::egress);
@@ -446,33 +473,74 @@ void host::try_connect_nodes()
 			//only random pick one
 			auto rindex(mcp::random_pool.GenerateWord32(0, bootstrap_nodes.size() - 1));
 			auto info = bootstrap_nodes[rindex];
-			if (!m_peers.count(info->id) && m_peer_manager->should_reconnect(info->id, info->peer_type))
-			{
-				connect(info);
+			if (dial(info))
 				m_node_table->add_node(*info, true);/// mark as known peer
-			}
 		}
 
 		last_try_connect_exemption = std::chrono::steady_clock::now();
 	}
 
-	
-	if (avaliable_count > 0)
+	size_t pending(pending_dials());
+	size_t dials(std::min(avaliable_count, max_parallel_dials > pending ? max_parallel_dials - pending : 0));
+	if (dials > 0)
 	{
+		if (m_standby.size() < dials && std::chrono::steady_clock::now() - try_connect_interval_exemption > last_standby_refill)
+		{
+			m_standby.clear();
+			for (auto nf : m_peer_manager->good_peers(max_peer_size(peer_type::egress) + standby_peers))
+				if (!have_peer(nf->id))
+					m_standby.push_back(nf);
+			last_standby_refill = std::chrono::steady_clock::now();
+		}
+
+		/// good peers first
+		while (dials > 0 && !m_standby.empty())
+		{
+			std::shared_ptr<node_info> nf(m_standby.front());
+			m_standby.pop_front();
+			if (dial(nf))
+				dials--;
+		}
+
 		//random find node in node table
-		auto node_infos(m_node_table->get_random_nodes(avaliable_count));
-		for (auto nf : node_infos)
+		if (dials > 0)
 		{
-			if (!m_peers.count(nf->id) && m_peer_manager->should_reconnect(nf->id, nf->peer_type))
-			{
-				connect(nf);
-			}
+			auto node_infos(m_node_table->get_random_nodes(dials));
+			for (auto nf : node_infos)
+				dial(nf);
 		}
 	}
 
 	last_try_connect = std::chrono::steady_clock::now();
 }
 
+bool host::dial(std::shared_ptr<node_info> const & nf)
+{
+	if (have_peer(nf->id) || !m_peer_manager->can_dial(nf->id) || !m_peer_manager->should_reconnect(nf->id, nf->peer_type))
+		return false;
+
+	{
+		Guard l(x_connecting);
+		if (is_handshaking(nf->id))
+			return false;
+	}
+	connect(nf);
+	return true;
+}
+
+size_t host::pending_dials() const
+{
+	size_t count(0);
+	Guard l(x_connecting);
+	for (auto const& h : m_connecting)
+	{
+		std::shared_ptr<hankshake> const connecting = h.lock();
+		if (connecting && connecting->remote())
+			count++;
+	}
+	return count;
+}
+
 // called after successful handshake
 void host::start_peer(mcp::p2p::node_id const& _id, dev::RLP const& _rlp, std::unique_ptr<mcp::p2p::RLPXFrameCoder>&& _io, std::shared_ptr<bi::tcp::socket> const & socket)
 {
@@ -606,6 +674,7 @@ void host::start_peer(mcp::p2p::node_id const& _id, dev::RLP const& _rlp, std::u
 			new_peer->start();
 
 			m_peers[remote_node_id] = new_peer;
+			m_peer_manager->record_good(_node_info);
 		}
 	}
 	catch (std::exception const & e)
@@ -631,7 +700,8 @@ void host::on_node_table_event(node_id const & node_id_a, node_table_event_type
 		if (std::shared_ptr<node_info> nf = m_node_table->get_node(node_id_a))
 		{
 			if (!m_peers.count(nf->id) && 
-				(avaliable_peer_count(peer_type::egress) > 0 || nf->peer_type == PeerType::Required)
+				(avaliable_peer_count(peer_type::egress) > 0 || nf->peer_type == PeerType::Required) &&
+				m_peer_manager->can_dial(nf->id)
 				)
 				connect(nf);
 		}
@@ -9,6 +9,7 @@
 #include <mcp/p2p/peer_manager.hpp>
 #include <mcp/p2p/upnp.hpp>
 
+#include <deque>
 #include <unordered_map>
 
 
@@ -65,6 +66,10 @@ namespace mcp
             uint32_t max_peer_size(peer_type const & type);
             void keep_alive_peers();
             void try_connect_nodes();
+            /// connects if the node is neither a peer nor backing off, returns whether it did
+            bool dial(std::shared_ptr<node_info> const & nf);
+            /// originated connections still connecting or handshaking
+            size_t pending_dials() const;
             void start_listen(bi::address const & listen_ip, uint16_t const & port);
             void accept_loop();
 
@@ -96,12 +101,21 @@ namespace mcp
             std::chrono::seconds const keep_alive_interval = std::chrono::seconds(30);
             std::chrono::steady_clock::time_point last_ping;
 
-            std::chrono::seconds const try_connect_interval = std::chrono::seconds(3);
+            std::chrono::seconds const try_connect_interval = std::chrono::seconds(1);
 			std::chrono::seconds const try_connect_interval_exemption = std::chrono::seconds(30);
             std::chrono::steady_clock::time_point last_try_connect;
 			std::chrono::steady_clock::time_point last_try_connect_exemption;
             std::chrono::seconds node_fallback_interval = std::chrono::seconds(20);
 
+            /// connections dialed at once
+            size_t const max_parallel_dials = 16;
+            /// good peers of former sessions kept ready to replace a dropped peer, dialed before random nodes
+            size_t const standby_peers = 8;
+            std::deque<std::shared_ptr<node_info>> m_standby;
+            std::chrono::steady_clock::time_point last_standby_refill;
+            /// connected peers at the last try, fewer now means a peer dropped
+            size_t m_last_peer_count = 0;
+
             std::chrono::steady_clock::time_point start_time;
             std::vector<std::shared_ptr<node_info>> bootstrap_nodes;
             std::vector<std::shared_ptr<node_info>> exemption_nodes;
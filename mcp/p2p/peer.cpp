@@ -1,6 +1,25 @@
 #include "peer.hpp"
+#include <mcp/common/metrics.hpp>
 using namespace mcp::p2p;
 
+namespace
+{
+	mcp::metrics::gauge write_queue_bytes("mcp_p2p_write_queue_bytes", "bytes waiting in the write queues of all peers");
+	mcp::metrics::gauge read_queue_frames("mcp_p2p_read_queue_frames", "frames waiting in the read queues of all peers");
+	mcp::metrics::counter sent_bytes("mcp_p2p_sent_bytes_total", "uncompressed bytes written to peers");
+	mcp::metrics::counter sent_packets("mcp_p2p_sent_packets_total", "packets written to peers");
+	mcp::metrics::counter dropped_packets[] = {
+		{ "mcp_p2p_dropped_packets_total", "outbound packets dropped before written", "class=\"critical\"" },
+		{ "mcp_p2p_dropped_packets_total", "outbound packets dropped before written", "class=\"gossip\"" },
+		{ "mcp_p2p_dropped_packets_total", "outbound packets dropped before written", "class=\"bulk\"" }
+	};
+
+	/// bytes a class may write per round is its weight times GROUP_BUFFER_SIZE_LIMIT
+	size_t const class_weights[] = { 8, 2, 1 };
+	/// gossip waiting longer is not worth sending, the peer most likely has it from others
+	std::chrono::seconds const gossip_ttl(5);
+}
+
 peer::peer(std::shared_ptr<bi::tcp::socket> const & socket_a, node_id const & node_id_a, std::shared_ptr<peer_manager> peer_manager_a, std::unique_ptr<RLPXFrameCoder>&& _io, ba::io_service& io) :
 	socket(socket_a),
 	m_node_id(node_id_a),
@@ -18,6 +37,8 @@ peer::peer(std::shared_ptr<bi::tcp::socket> const & socket_a, node_id const & no
 peer::~peer()
 {
     LOG(m_log.debug) << "Peer deconstruction:" << m_node_id.hex();
+	write_queue_bytes.sub(surplus_size);
+	read_queue_frames.sub(read_queue.size());
 
     try {
         if (socket->is_open())
@@ -85,12 +106,37 @@ void peer::ping()
 
 std::shared_ptr<mcp::p2p::peer_metrics> mcp::p2p::peer::get_peer_metrics()
 {
-    m_pmetrics->write_write_queue_size = write_queue.size();
+	{
+		std::lock_guard<std::mutex> lock(write_queue_mutex);
+		uint64_t size(0);
+		for (size_t i = 0; i < send_class_count; i++)
+		{
+			m_pmetrics->classes[i].queue_size = write_queues[i].items.size();
+			m_pmetrics->classes[i].queue_bytes = write_queues[i].bytes;
+			size += write_queues[i].items.size();
+		}
+		m_pmetrics->write_write_queue_size = size;
+		m_pmetrics->write_queue_buffer_size = surplus_size;
+	}
 	m_pmetrics->read_read_queue_size = read_queue.size();
-	m_pmetrics->write_queue_buffer_size = surplus_size;
     return m_pmetrics;
 }
 
+uint64_t mcp::p2p::peer::get_write_queue_size()
+{
+	std::lock_guard<std::mutex> lock(write_queue_mutex);
+	uint64_t size(0);
+	for (send_queue const & q : write_queues)
+		size += q.items.size();
+	return size;
+}
+
+bool mcp::p2p::peer::bulk_full()
+{
+	std::lock_guard<std::mutex> lock(write_queue_mutex);
+	return write_queues[(size_t)send_class::bulk].bytes >= BULK_QUEUE_LIMIT;
+}
+
 bool mcp::p2p::peer::operator>(peer const & _p) const
 {
 	return *m_io > *_p.m_io;
@@ -154,6 +200,7 @@ void peer::read_loop()
 			{
 				std::lock_guard<std::mutex> lock(read_queue_mutex); 
 				read_queue.push_back(frame.toBytes());
+				read_queue_frames.add();
 				is_do_read = read_queue.size() == 1;
 			}
 			if (is_do_read)
@@ -265,6 +312,7 @@ void peer::do_read()
 		{
 			std::lock_guard<std::mutex> lock(read_queue_mutex);
 			read_queue.pop_front();
+			read_queue_frames.sub();
 
 			if (read_queue.empty())
 				return;
@@ -387,7 +435,7 @@ dev::RLPStream & peer::prep(dev::RLPStream & s, unsigned const & type, unsigned
     return s.append((unsigned)type).appendList(size);
 }
 
-void peer::send(dev::RLPStream & s)
+void peer::send(dev::RLPStream & s, send_class const & class_a)
 {
     if (is_dropped)
         return;
@@ -438,55 +486,119 @@ void peer::send(dev::RLPStream & s)
     }
 
 	m_io->writeFramePacketHeader(b);
+	size_t const index((size_t)class_a);
 	bool is_do_write(false);
 	{
 		std::lock_guard<std::mutex> lock(write_queue_mutex);
+		send_queue & q(write_queues[index]);
+		if (class_a == send_class::gossip)
+		{
+			/// newer gossip is more useful than older
+			while (!q.items.empty() && q.bytes + b.size() > GOSSIP_QUEUE_LIMIT)
+				drop_queued(class_a);
+		}
+
 		surplus_size += b.size();
-		write_queue.push_back(std::move(b));
-		is_do_write = write_queue.size() == 1;
+		write_queue_bytes.add(b.size());
+		q.bytes += b.size();
+		q.items.push_back(send_item{ std::move(b), std::chrono::steady_clock::now() });
+		is_do_write = !m_write_in_progress;
+		m_write_in_progress = true;
 	}
 
 	if (is_do_write)
 		do_write();
 }
 
+void peer::drop_queued(send_class const & class_a)
+{
+	size_t const index((size_t)class_a);
+	send_queue & q(write_queues[index]);
+	size_t const size(q.items.front().packet.size());
+	q.items.pop_front();
+	q.bytes -= size;
+	surplus_size -= size;
+	write_queue_bytes.sub(size);
+	m_pmetrics->classes[index].dropped_count++;
+	dropped_packets[index].add();
+}
+
+void peer::schedule_write()
+{
+	/// deficit round robin, a class keeps its turn until its deficit is used up or its queue is empty
+	std::chrono::steady_clock::time_point const now(std::chrono::steady_clock::now());
+	size_t group_size(0);
+	while (true)
+	{
+		send_queue & gossip(write_queues[(size_t)send_class::gossip]);
+		while (!gossip.items.empty() && now - gossip.items.front().queued > gossip_ttl)
+			drop_queued(send_class::gossip);
+
+		bool empty(true);
+		for (send_queue const & q : write_queues)
+			empty = empty && q.items.empty();
+		if (empty)
+			break;
+
+		send_queue & q(write_queues[m_next_class]);
+		if (q.items.empty())
+		{
+			q.deficit = 0;
+			q.active = false;
+			m_next_class = (m_next_class + 1) % send_class_count;
+			continue;
+		}
+
+		if (!q.active)
+		{
+			q.deficit += class_weights[m_next_class] * GROUP_BUFFER_SIZE_LIMIT;
+			q.active = true;
+		}
+
+		size_t const size(q.items.front().packet.size());
+		if (size > q.deficit)
+		{
+			/// the deficit is kept, a large packet is written after enough rounds
+			q.active = false;
+			m_next_class = (m_next_class + 1) % send_class_count;
+			continue;
+		}
+
+		if (!m_writing.empty() && group_size + size > GROUP_BUFFER_SIZE_LIMIT)
+			break;
+
+		q.deficit -= size;
+		q.bytes -= size;
+		group_size += size;
+		m_writing.push_back(std::make_pair(m_next_class, std::move(q.items.front().packet)));
+		q.items.pop_front();
+	}
+}
+
 void peer::do_write()
 {
 	if (is_dropped)
 		return;
 
 	uint32_t group_buffer_size = 0;
-	uint32_t group_item_count = 1;
 	{
 		std::lock_guard<std::mutex> lock(write_queue_mutex);
-		size_t write_queue_size = write_queue.size();
-		if (write_queue_size == 0)
+		schedule_write();
+		if (m_writing.empty())
 		{
-            LOG(m_log.info) << "do_write write_queue_size :" << write_queue_size;
+			m_write_in_progress = false;
 			return;
 		}
 
-		for (uint32_t i = 0; i < write_queue_size; i++)
-		{
-			if (i == 0)
-			{
-				group_buffer_size = write_queue[i].size();
-				continue;
-			}
-
-			if (group_buffer_size + write_queue[i].size() > GROUP_BUFFER_SIZE_LIMIT)
-				break;
-
-			group_buffer_size += write_queue[i].size();
-			group_item_count++;
-		}
+		for (auto const & item : m_writing)
+			group_buffer_size += item.second.size();
 
 		write_bufs.resize(group_buffer_size);
 		uint32_t offset = 0;
-		for (uint32_t i = 0; i < group_item_count; i++)
+		for (auto const & item : m_writing)
 		{
-			dev::bytesConstRef(write_queue[i].data(), write_queue[i].size()).copyTo(dev::bytesRef(write_bufs.data() + offset, write_queue[i].size()));
-			offset += write_queue[i].size();
+			dev::bytesConstRef(item.second.data(), item.second.size()).copyTo(dev::bytesRef(write_bufs.data() + offset, item.second.size()));
+			offset += item.second.size();
 		}
 	}	
 
@@ -504,7 +616,7 @@ void peer::do_write()
 
 	auto this_l(shared_from_this());
 	ba::async_write(*socket, ba::buffer(write_bufs),
-		[this, this_l, group_buffer_size, group_item_count](boost::system::error_code ec, std::size_t size) {
+		[this, this_l, group_buffer_size](boost::system::error_code ec, std::size_t size) {
 
 		if (is_dropped)
 			return;
@@ -516,21 +628,31 @@ void peer::do_write()
 			return;
 		}
 
-		m_pmetrics->send_size += group_buffer_size;
-		m_pmetrics->send_count += group_item_count;
-
 		{
 			std::lock_guard<std::mutex> lock(write_queue_mutex);
-			surplus_size -= group_buffer_size;
-
-			for (uint32_t i = 0; i < group_item_count; i++)
+			m_pmetrics->send_size += group_buffer_size;
+			m_pmetrics->send_count += m_writing.size();
+			sent_bytes.add(group_buffer_size);
+			sent_packets.add(m_writing.size());
+			for (auto const & item : m_writing)
 			{
-				if (!write_queue.empty())
-					write_queue.pop_front();
+				m_pmetrics->classes[item.first].send_size += item.second.size();
+				m_pmetrics->classes[item.first].send_count++;
 			}
+			m_writing.clear();
 
-			if (write_queue.empty())
+			surplus_size -= group_buffer_size;
+			write_queue_bytes.sub(group_buffer_size);
+			m_pmetrics->score.on_write_queue(surplus_size);
+
+			bool empty(true);
+			for (send_queue const & q : write_queues)
+				empty = empty && q.items.empty();
+			if (empty)
+			{
+				m_write_in_progress = false;
 				return;
+			}
 		}
 
 		do_write();
@@ -561,7 +683,11 @@ void peer::drop(disconnect_reason const & reason, bool record)
     LOG(m_log.info) << "Peer dropped reason of " << reason_of(reason) << " ,id:" << m_node_id.hex() << "@" << socket->remote_endpoint(ec);
 
 	if (record)
+	{
 		m_peer_manager->record_connect(remote_node_id(), reason);
+		if (score().responses())
+			m_peer_manager->record_rtt(remote_node_id(), (uint64_t)score().rtt());
+	}
     if (socket->is_open())
     {
         try
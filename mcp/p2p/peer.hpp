@@ -3,11 +3,16 @@
 #include <mcp/p2p/capability.hpp>
 #include <mcp/p2p/frame_coder.hpp>
 #include <mcp/p2p/peer_manager.hpp>
+#include <mcp/p2p/peer_score.hpp>
 #include "lz4.h"
 #include <libdevcore/RLP.h>
 
+#include <array>
+
 #define SEND_BUFFER_LIMIT	(100 * 1024 * 1024)
 #define GROUP_BUFFER_SIZE_LIMIT	32768
+#define GOSSIP_QUEUE_LIMIT	(4 * 1024 * 1024)
+#define BULK_QUEUE_LIMIT	(16 * 1024 * 1024)
 
 namespace mcp
 {
@@ -24,6 +29,26 @@ namespace mcp
             user_packet = 0x10
         };
 
+        /// outbound classes of a peer, written by weighted round robin so that one class can not hold back the others
+        enum class send_class : uint8_t
+        {
+            critical = 0,   /// consensus: blocks, approves, transaction requests and control packets, never dropped
+            gossip = 1,     /// transactions and peer info, dropped when stale or over GOSSIP_QUEUE_LIMIT
+            bulk = 2,       /// sync: catchup and hash trees, never dropped, the requester would blame the peer for the timeout.
+                            /// Responders wait while bulk_full, see BULK_QUEUE_LIMIT
+        };
+        size_t const send_class_count = 3;
+
+        class send_class_metrics
+        {
+        public:
+            uint64_t  queue_size = 0;
+            uint64_t  queue_bytes = 0;
+            uint64_t  send_size = 0;
+            uint64_t  send_count = 0;
+            uint64_t  dropped_count = 0;
+        };
+
         class peer_manager;
 		class RLPXFrameCoder;
         class peer_metrics
@@ -35,6 +60,8 @@ namespace mcp
             uint64_t  write_write_queue_size = 0;
 			uint64_t  read_read_queue_size = 0;
 			uint64_t  write_queue_buffer_size = 0;
+			std::array<send_class_metrics, send_class_count> classes;
+			peer_score score;
         };
 
         class peer : public std::enable_shared_from_this<peer>
@@ -47,15 +74,18 @@ namespace mcp
             void start();
             void ping();
             dev::RLPStream & prep(dev::RLPStream & s, unsigned const & type, unsigned const & size = 0);
-            void send(dev::RLPStream & s);
+            void send(dev::RLPStream & s, send_class const & class_a = send_class::critical);
             bool is_connected();
             void disconnect(disconnect_reason const & reason);
             std::chrono::steady_clock::time_point last_received();
 			std::chrono::steady_clock::time_point create_time() { return _create; }
             node_id remote_node_id() const;
             bi::tcp::endpoint remote_endpoint() const;
-            uint64_t get_write_queue_size() { return write_queue.size(); }
+            uint64_t get_write_queue_size();
+            /// the bulk queue is over BULK_QUEUE_LIMIT, sync requests of the peer are answered once it drains
+            bool bulk_full();
             std::shared_ptr<mcp::p2p::peer_metrics> get_peer_metrics();
+            peer_score & score() { return m_pmetrics->score; }
 
 			bool operator>(peer const& _p) const;
         private:
@@ -63,6 +93,9 @@ namespace mcp
             bool check_packet(dev::bytesConstRef msg);
             bool read_packet(unsigned const & type, std::shared_ptr<dev::RLP> r);
             void do_write();
+            /// moves the next packets to write to m_writing, at most GROUP_BUFFER_SIZE_LIMIT bytes unless a single packet is larger
+            void schedule_write();
+            void drop_queued(send_class const & class_a);
 			void do_read();
 			void drop(disconnect_reason const & reason, bool record = true);
 			void lz4(bytes& o_bytes);
@@ -96,7 +129,27 @@ namespace mcp
 			std::unique_ptr<RLPXFrameCoder> m_io;	///< Transport over which packets are sent.
             dev::bytes read_buffer;
 			dev::bytes read_header_buffer;
-            std::deque<dev::bytes> write_queue;
+            class send_item
+            {
+            public:
+                dev::bytes packet;
+                std::chrono::steady_clock::time_point queued;
+            };
+            class send_queue
+            {
+            public:
+                std::deque<send_item> items;
+                size_t bytes = 0;
+                /// bytes the class may still write in its turn
+                size_t deficit = 0;
+                /// the class has its turn, its quantum was added
+                bool active = false;
+            };
+            std::array<send_queue, send_class_count> write_queues;
+            size_t m_next_class = 0;
+            /// packets being written, with their class
+            std::vector<std::pair<size_t, dev::bytes>> m_writing;
+            bool m_write_in_progress = false;
             std::mutex write_queue_mutex;
 			std::deque<dev::bytes> read_queue;
 			std::mutex read_queue_mutex;
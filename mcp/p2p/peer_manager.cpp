@@ -5,6 +5,8 @@
  */
 
 #include <mcp/p2p/peer_manager.hpp>
+
+#include <algorithm>
 using namespace mcp::p2p;
 
 mcp::p2p::peer_manager::peer_manager(bool & error_a, boost::filesystem::path const & application_path_a):
@@ -56,6 +58,105 @@ void peer_manager::onHandshakeFailed(node_id const& _n, HandshakeFailureReason _
 	_peers_content.m_lastHandshakeFailure = _r;
 
 	store.peer_put(transaction, _n, _peers_content);
+
+	dial_failed(_n);
+}
+
+std::chrono::milliseconds const peer_manager::min_dial_backoff(1000);
+std::chrono::milliseconds const peer_manager::max_dial_backoff(300000);
+std::chrono::hours const peer_manager::good_peer_lifetime(30 * 24);
+
+void peer_manager::dial_failed(node_id const& id)
+{
+	std::lock_guard<std::mutex> lock(m_dial_backoff_mutex);
+	dial_backoff & backoff(m_dial_backoff[id]);
+	std::chrono::milliseconds delay(max_dial_backoff);
+	if (backoff.fails < 16)
+		delay = std::min(max_dial_backoff, min_dial_backoff * (1u << backoff.fails));
+	backoff.fails++;
+	/// +-25%, nodes which lost the same peer do not redial it in lockstep
+	uint32_t jitter(mcp::random_pool.GenerateWord32(0, delay.count() / 2));
+	backoff.next = std::chrono::steady_clock::now() + delay - delay / 4 + std::chrono::milliseconds(jitter);
+}
+
+bool peer_manager::can_dial(node_id const& id)
+{
+	std::lock_guard<std::mutex> lock(m_dial_backoff_mutex);
+	auto it(m_dial_backoff.find(id));
+	return it == m_dial_backoff.end() || std::chrono::steady_clock::now() >= it->second.next;
+}
+
+void peer_manager::record_good(node_info const& nf_a)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_dial_backoff_mutex);
+		m_dial_backoff.erase(nf_a.id);
+	}
+
+	if (nf_a.endpoint.address.is_unspecified() || !nf_a.endpoint.tcp_port)
+		return;
+
+	mcp::db::db_transaction transaction(store.create_transaction());
+	good_peer peer;
+	store.good_peer_get(transaction, nf_a.id, peer);
+	peer.endpoint = nf_a.endpoint;
+	peer.last_connected = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	peer.connects++;
+	store.good_peer_put(transaction, nf_a.id, peer);
+}
+
+void peer_manager::record_rtt(node_id const& id, uint64_t const& rtt_a)
+{
+	mcp::db::db_transaction transaction(store.create_transaction());
+	good_peer peer;
+	if (!store.good_peer_get(transaction, id, peer))
+		return;
+	peer.rtt = rtt_a;
+	store.good_peer_put(transaction, id, peer);
+}
+
+std::vector<std::shared_ptr<node_info>> peer_manager::good_peers(size_t const& limit_a)
+{
+	uint64_t const now(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+	uint64_t const lifetime(std::chrono::duration_cast<std::chrono::seconds>(good_peer_lifetime).count());
+
+	std::vector<std::pair<good_peer, node_id>> peers;
+	{
+		mcp::db::db_transaction transaction(store.create_transaction());
+		std::list<node_id> expired;
+		for (auto it = store.good_peer_begin(transaction); it.valid(); ++it)
+		{
+			node_id id(mcp::slice_to_h512(it.key()));
+			dev::bytes value((byte const *)it.value().data(), (byte const *)it.value().data() + it.value().size());
+			good_peer peer(dev::RLP(value));
+			if (peer.last_connected + lifetime < now)
+				expired.push_back(id);
+			else
+				peers.emplace_back(peer, id);
+		}
+		for (node_id const & id : expired)
+			store.good_peer_del(transaction, id);
+	}
+
+	std::sort(peers.begin(), peers.end(), [](std::pair<good_peer, node_id> const & a, std::pair<good_peer, node_id> const & b)
+	{
+		/// unknown round trip last
+		if (!a.first.rtt != !b.first.rtt)
+			return !!a.first.rtt;
+		if (a.first.rtt != b.first.rtt)
+			return a.first.rtt < b.first.rtt;
+		return a.first.last_connected > b.first.last_connected;
+	});
+
+	std::vector<std::shared_ptr<node_info>> ret;
+	for (auto const & p : peers)
+	{
+		if (ret.size() >= limit_a)
+			break;
+		if (should_reconnect(p.second, PeerType::Optional) && can_dial(p.second))
+			ret.push_back(std::make_shared<node_info>(p.second, p.first.endpoint));
+	}
+	return ret;
 }
 
 void peer_manager::clear_disconnect(node_id const& id)
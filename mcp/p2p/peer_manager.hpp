@@ -1,5 +1,7 @@
 #pragma once
 #include <chrono>
+#include <mutex>
+#include <unordered_map>
 #include <mcp/p2p/peer_store.hpp>
 
 namespace mcp
@@ -18,6 +20,18 @@ namespace mcp
 			// Set a handshake failure reason for a peer
 			void onHandshakeFailed(node_id const& _n, HandshakeFailureReason _r);
 
+			/// a dial to the node failed, it is not dialed again before its backoff elapsed
+			void dial_failed(node_id const& id);
+			/// the node is dialable, its backoff is still running
+			bool can_dial(node_id const& id);
+
+			/// a session was started with a node listening on endpoint of nf_a
+			void record_good(node_info const& nf_a);
+			/// request round trip of the session with a good peer, when it ends
+			void record_rtt(node_id const& id, uint64_t const& rtt_a);
+			/// good peers that may be reconnected, by known round trip and then by last connected
+			std::vector<std::shared_ptr<node_info>> good_peers(size_t const& limit_a);
+
 			mcp::p2p::peer_store store;
 		private:
 			unsigned fall_back_seconds(peers_content const& _p, PeerType type) const;
@@ -25,6 +39,20 @@ namespace mcp
 			void add_score(node_id const& id, disconnect_reason reason);
 
 			void clear_disconnect(node_id const& id);
+
+			/// exponential from min_dial_backoff to max_dial_backoff, with jitter
+			class dial_backoff
+			{
+			public:
+				unsigned fails = 0;
+				std::chrono::steady_clock::time_point next;
+			};
+			std::unordered_map<node_id, dial_backoff> m_dial_backoff;
+			std::mutex m_dial_backoff_mutex;
+			static std::chrono::milliseconds const min_dial_backoff;
+			static std::chrono::milliseconds const max_dial_backoff;
+			/// good peers not connected for this long are forgotten
+			static std::chrono::hours const good_peer_lifetime;
 		};
 
 	}
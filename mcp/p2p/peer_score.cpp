@@ -0,0 +1,80 @@
+#include "peer_score.hpp"
+
+#include <algorithm>
+
+using namespace mcp::p2p;
+
+void peer_score::on_response(std::chrono::milliseconds const & rtt_a, uint64_t const & bytes_a)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	double rtt = std::max<double>(rtt_a.count(), 1);
+	m_rtt += alpha * (rtt - m_rtt);
+	m_success_rate += alpha * (1 - m_success_rate);
+	m_throughput += alpha * (bytes_a * 1000.0 / rtt - m_throughput);
+	m_responses++;
+}
+
+void peer_score::on_timeout()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_success_rate -= alpha * m_success_rate;
+	m_timeouts++;
+}
+
+void peer_score::on_write_queue(uint64_t const & queued_bytes_a)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_write_queue_pressure += alpha * (queued_bytes_a - m_write_queue_pressure);
+}
+
+double peer_score::score() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	/// a request has to wait for the write queue to drain before it is answered
+	double expected = m_rtt + m_write_queue_pressure * 1000 / std::max(m_throughput, 1024.0);
+	return m_success_rate / expected;
+}
+
+bool peer_score::is_slow() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_responses + m_timeouts < min_samples)
+		return false;
+	return m_success_rate < slow_success_rate || m_rtt > slow_rtt;
+}
+
+double peer_score::rtt() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_rtt;
+}
+
+double peer_score::success_rate() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_success_rate;
+}
+
+double peer_score::throughput() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_throughput;
+}
+
+double peer_score::write_queue_pressure() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_write_queue_pressure;
+}
+
+uint64_t peer_score::responses() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_responses;
+}
+
+uint64_t peer_score::timeouts() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_timeouts;
+}
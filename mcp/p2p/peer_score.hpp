@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace mcp
+{
+	namespace p2p
+	{
+		/// EWMA based quality of a peer as target of requests (sync, missing blocks/transactions/approves)
+		class peer_score
+		{
+		public:
+			peer_score() = default;
+
+			/// a request to this peer was answered
+			void on_response(std::chrono::milliseconds const & rtt_a, uint64_t const & bytes_a);
+			/// a request to this peer stalled
+			void on_timeout();
+			/// sampled bytes waiting in the write queue of this peer
+			void on_write_queue(uint64_t const & queued_bytes_a);
+
+			/// higher is better, success rate divided by expected response time
+			double score() const;
+			/// enough samples and still mostly timing out or too slow to be useful
+			bool is_slow() const;
+
+			double rtt() const;					///ms
+			double success_rate() const;
+			double throughput() const;			///bytes per second
+			double write_queue_pressure() const;	///bytes
+			uint64_t responses() const;
+			uint64_t timeouts() const;
+
+			static constexpr double alpha = 0.2;
+			static constexpr uint64_t min_samples = 8;
+			static constexpr double slow_success_rate = 0.25;
+			static constexpr double slow_rtt = 5000; ///ms, stalled timeout of requesting
+
+		private:
+			mutable std::mutex m_mutex;
+			/// optimistic priors, new peers get a chance to be selected
+			double m_rtt = 500;
+			double m_success_rate = 1;
+			double m_throughput = 64 * 1024;
+			double m_write_queue_pressure = 0;
+			uint64_t m_responses = 0;
+			uint64_t m_timeouts = 0;
+		};
+	}
+}
@@ -20,8 +20,28 @@ dev::Slice mcp::p2p::peers_content::val() const
 	return dev::Slice((char*)this, sizeof(*this));
 }
 
+mcp::p2p::good_peer::good_peer(node_endpoint const & endpoint_a) :
+	endpoint(endpoint_a)
+{
+}
+
+mcp::p2p::good_peer::good_peer(dev::RLP const & r)
+{
+	endpoint.interpret_RLP(r[0]);
+	last_connected = r[1].toInt<uint64_t>();
+	connects = r[2].toInt<uint64_t>();
+	rtt = r[3].toInt<uint64_t>();
+}
+
+void mcp::p2p::good_peer::stream_RLP(dev::RLPStream & s) const
+{
+	s.appendList(4);
+	endpoint.stream_RLP(s);
+	s << last_connected << connects << rtt;
+}
+
 mcp::p2p::peer_store::peer_store(bool & error_a, boost::filesystem::path const& _path) :
-	m_database(std::make_shared<mcp::db::database>(_path))
+	m_database(std::make_shared<mcp::db::database>(_path, "peers"))
 {
 	if (error_a)
 		return;
@@ -34,6 +54,7 @@ mcp::p2p::peer_store::peer_store(bool & error_a, boost::filesystem::path const&
 	int default_col = m_database->create_column_family(rocksdb::kDefaultColumnFamilyName, cfops);
 	m_peers = m_database->set_column_family(default_col, "p");
 	m_nodes = m_database->set_column_family(default_col, "n");
+	m_good_peers = m_database->set_column_family(default_col, "g");
 	error_a = !m_database->open();
 	if (error_a)
 		std::cerr << "peer store db open error" << std::endl;
@@ -105,3 +126,33 @@ mcp::db::forward_iterator mcp::p2p::peer_store::node_begin(mcp::db::db_transacti
 {
 	return transaction.begin(m_nodes);
 }
+
+bool mcp::p2p::peer_store::good_peer_get(mcp::db::db_transaction & transaction, node_id const & node_id_a, good_peer & peer_a)
+{
+	std::string result;
+	bool ret = transaction.get(m_good_peers, dev::Slice((char*)node_id_a.data(), node_id_a.size), result);
+	if (ret)
+		peer_a = good_peer(dev::RLP(dev::bytesConstRef((byte const*)result.data(), result.size())));
+	return ret;
+}
+
+void mcp::p2p::peer_store::good_peer_put(mcp::db::db_transaction & transaction, node_id const & node_id_a, good_peer const & peer_a)
+{
+	dev::bytes b_value;
+	{
+		dev::RLPStream s;
+		peer_a.stream_RLP(s);
+		s.swapOut(b_value);
+	}
+	transaction.put(m_good_peers, dev::Slice((char*)node_id_a.data(), node_id_a.size), dev::Slice((char *)b_value.data(), b_value.size()));
+}
+
+void mcp::p2p::peer_store::good_peer_del(mcp::db::db_transaction & transaction, node_id const & node_id_a)
+{
+	transaction.del(m_good_peers, dev::Slice((char*)node_id_a.data(), node_id_a.size));
+}
+
+mcp::db::forward_iterator mcp::p2p::peer_store::good_peer_begin(mcp::db::db_transaction & transaction)
+{
+	return transaction.begin(m_good_peers);
+}
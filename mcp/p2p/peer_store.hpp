@@ -21,6 +21,21 @@ namespace mcp
 			HandshakeFailureReason m_lastHandshakeFailure = HandshakeFailureReason::NoFailure;  ///< Reason for most recent handshake failure
 		};
 
+		/// a peer we completed a session with, its endpoint is the one it listens on
+		class good_peer
+		{
+		public:
+			good_peer() = default;
+			good_peer(node_endpoint const & endpoint_a);
+			good_peer(dev::RLP const & r);
+			void stream_RLP(dev::RLPStream & s) const;
+
+			node_endpoint endpoint;
+			uint64_t last_connected = 0;	///seconds since epoch
+			uint64_t connects = 0;
+			uint64_t rtt = 0;				///ms, request round trip of the last session, 0 if unknown
+		};
+
 		class peer_store
 		{
 		public:
@@ -34,11 +49,17 @@ namespace mcp
 			void node_del(mcp::db::db_transaction & transaction, std::shared_ptr<node_info> nf_a);
 			mcp::db::forward_iterator node_begin(mcp::db::db_transaction& transaction);
 
+			bool good_peer_get(mcp::db::db_transaction & transaction, node_id const & node_id_a, good_peer & peer_a);
+			void good_peer_put(mcp::db::db_transaction & transaction, node_id const & node_id_a, good_peer const & peer_a);
+			void good_peer_del(mcp::db::db_transaction & transaction, node_id const & node_id_a);
+			mcp::db::forward_iterator good_peer_begin(mcp::db::db_transaction& transaction);
+
 			mcp::db::db_transaction create_transaction() { return m_database->create_transaction(); };
 		private:
 			std::shared_ptr<mcp::db::database> m_database;
 			int m_peers;
 			int m_nodes;
+			int m_good_peers;
 		};
 	}
 }
\ No newline at end of file
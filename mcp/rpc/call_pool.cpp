@@ -0,0 +1,289 @@
+#include "call_pool.hpp"
+#include "exceptions.hpp"
+#include <mcp/common/metrics.hpp>
+
+#include <libdevcore/SHA3.h>
+
+namespace
+{
+	mcp::metrics::counter call_cache_hits("mcp_rpc_call_cache_hits_total", "eth_call and eth_estimateGas answered from the result cache");
+	mcp::metrics::counter call_rejected("mcp_rpc_call_rejected_total", "eth_call and eth_estimateGas rejected, too many pending");
+	mcp::metrics::counter call_timeouts("mcp_rpc_call_timeouts_total", "eth_call and eth_estimateGas not done within the call timeout");
+	mcp::metrics::gauge call_pending("mcp_rpc_call_pending", "eth_call and eth_estimateGas waiting for a worker");
+
+	enum class request_kind : uint8_t
+	{
+		call = 0,
+		estimate_gas = 1
+	};
+
+	dev::h256 request_key(request_kind const & kind_a, uint64_t const & block_number_a, mcp::TransactionSkeleton const & ts_a)
+	{
+		dev::RLPStream s(9);
+		s << (uint8_t)kind_a << block_number_a << ts_a.from << ts_a.to << ts_a.value << ts_a.gas << ts_a.gasPrice << ts_a.nonce << ts_a.data;
+		return dev::sha3(s.out());
+	}
+
+	/// Reads through the snapshot transaction what changes as blocks become stable. The shared block cache
+	/// follows the live store, only blocks, transactions and approves are taken from it, they never change once written.
+	class snapshot_cache : public mcp::iblock_cache
+	{
+	public:
+		snapshot_cache(mcp::block_store & store_a, std::shared_ptr<mcp::block_cache> cache_a) :
+			m_store(store_a),
+			m_cache(cache_a)
+		{
+		}
+
+		bool block_exists(mcp::db::db_transaction & transaction_a, mcp::block_hash const & block_hash_a) override
+		{
+			return block_get(transaction_a, block_hash_a) != nullptr;
+		}
+
+		std::shared_ptr<mcp::block> block_get(mcp::db::db_transaction & transaction_a, mcp::block_hash const & block_hash_a) override
+		{
+			return m_cache->block_get(transaction_a, block_hash_a);
+		}
+
+		std::shared_ptr<mcp::block_state> block_state_get(mcp::db::db_transaction & transaction_a, mcp::block_hash const & block_hash_a) override
+		{
+			return m_store.block_state_get(transaction_a, block_hash_a);
+		}
+
+		std::shared_ptr<mcp::account_state> latest_account_state_get(mcp::db::db_transaction & transaction_a, Address const & account_a) override
+		{
+			h256 hash;
+			if (m_store.latest_account_state_get(transaction_a, account_a, hash))
+				return nullptr;
+			return m_store.account_state_get(transaction_a, hash);
+		}
+
+		std::shared_ptr<mcp::Transaction> transaction_get(mcp::db::db_transaction & transaction_a, h256 const & hash_a) override
+		{
+			return m_cache->transaction_get(transaction_a, hash_a);
+		}
+
+		std::shared_ptr<mcp::approve> approve_get(mcp::db::db_transaction & transaction_a, h256 const & hash_a) override
+		{
+			return m_cache->approve_get(transaction_a, hash_a);
+		}
+
+		bool transaction_exists(mcp::db::db_transaction & transaction_a, h256 const & hash_a) override
+		{
+			return m_store.transaction_get(transaction_a, hash_a) != nullptr;
+		}
+
+		bool approve_exists(mcp::db::db_transaction & transaction_a, h256 const & hash_a) override
+		{
+			return m_store.approve_get(transaction_a, hash_a) != nullptr;
+		}
+
+		bool account_nonce_get(mcp::db::db_transaction & transaction_a, Address const & account_a, u256 & nonce_a) override
+		{
+			return m_store.account_nonce_get(transaction_a, account_a, nonce_a);
+		}
+
+		bool successor_get(mcp::db::db_transaction & transaction_a, mcp::block_hash const & root_a, mcp::block_hash & successor_a) override
+		{
+			return m_store.successor_get(transaction_a, root_a, successor_a);
+		}
+
+		bool block_summary_get(mcp::db::db_transaction & transaction_a, mcp::block_hash const & block_hash_a, mcp::summary_hash & summary_a) override
+		{
+			return m_store.block_summary_get(transaction_a, block_hash_a, summary_a);
+		}
+
+	private:
+		mcp::block_store & m_store;
+		std::shared_ptr<mcp::block_cache> m_cache;
+	};
+}
+
+mcp::call_pool::call_pool(mcp::block_store & store_a, std::shared_ptr<mcp::chain> chain_a, std::shared_ptr<mcp::block_cache> cache_a, mcp::rpc_config const & config_a) :
+	m_store(store_a),
+	m_chain(chain_a),
+	m_cache(cache_a),
+	m_config(config_a),
+	m_results(config_a.call_cache_size)
+{
+}
+
+mcp::call_pool::~call_pool()
+{
+	stop();
+}
+
+void mcp::call_pool::start()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_workers.empty())
+		return;
+	m_stopped = false;
+	for (uint16_t i = 0; i < m_config.call_threads; i++)
+		m_workers.emplace_back([this]() { worker(); });
+}
+
+void mcp::call_pool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopped = true;
+		m_jobs.clear();
+	}
+	m_condition.notify_all();
+	for (auto & t : m_workers)
+		if (t.joinable())
+			t.join();
+	m_workers.clear();
+}
+
+void mcp::call_pool::on_stable()
+{
+	m_stale = true;
+}
+
+void mcp::call_pool::refresh()
+{
+	if (!m_stale.exchange(false))
+		return;
+
+	/// last_stable_index is published after the stable data is committed, a snapshot taken after reading it has that data
+	uint64_t index(m_chain->last_stable_index());
+	std::lock_guard<std::mutex> lock(m_snapshot_mutex);
+	if (m_snapshot && index == m_snapshot_index)
+	{
+		/// not committed yet
+		m_stale = true;
+		return;
+	}
+	m_snapshot = m_store.create_snapshot();
+	m_snapshot_index = index;
+	m_results.clear();
+}
+
+mcp::ExecutionResult mcp::call_pool::call(TransactionSkeleton const & ts_a, dev::eth::McInfo const & mc_info_a, uint64_t const & block_number_a)
+{
+	TransactionSkeleton ts(ts_a);
+	ts.gas = m_config.call_gas_cap;
+
+	auto chain(m_chain);
+	return run(request_key(request_kind::call, block_number_a, ts), [chain, ts, mc_info_a](mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::iblock_cache> cache_a)
+	{
+		Transaction t(ts);
+		t.setSignature(dev::h256(0), dev::h256(0), 0);
+		return result(0, chain->execute(transaction_a, cache_a, t, mc_info_a, Permanence::Uncommitted, dev::eth::OnOpFunc()).first);
+	}).second;
+}
+
+std::pair<u256, mcp::ExecutionResult> mcp::call_pool::estimate_gas(TransactionSkeleton const & ts_a, dev::eth::McInfo const & mc_info_a, uint64_t const & block_number_a)
+{
+	TransactionSkeleton ts(ts_a);
+	if (ts.gas == Invalid256 || ts.gas > m_config.call_gas_cap)
+		ts.gas = m_config.call_gas_cap;
+
+	auto chain(m_chain);
+	return run(request_key(request_kind::estimate_gas, block_number_a, ts), [chain, ts, mc_info_a](mcp::db::db_transaction & transaction_a, std::shared_ptr<mcp::iblock_cache> cache_a)
+	{
+		return chain->estimate_gas(transaction_a, cache_a, ts.from, ts.value, ts.to, ts.data, static_cast<int64_t>(ts.gas), ts.gasPrice, mc_info_a);
+	});
+}
+
+mcp::call_pool::result mcp::call_pool::run(dev::h256 const & request_key_a, execute_function const & execute_a)
+{
+	refresh();
+	{
+		uint64_t index;
+		{
+			std::lock_guard<std::mutex> lock(m_snapshot_mutex);
+			index = m_snapshot_index;
+		}
+		dev::RLPStream s(2);
+		s << request_key_a << index;
+		result cached;
+		if (m_config.call_cache_size && m_results.tryGet(dev::sha3(s.out()), cached))
+		{
+			call_cache_hits.add();
+			return cached;
+		}
+	}
+
+	std::future<result> future;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_stopped || m_jobs.size() >= max_pending)
+		{
+			call_rejected.add();
+			BOOST_THROW_EXCEPTION(RPC_Error_RequestDenied("too many pending calls, try again later"));
+		}
+		job j{ request_key_a, execute_a, std::chrono::steady_clock::now() + std::chrono::milliseconds(m_config.call_timeout), std::make_shared<std::promise<result>>() };
+		future = j.promise->get_future();
+		m_jobs.push_back(std::move(j));
+		call_pending.set(m_jobs.size());
+	}
+	m_condition.notify_one();
+
+	if (future.wait_for(std::chrono::milliseconds(m_config.call_timeout)) != std::future_status::ready)
+	{
+		call_timeouts.add();
+		BOOST_THROW_EXCEPTION(RPC_Error_TimeOut("execution timeout"));
+	}
+	return future.get();
+}
+
+void mcp::call_pool::worker()
+{
+	/// reused while the snapshot stays the same
+	std::shared_ptr<rocksdb::ManagedSnapshot> snapshot;
+	uint64_t index(0);
+	std::unique_ptr<mcp::db::db_transaction> transaction;
+	std::shared_ptr<mcp::iblock_cache> cache(std::make_shared<snapshot_cache>(m_store, m_cache));
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_stopped)
+	{
+		if (m_jobs.empty())
+		{
+			m_condition.wait(lock);
+			continue;
+		}
+
+		job j(std::move(m_jobs.front()));
+		m_jobs.pop_front();
+		call_pending.set(m_jobs.size());
+		lock.unlock();
+
+		/// skipped if the caller has given up waiting
+		if (std::chrono::steady_clock::now() < j.deadline)
+		{
+			try
+			{
+				{
+					std::lock_guard<std::mutex> snapshot_lock(m_snapshot_mutex);
+					if (!transaction || snapshot != m_snapshot)
+					{
+						snapshot = m_snapshot;
+						index = m_snapshot_index;
+						transaction.reset();
+						transaction = std::make_unique<mcp::db::db_transaction>(m_store.create_transaction());
+						transaction->set_snapshot(snapshot);
+					}
+				}
+
+				result r(j.execute(*transaction, cache));
+				if (m_config.call_cache_size)
+				{
+					dev::RLPStream s(2);
+					s << j.key << index;
+					m_results.insert(dev::sha3(s.out()), r);
+				}
+				j.promise->set_value(r);
+			}
+			catch (...)
+			{
+				j.promise->set_exception(std::current_exception());
+			}
+		}
+
+		lock.lock();
+	}
+}
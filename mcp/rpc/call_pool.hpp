@@ -0,0 +1,73 @@
+#pragma once
+
+#include "config.hpp"
+#include <mcp/common/lruc_cache.hpp>
+#include <mcp/core/block_cache.hpp>
+#include <mcp/core/block_store.hpp>
+#include <mcp/node/chain.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+
+namespace mcp
+{
+	/// Runs eth_call and eth_estimateGas on its own workers, read only against a rocksdb snapshot
+	/// pinned at the last stable index, so simulation traffic does not compete with block processing.
+	/// Results are cached per stable index.
+	class call_pool
+	{
+	public:
+		call_pool(mcp::block_store & store_a, std::shared_ptr<mcp::chain> chain_a, std::shared_ptr<mcp::block_cache> cache_a, mcp::rpc_config const & config_a);
+		~call_pool();
+		void start();
+		void stop();
+
+		/// a new stable index, the snapshot is taken again once it is committed
+		void on_stable();
+
+		/// Throw RPC_Error_RequestDenied if too many calls are pending, RPC_Error_TimeOut if not done within the call timeout.
+		/// block_number_a is the stable index mc_info_a belongs to
+		mcp::ExecutionResult call(TransactionSkeleton const & ts_a, dev::eth::McInfo const & mc_info_a, uint64_t const & block_number_a);
+		std::pair<u256, mcp::ExecutionResult> estimate_gas(TransactionSkeleton const & ts_a, dev::eth::McInfo const & mc_info_a, uint64_t const & block_number_a);
+
+	private:
+		using result = std::pair<u256, mcp::ExecutionResult>;
+		using execute_function = std::function<result(mcp::db::db_transaction &, std::shared_ptr<mcp::iblock_cache>)>;
+
+		struct job
+		{
+			dev::h256 key;
+			execute_function execute;
+			std::chrono::steady_clock::time_point deadline;
+			std::shared_ptr<std::promise<result>> promise;
+		};
+
+		result run(dev::h256 const & request_key_a, execute_function const & execute_a);
+		/// pins a new snapshot if the stable index moved since the last one
+		void refresh();
+		void worker();
+
+		static size_t const max_pending = 256;
+
+		mcp::block_store m_store;
+		std::shared_ptr<mcp::chain> m_chain;
+		std::shared_ptr<mcp::block_cache> m_cache;
+		mcp::rpc_config const m_config;
+
+		std::mutex m_snapshot_mutex;
+		std::shared_ptr<rocksdb::ManagedSnapshot> m_snapshot;
+		uint64_t m_snapshot_index = 0;
+		std::atomic<bool> m_stale = { true };
+
+		mcp::Cache<dev::h256, result, std::mutex> m_results;
+
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<job> m_jobs;
+		std::vector<std::thread> m_workers;
+		bool m_stopped = false;
+	};
+}
@@ -1,8 +1,13 @@
 #include "config.hpp"
+#include <mcp/core/config.hpp>
 
 mcp::rpc_config::rpc_config() : address(boost::asio::ip::address_v4::loopback()),
 													 port(8765),
-													 rpc_enable(false)
+													 rpc_enable(false),
+													 call_threads(2),
+													 call_gas_cap(mcp::tx_max_gas),
+													 call_timeout(5000),
+													 call_cache_size(1024)
 {
 }
 
@@ -11,6 +16,10 @@ void mcp::rpc_config::serialize_json(mcp::json &json_a) const
 	json_a["rpc"] = rpc_enable ? "true" : "false";
 	json_a["rpc_addr"] = address.to_string();
 	json_a["rpc_port"] = port;
+	json_a["call_threads"] = call_threads;
+	json_a["call_gas_cap"] = call_gas_cap;
+	json_a["call_timeout"] = call_timeout;
+	json_a["call_cache_size"] = call_cache_size;
 }
 
 bool mcp::rpc_config::deserialize_json(mcp::json const &json_a)
@@ -60,6 +69,16 @@ bool mcp::rpc_config::deserialize_json(mcp::json const &json_a)
 			{
 				error = true;
 			}
+
+			/// optional, older configs do not have them
+			if (json_a.count("call_threads") && json_a["call_threads"].is_number_unsigned())
+				call_threads = std::max<uint16_t>(1, json_a["call_threads"].get<uint16_t>());
+			if (json_a.count("call_gas_cap") && json_a["call_gas_cap"].is_number_unsigned())
+				call_gas_cap = std::min<uint64_t>(mcp::tx_max_gas, json_a["call_gas_cap"].get<uint64_t>());
+			if (json_a.count("call_timeout") && json_a["call_timeout"].is_number_unsigned())
+				call_timeout = json_a["call_timeout"].get<uint32_t>();
+			if (json_a.count("call_cache_size") && json_a["call_cache_size"].is_number_unsigned())
+				call_cache_size = json_a["call_cache_size"].get<uint32_t>();
 		}
 	}
 	catch (std::runtime_error const &)
@@ -16,5 +16,11 @@ namespace mcp
 		boost::asio::ip::address address;
 		uint16_t port;
 		bool rpc_enable;
+
+		/// eth_call and eth_estimateGas execution pool
+		uint16_t call_threads;
+		uint64_t call_gas_cap;
+		uint32_t call_timeout; //ms
+		uint32_t call_cache_size; //results
 	};
 }
@@ -1,6 +1,7 @@
 #include "connection.hpp"
 #include "handler.hpp"
 #include "exceptions.hpp"
+#include <mcp/common/metrics.hpp>
 
 const std::size_t maxRequestContentLength = 1024 * 1024 * 5;
 std::unordered_set<std::string> acceptedContentTypes = { "application/json", "application/json-rpc", "application/jsonrequest" };
@@ -15,11 +16,11 @@ void mcp::rpc_connection::parse_connection()
 	read();
 }
 
-void mcp::rpc_connection::write_result(std::string body, unsigned version, boost::beast::http::status status)
+void mcp::rpc_connection::write_result(std::string body, unsigned version, boost::beast::http::status status, std::string const & content_type)
 {
 	if (!responded.test_and_set())
 	{
-		res.set("Content-Type", "application/json");
+		res.set("Content-Type", content_type);
 		res.set("Access-Control-Allow-Origin", "*");
 		res.set("Access-Control-Allow-Headers", "Accept, Accept-Language, Content-Language, Content-Type");
 		res.set("Connection", "close");
@@ -71,6 +72,14 @@ void mcp::rpc_connection::read()
 					return;
 				}
 
+				/// prometheus scrape
+				if (this_l->request.method() == boost::beast::http::verb::get &&
+					this_l->request.target() == "/metrics")
+				{
+					this_l->response(mcp::metrics::registry::instance().render(), version, boost::beast::http::status::ok, "text/plain; version=0.0.4");
+					return;
+				}
+
 				auto validateCode = validateRequest(this_l->request);
 				if (validateCode.first != boost::beast::http::status::ok)
 				{
@@ -89,12 +98,12 @@ void mcp::rpc_connection::read()
 	});
 }
 
-void mcp::rpc_connection::response(std::string const & body, unsigned version, boost::beast::http::status status)
+void mcp::rpc_connection::response(std::string const & body, unsigned version, boost::beast::http::status status, std::string const & content_type)
 {
 	auto this_l(shared_from_this());
 	try
 	{
-		write_result(body, version, status);
+		write_result(body, version, status, content_type);
 		boost::beast::http::async_write(this_l->socket, this_l->res, [this_l](boost::system::error_code const & e, size_t size)
 		{
 		});
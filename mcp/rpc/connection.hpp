@@ -16,8 +16,8 @@ namespace mcp
 		virtual void read();
 		boost::asio::ip::tcp::socket socket;
 	private:
-		virtual void write_result(std::string body, unsigned version, boost::beast::http::status status);
-		void response(std::string const & body, unsigned version, boost::beast::http::status status);
+		virtual void write_result(std::string body, unsigned version, boost::beast::http::status status, std::string const & content_type = "application/json");
+		void response(std::string const & body, unsigned version, boost::beast::http::status status, std::string const & content_type = "application/json");
 		mcp::rpc & rpc;
 		boost::beast::flat_buffer buffer;
 		boost::beast::http::request<boost::beast::http::string_body> request;
@@ -4,6 +4,7 @@
 #include <mcp/core/genesis.hpp>
 #include <mcp/core/param.hpp>
 #include <mcp/common/pwd.hpp>
+#include <mcp/common/metrics.hpp>
 #include <mcp/node/evm/Executive.hpp>
 
 mcp::rpc_handler::rpc_handler(mcp::rpc &rpc_a, std::string const &body_a, std::function<void(mcp::json const &)> const &response_a, int m_cap) : body(body_a),
@@ -29,6 +30,7 @@ mcp::rpc_handler::rpc_handler(mcp::rpc &rpc_a, std::string const &body_a, std::f
 	m_ethRpcMethods["block_summary"] = &mcp::rpc_handler::block_summary;
 	m_ethRpcMethods["version"] = &mcp::rpc_handler::version;
 	m_ethRpcMethods["status"] = &mcp::rpc_handler::status;
+	m_ethRpcMethods["db_stats"] = &mcp::rpc_handler::db_stats;
 	m_ethRpcMethods["peers"] = &mcp::rpc_handler::peers;
 	m_ethRpcMethods["nodes"] = &mcp::rpc_handler::nodes;
 	m_ethRpcMethods["witness_list"] = &mcp::rpc_handler::witness_list;
@@ -438,6 +440,11 @@ void mcp::rpc_handler::status(mcp::json &j_response, bool &)
 	j_response["result"] = result;
 }
 
+void mcp::rpc_handler::db_stats(mcp::json &j_response, bool &)
+{
+	j_response["result"] = m_store.get_rocksdb_telemetry();
+}
+
 void mcp::rpc_handler::peers(mcp::json &j_response, bool &)
 {
 	mcp::json peers_l = mcp::json::array();
@@ -562,6 +569,28 @@ mcp::json mcp::rpc_handler::handleCallMsg(mcp::jsonrpcMessage const& req, bool&
 				BOOST_THROW_EXCEPTION(RPC_Error_MethodNotFound(_msg.c_str()));
 			}
 
+			/// method table is the same for every handler, resolve the histograms once
+			static std::unordered_map<std::string, mcp::metrics::histogram *> const latencies([this]() {
+				std::unordered_map<std::string, mcp::metrics::histogram *> result;
+				for (auto const & m : m_ethRpcMethods)
+					result[m.first] = &mcp::metrics::registry::instance().histogram("mcp_rpc_request_duration_seconds", "json rpc time from dispatch to response by method", "method=\"" + m.first + "\"");
+				return result;
+			}());
+			mcp::metrics::histogram & latency(*latencies.at(req.Method));
+			std::unique_ptr<mcp::metrics::timer_guard> tg;
+			if (async)
+			{
+				/// the method may answer later from its callback, time until the response is sent
+				std::function<void(mcp::json const &)> response_l(response);
+				std::chrono::steady_clock::time_point const start(std::chrono::steady_clock::now());
+				response = [response_l, &latency, start](mcp::json const & j_a) {
+					latency.record(std::chrono::steady_clock::now() - start);
+					response_l(j_a);
+				};
+			}
+			else
+				tg = std::make_unique<mcp::metrics::timer_guard>(latency);
+
 			params = req.Params;
 			(this->*(pointer->second))(_res, async);
 		}
@@ -633,18 +662,7 @@ void mcp::rpc_handler::eth_estimateGas(mcp::json &j_response, bool &)
 
 	mc_info.mc_timestamp = mcp::seconds_since_epoch();
 
-	mcp::db::db_transaction transaction(m_store.create_transaction());
-
-	std::pair<u256, mcp::ExecutionResult> result = m_chain->estimate_gas(
-		transaction,
-		m_cache,
-		ts.from,
-		ts.value,
-		ts.to,
-		ts.data,
-		static_cast<int64_t>(ts.gas),
-		ts.gasPrice,
-		mc_info);
+	std::pair<u256, mcp::ExecutionResult> result = rpc.m_call_pool->estimate_gas(ts, mc_info, block_number);
 	
 	mcp::ExecutionResult executionResult = result.second;
 	if (executionResult.Failed())///execution failed
@@ -799,16 +817,11 @@ void mcp::rpc_handler::eth_call(mcp::json &j_response, bool &)
 {
 	TransactionSkeleton ts = mcp::toTransactionSkeletonForEth(params[0]);
 	ts.gasPrice = 0;
-	ts.gas = mcp::tx_max_gas;
 	if (ts.nonce == Invalid256)
 		ts.nonce = m_wallet->getTransactionCount(ts.from);
 
-	Transaction t(ts);
-	t.setSignature(h256(0), h256(0), 0);
-
 	BlockNumberOrHash _b = toBlockNumberOrHash(params[1]);
 	BlockNumber block_number;
-	mcp::db::db_transaction transaction(m_store.create_transaction());
 	if (_b.Number())
 	{
 		BlockNumber _last = m_chain->last_stable_index();
@@ -820,6 +833,7 @@ void mcp::rpc_handler::eth_call(mcp::json &j_response, bool &)
 	}
 	else if (_b.Hash())
 	{
+		mcp::db::db_transaction transaction(m_store.create_transaction());
 		auto state = m_cache->block_state_get(transaction, *_b.Hash());
 		if (state == nullptr)
 			BOOST_THROW_EXCEPTION(RPC_Error_RequestDenied("header for hash not found"));
@@ -832,15 +846,8 @@ void mcp::rpc_handler::eth_call(mcp::json &j_response, bool &)
 	if (!try_get_mc_info(mc_info, block_number))
 		BOOST_THROW_EXCEPTION(RPC_Error_InvalidParams("block not found."));
 
-	std::pair<mcp::ExecutionResult, dev::eth::TransactionReceipt> result = m_chain->execute(
-		transaction,
-		m_cache,
-		t,
-		mc_info,
-		Permanence::Uncommitted,
-		dev::eth::OnOpFunc());
-
-	mcp::ExecutionResult executionResult = result.first;
+	/// gas is the call gas cap of the pool
+	mcp::ExecutionResult executionResult = rpc.m_call_pool->call(ts, mc_info, block_number);
 	if (executionResult.Failed())///execution failed
 	{
 		if (executionResult.Revert().size())///revert
@@ -852,7 +859,7 @@ void mcp::rpc_handler::eth_call(mcp::json &j_response, bool &)
 		BOOST_THROW_EXCEPTION(RPC_Error_RequestDenied(executionResult.ErrorMsg().c_str()));
 	}
 
-	j_response["result"] = toJS(result.first.output);
+	j_response["result"] = toJS(executionResult.output);
 }
 
 void mcp::rpc_handler::net_version(mcp::json &j_response, bool &)
@@ -1171,8 +1178,25 @@ void mcp::rpc_handler::eth_getLogs(mcp::json &j_response, bool &)
 
 	if (filter.toBlock() - filter.fromBlock() >= 2000)///max 2000
 		BOOST_THROW_EXCEPTION(RPC_Error_TooLargeSearchRange("Query Returned More Than 2000 Results"));//-32005 query returned more than 10000 results
+	/// stable block bundles are read in one ordered scan, indexes without one fall back to point reads
+	mcp::db::forward_iterator bundle_it(m_store.stable_block_bundle_begin(transaction, filter.fromBlock()));
 	for (uint64_t i(filter.fromBlock()); i <= filter.toBlock(); i++)
 	{
+		auto bundle(m_store.stable_block_bundle_get(bundle_it, i));
+		if (bundle)
+		{
+			for (auto const & link_index : bundle->executed_links)
+			{
+				dev::h256 const & th(bundle->block->links().at(link_index));
+				auto receipt = m_cache->transaction_receipt_get(transaction, th);
+				assert_x(receipt);
+				log_entries le = filter.matches(*receipt, *bundle->state.main_chain_index);
+				for (unsigned j = 0; j < le.size(); ++j)
+					ret.push_back(localised_log_entry(le[j], bundle->block->hash(), bundle->state.stable_index, th, link_index, j));
+			}
+			continue;
+		}
+
 		auto _block = m_cache->block_get(transaction, i);
 		if (!_block)
 			break;
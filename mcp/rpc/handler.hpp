@@ -29,6 +29,7 @@ namespace mcp
 
 		void version(mcp::json & j_response, bool & async);
 		void status(mcp::json & j_response, bool & async);
+		void db_stats(mcp::json & j_response, bool & async);
 		void peers(mcp::json & j_response, bool & async);
 		void nodes(mcp::json & j_response, bool & async);
 		void witness_list(mcp::json & j_response, bool & async);
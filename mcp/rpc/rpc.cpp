@@ -15,8 +15,14 @@ mcp::rpc::rpc(mcp::block_store &store_a, std::shared_ptr<mcp::chain> chain_a,
 																					 m_composer(composer_a),
 																					 io_service(service_a),
 																					 acceptor(service_a),
-																					 config(config_a)
+																					 config(config_a),
+																					 m_call_pool(std::make_shared<mcp::call_pool>(store_a, chain_a, cache_a, config_a))
 {
+	std::weak_ptr<mcp::call_pool> call_pool(m_call_pool);
+	m_chain->onMciStable([call_pool](uint64_t const &) {
+		if (auto pool = call_pool.lock())
+			pool->on_stable();
+	});
 }
 
 void mcp::rpc::start()
@@ -62,6 +68,16 @@ void mcp::rpc::stop()
 	acceptor.close();
 }
 
+void mcp::rpc::start_calls()
+{
+	m_call_pool->start();
+}
+
+void mcp::rpc::stop_calls()
+{
+	m_call_pool->stop();
+}
+
 std::shared_ptr<mcp::rpc> mcp::get_rpc(mcp::block_store &store_a, std::shared_ptr<mcp::chain> chain_a,
 									   std::shared_ptr<mcp::block_cache> cache_a, std::shared_ptr<mcp::key_manager> key_manager_a,
 									   std::shared_ptr<mcp::wallet> wallet_a, std::shared_ptr<mcp::p2p::host> host_a,
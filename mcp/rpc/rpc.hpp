@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config.hpp"
+#include "call_pool.hpp"
 #include <mcp/wallet/key_manager.hpp>
 #include <mcp/wallet/wallet.hpp>
 
@@ -19,6 +20,9 @@ public:
 	void start ();
 	virtual void accept ();
 	void stop ();
+	/// workers of eth_call and eth_estimateGas, used by the http and the websocket rpc
+	void start_calls ();
+	void stop_calls ();
 	boost::asio::io_service &io_service;
 	boost::asio::ip::tcp::acceptor acceptor;
 	std::mutex mutex;
@@ -31,6 +35,7 @@ public:
 	std::shared_ptr<mcp::async_task> m_background;
 	std::shared_ptr<mcp::composer> m_composer;
 	mcp::block_store m_store;
+	std::shared_ptr<mcp::call_pool> m_call_pool;
     mcp::log m_log = { mcp::log("rpc") };
 };
 
@@ -1,9 +1,24 @@
 #include "rpc_ws.hpp"
+#include "handler.hpp"
+#include <mcp/common/metrics.hpp>
+
+namespace
+{
+	mcp::metrics::gauge send_queue_bytes_gauge("mcp_rpc_ws_send_queue_bytes", "bytes waiting in the send queues of all websocket connections");
+	mcp::metrics::counter sent_messages("mcp_rpc_ws_sent_messages_total", "messages written to websocket connections");
+	mcp::metrics::counter dropped_messages("mcp_rpc_ws_dropped_messages_total", "subscription messages dropped for slow websocket connections");
+	mcp::metrics::counter slow_disconnects("mcp_rpc_ws_slow_disconnects_total", "websocket connections closed for exceeding the send queue limits");
+}
 
 mcp::rpc_ws_config::rpc_ws_config() :
 	address(boost::asio::ip::address_v4::loopback()),
 	port(mcp::rpc_ws::rpc_ws_port),
-    rpc_ws_enable(false)
+    rpc_ws_enable(false),
+	send_queue_bytes(16 * 1024 * 1024),
+	send_queue_messages(4096),
+	drop_slow(true),
+	max_inflight(32),
+	rpc_threads(std::max<unsigned>(2, std::thread::hardware_concurrency() / 2))
 {
 }
 
@@ -12,6 +27,11 @@ void mcp::rpc_ws_config::serialize_json(mcp::json & json_a) const
     json_a["ws"] = rpc_ws_enable ? "true" : "false";
     json_a["ws_addr"] =  address.to_string();
     json_a["ws_port"] = port;
+    json_a["ws_send_queue_bytes"] = send_queue_bytes;
+    json_a["ws_send_queue_messages"] = send_queue_messages;
+    json_a["ws_drop_slow"] = drop_slow ? "true" : "false";
+    json_a["ws_max_inflight"] = max_inflight;
+    json_a["ws_rpc_threads"] = rpc_threads;
 }
 
 bool mcp::rpc_ws_config::deserialize_json(mcp::json const & json_a)
@@ -61,6 +81,18 @@ bool mcp::rpc_ws_config::deserialize_json(mcp::json const & json_a)
             {
                 error = true;
             }
+
+            if (json_a.count("ws_send_queue_bytes") && json_a["ws_send_queue_bytes"].is_number_unsigned())
+                send_queue_bytes = json_a["ws_send_queue_bytes"].get<uint64_t>();
+            if (json_a.count("ws_send_queue_messages") && json_a["ws_send_queue_messages"].is_number_unsigned())
+                send_queue_messages = json_a["ws_send_queue_messages"].get<uint32_t>();
+            if (json_a.count("ws_drop_slow") && json_a["ws_drop_slow"].is_string())
+                drop_slow = (json_a["ws_drop_slow"].get<std::string>() == "true" ? true : false);
+            if (json_a.count("ws_max_inflight") && json_a["ws_max_inflight"].is_number_unsigned())
+                max_inflight = json_a["ws_max_inflight"].get<uint32_t>();
+            if (json_a.count("ws_rpc_threads") && json_a["ws_rpc_threads"].is_number_unsigned())
+                rpc_threads = json_a["ws_rpc_threads"].get<unsigned>();
+            error |= max_inflight == 0 || rpc_threads == 0;
         }
     }
     catch (std::runtime_error const &)
@@ -211,6 +243,7 @@ mcp::rpc_ws_error mcp::subscribe::unsubscription(std::string message, mcp::rpc_w
 
 void mcp::subscribe::trigger(int index, std::string data)
 {
+	auto message(std::make_shared<std::string const>(std::move(data)));
 	rLock lock(mutex);
 	std::map<int, std::list<mcp::rpc_ws_connection *> >::iterator it = mes_subscribe.find(index);
 	if (it != mes_subscribe.end())
@@ -218,7 +251,7 @@ void mcp::subscribe::trigger(int index, std::string data)
 		std::list<mcp::rpc_ws_connection *>::iterator itli = it->second.begin();
 		for (; itli != it->second.end(); itli++)
 		{
-			(*itli)->do_send(data);
+			(*itli)->do_send(message);
 		}
 	}
 }
@@ -303,11 +336,13 @@ bool mcp::subscribe::index_is_exist(int indexno)
 
 
 /*socket*/
-mcp::rpc_ws::rpc_ws(boost::asio::io_service & service_a, std::shared_ptr<mcp::async_task> background_a, mcp::rpc_ws_config const & config_a) :
+mcp::rpc_ws::rpc_ws(boost::asio::io_service & service_a, std::shared_ptr<mcp::async_task> background_a, mcp::rpc_ws_config const & config_a, std::shared_ptr<mcp::rpc> rpc_a) :
 	acceptor(service_a),
 	background(background_a),
+	m_rpc(rpc_a),
 	sock(service_a),
-	config(config_a)
+	config(config_a),
+	m_workers(config_a.rpc_threads)
 {
 }
 
@@ -359,6 +394,75 @@ void mcp::rpc_ws::on_accept(boost::system::error_code ec)
 	accept();
 }
 
+void mcp::rpc_ws::process_rpc(std::string const & body_a, std::shared_ptr<mcp::rpc_ws_connection> connection_a)
+{
+	std::shared_ptr<mcp::rpc> rpc(m_rpc);
+	auto run([rpc](std::string const & body_a, std::function<void(mcp::json const &)> const & response_a)
+	{
+		auto handler(std::make_shared<mcp::rpc_handler>(*rpc, body_a, response_a, 0));
+		handler->process_request();
+	});
+
+	mcp::json request;
+	try
+	{
+		request = mcp::json::parse(body_a);
+	}
+	catch (...)
+	{
+		/// the handler answers with a parse error
+	}
+
+	if (!request.is_array() || request.empty())
+	{
+		connection_a->begin_requests(1);
+		ba::post(m_workers, [run, body_a, connection_a]()
+		{
+			run(body_a, [connection_a](mcp::json const & j_response)
+			{
+				connection_a->send(j_response.dump());
+				connection_a->end_request();
+			});
+		});
+		return;
+	}
+
+	/// members of a batch run on their own, the batch is answered once all are done
+	struct batch_state
+	{
+		std::mutex mutex;
+		mcp::json answers;
+		size_t remaining;
+	};
+	auto batch(std::make_shared<batch_state>());
+	batch->answers = mcp::json::array();
+	for (size_t i = 0; i < request.size(); i++)
+		batch->answers.push_back(nullptr);
+	batch->remaining = request.size();
+
+	connection_a->begin_requests(request.size());
+	for (size_t i = 0; i < request.size(); i++)
+	{
+		std::string member(request[i].dump());
+		ba::post(m_workers, [run, member, i, batch, connection_a]()
+		{
+			run(member, [i, batch, connection_a](mcp::json const & j_response)
+			{
+				std::string done;
+				{
+					std::lock_guard<std::mutex> lock(batch->mutex);
+					batch->answers[i] = j_response;
+					if (--batch->remaining == 0)
+						done = batch->answers.dump();
+				}
+				if (!done.empty())
+					connection_a->send(done);
+				connection_a->end_request();
+			});
+		});
+	}
+}
+
 int mcp::rpc_ws::register_subscribe(std::string data, int index)
 {
 	return subscribe.add(data,index);
@@ -417,12 +521,18 @@ void mcp::rpc_ws::close_ws(mcp::rpc_ws_connection & conn)
 
 /*deal websocket connection */
 mcp::rpc_ws_connection::rpc_ws_connection(bi::tcp::socket sock, mcp::rpc_ws & rpc_ws_a) :
-	ws(boost::asio::make_strand(sock.get_executor())),
+	ws(std::move(sock)),
+	strand(ws.get_executor()),
 	rpc_ws(rpc_ws_a)
 {
 
 }
 
+mcp::rpc_ws_connection::~rpc_ws_connection()
+{
+	send_queue_bytes_gauge.sub(send_queue_bytes);
+}
+
 template<class ConstBufferSequence>
 std::string mcp::rpc_ws_connection::to_string(ConstBufferSequence const& bs)
 {
@@ -432,10 +542,11 @@ std::string mcp::rpc_ws_connection::to_string(ConstBufferSequence const& bs)
 void mcp::rpc_ws_connection::runloop()
 {
 	ws.async_accept(
+		ba::bind_executor(strand,
 			std::bind(
 				&rpc_ws_connection::on_accept,
 				shared_from_this(),
-				std::placeholders::_1));
+				std::placeholders::_1)));
 }
 
 void mcp::rpc_ws_connection::on_accept(boost::system::error_code ec)
@@ -455,11 +566,12 @@ void mcp::rpc_ws_connection::do_read()
 	// Read a message into our buffer
 	ws.async_read(
 		buffer,
+		ba::bind_executor(strand,
 			std::bind(
 				&rpc_ws_connection::on_read,
 				shared_from_this(),
 				std::placeholders::_1,
-				std::placeholders::_2));
+				std::placeholders::_2)));
 }
 
 void mcp::rpc_ws_connection::on_read(
@@ -468,40 +580,101 @@ void mcp::rpc_ws_connection::on_read(
 {
 	boost::ignore_unused(bytes_transferred);
 
-	// This indicates that the session was closed
-	if (ec == boost::beast::websocket::error::closed)
+	if (ec)
 	{
+		// This indicates that the session was closed
+		if (ec != boost::beast::websocket::error::closed)
+			LOG(m_log.error) << boost::str(boost::format("Error read data WebSocket RPC connections: %1%") % ec);
 		rpc_ws.close_ws(*this);
 		return;
 	}
 
-	if (ec)
-	{
-        LOG(m_log.error) << boost::str(boost::format("Error read data WebSocket RPC connections: %1%") % ec);
-	}
+	std::string body(to_string(buffer.data()));
+	buffer.consume(buffer.size());
 
-	// deal the message
-	auto handler(std::make_shared<mcp::rpc_ws_handler>(this->rpc_ws, *this, to_string(buffer.data())));
+	// deal the message, JSON-RPC requests are counted in flight until answered
+	auto handler(std::make_shared<mcp::rpc_ws_handler>(this->rpc_ws, *this, body));
 	handler->process_request();
 
-	if (strlen(handler->response.c_str()) > 0)
-	{
-		buffer.consume(buffer.size());
-		boost::beast::ostream(buffer) << handler->response;
+	if (!handler->response.empty())
+		send(handler->response);
 
-		ws.async_write(
-			buffer.data(),
-				std::bind(
-					&rpc_ws_connection::on_write,
-					shared_from_this(),
-					std::placeholders::_1,
-					std::placeholders::_2));
-	}
+	// read the next message while this one is handled, responses are sent as they complete.
+	// Reading pauses at the in flight limit and resumes in end_request, the client is held back by tcp
+	if (inflight < rpc_ws.get_config().max_inflight)
+		do_read();
 	else
+		read_paused = true;
+}
+
+void mcp::rpc_ws_connection::begin_requests(size_t const & count_a)
+{
+	inflight += count_a;
+}
+
+void mcp::rpc_ws_connection::end_request()
+{
+	auto this_l(shared_from_this());
+	ba::post(strand, [this_l]()
 	{
-		buffer.consume(buffer.size());
-		do_read();
-	}
+		this_l->inflight--;
+		if (this_l->read_paused && this_l->inflight < this_l->rpc_ws.get_config().max_inflight)
+		{
+			this_l->read_paused = false;
+			this_l->do_read();
+		}
+	});
+}
+
+void mcp::rpc_ws_connection::send(std::string const & message_a)
+{
+	send(std::make_shared<std::string const>(message_a));
+}
+
+void mcp::rpc_ws_connection::send(std::shared_ptr<std::string const> message_a, bool const & droppable_a)
+{
+	auto this_l(shared_from_this());
+	ba::post(strand, [this_l, message_a, droppable_a]()
+	{
+		mcp::rpc_ws_config const & config(this_l->rpc_ws.get_config());
+		if (!this_l->ws.is_open())
+			return;
+		if (this_l->send_queue.size() >= config.send_queue_messages
+			|| this_l->send_queue_bytes + message_a->size() > config.send_queue_bytes)
+		{
+			if (droppable_a && config.drop_slow)
+			{
+				dropped_messages.add();
+				return;
+			}
+
+			/// the pending read fails and the connection is removed from subscriptions
+			LOG(this_l->m_log.info) << "WebSocket RPC connection closed, send queue full: " << this_l->send_queue.size() << " messages, " << this_l->send_queue_bytes << " bytes";
+			slow_disconnects.add();
+			boost::system::error_code ec;
+			this_l->ws.next_layer().shutdown(bi::tcp::socket::shutdown_both, ec);
+			this_l->ws.next_layer().close(ec);
+			return;
+		}
+
+		this_l->send_queue.push_back(message_a);
+		this_l->send_queue_bytes += message_a->size();
+		send_queue_bytes_gauge.add(message_a->size());
+		if (this_l->send_queue.size() == 1)
+			this_l->write_next();
+	});
+}
+
+void mcp::rpc_ws_connection::write_next()
+{
+	ws.async_write(
+		ba::buffer(*send_queue.front()),
+		ba::bind_executor(strand,
+			std::bind(
+				&rpc_ws_connection::on_write,
+				shared_from_this(),
+				std::placeholders::_1,
+				std::placeholders::_2)));
 }
 
 void mcp::rpc_ws_connection::on_write(
@@ -513,20 +686,23 @@ void mcp::rpc_ws_connection::on_write(
 	if (ec)
 	{
         LOG(m_log.error) << boost::str(boost::format("Error write data WebSocket RPC connections: %1%") % ec);
+		send_queue_bytes_gauge.sub(send_queue_bytes);
+		send_queue_bytes = 0;
+		send_queue.clear();
 		return;
 	}
 
-	// Clear the buffer
-	buffer.consume(buffer.size());
-
-	// Do another read
-	do_read();
+	sent_messages.add();
+	send_queue_bytes -= send_queue.front()->size();
+	send_queue_bytes_gauge.sub(send_queue.front()->size());
+	send_queue.pop_front();
+	if (!send_queue.empty())
+		write_next();
 }
 
-void mcp::rpc_ws_connection::do_send(std::string res)
+void mcp::rpc_ws_connection::do_send(std::shared_ptr<std::string const> message_a)
 {
-	if(ws.is_open())
-		ws.write(boost::asio::buffer(std::string(res)));
+	send(message_a, true);
 }
 
 mcp::rpc_ws_handler::rpc_ws_handler(mcp::rpc_ws & rpc_ws_a, mcp::rpc_ws_connection & rpc_ws_connection_a, std::string body_a) :
@@ -542,6 +718,12 @@ void mcp::rpc_ws_handler::process_request()
 	try
 	{
 		request_json = mcp::json::parse(body);
+		/// JSON-RPC request or batch, subscriptions have an action
+		if (request_json.is_array() || !request_json.count("action"))
+		{
+			call();
+			return;
+		}
 		std::string action = request_json["action"];
 
 		bool handled = false;
@@ -574,6 +756,17 @@ void mcp::rpc_ws_handler::process_request()
 	get_response();
 }
 
+void mcp::rpc_ws_handler::call()
+{
+	if (!rpc_ws.serves_rpc())
+	{
+		deal_error(rpc_ws_error::action_not_exist);
+		get_response();
+		return;
+	}
+	rpc_ws.process_rpc(body, rpc_ws_connection.shared_from_this());
+}
+
 void mcp::rpc_ws_handler::get_response()
 {
 	if (response_l.size() > 0)
@@ -685,10 +878,11 @@ void mcp::rpc_ws_handler::unsubscribe()
 std::shared_ptr<mcp::rpc_ws> mcp::get_rpc_ws(
 	boost::asio::io_service & service_a, 
 	std::shared_ptr<mcp::async_task> background_a, 
-	mcp::rpc_ws_config const & config_a
+	mcp::rpc_ws_config const & config_a,
+	std::shared_ptr<mcp::rpc> rpc_a
 )
 {
-	std::shared_ptr<rpc_ws> impl(new rpc_ws(service_a, background_a, config_a));
+	std::shared_ptr<rpc_ws> impl(new rpc_ws(service_a, background_a, config_a, rpc_a));
 	return impl;
 }
 
@@ -2,6 +2,7 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/core/buffers_range.hpp>
 #include <boost/asio.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread.hpp>
 #include <boost/foreach.hpp>
@@ -12,6 +13,9 @@
 #include <mcp/core/blocks.hpp>
 #include <mcp/common/async_task.hpp>
 
+#include <deque>
+#include <thread>
+
 namespace ba = boost::asio;
 namespace bi = boost::asio::ip;
 
@@ -42,8 +46,19 @@ namespace mcp
 		boost::asio::ip::address address;
 		uint16_t port;
         bool rpc_ws_enable;
+		/// limits of the messages waiting to be written to one connection
+		uint64_t send_queue_bytes;
+		uint32_t send_queue_messages;
+		/// a subscription message over the limits is dropped if true, otherwise the connection is closed.
+		/// RPC responses are never dropped, the connection is closed
+		bool drop_slow;
+		/// JSON-RPC requests of one connection being handled, batch members count one each. Reading stops at the limit
+		uint32_t max_inflight;
+		/// threads running the JSON-RPC requests of all connections
+		unsigned rpc_threads;
 	};
 
+	class rpc;
 	class rpc_ws_connection;
 	class subscribe : public std::enable_shared_from_this<subscribe>
 	{
@@ -54,6 +69,7 @@ namespace mcp
 
 		mcp::rpc_ws_error unsubscription(std::string message, mcp::rpc_ws_connection & conn);
 
+		/// the message is serialized once and queued to every subscriber, does not wait for writes
 		void trigger(int index, std::string data);
 
 		void close_websocket(mcp::rpc_ws_connection & conn);
@@ -79,10 +95,16 @@ namespace mcp
 	class rpc_ws : public std::enable_shared_from_this<rpc_ws>
 	{
 	public:
-		rpc_ws(boost::asio::io_service & service_a, std::shared_ptr<mcp::async_task> background_a, mcp::rpc_ws_config const & config_a);
+		rpc_ws(boost::asio::io_service & service_a, std::shared_ptr<mcp::async_task> background_a, mcp::rpc_ws_config const & config_a, std::shared_ptr<mcp::rpc> rpc_a = nullptr);
 
 		void start();
 
+		/// Runs a JSON-RPC request or batch on the websocket rpc workers with the methods of the http rpc, the response is
+		/// sent when done. Requests of one connection run concurrently, batch members too, responses go out as they complete.
+		/// Called on the strand of the connection, the requests are counted in flight there.
+		void process_rpc(std::string const & body_a, std::shared_ptr<mcp::rpc_ws_connection> connection_a);
+		bool serves_rpc() const { return m_rpc != nullptr; }
+
 		int register_subscribe(std::string data,int index=0);
 
 		mcp::rpc_ws_error subscription(std::string message, mcp::rpc_ws_connection & conn);
@@ -95,6 +117,8 @@ namespace mcp
 
 		void close_ws(mcp::rpc_ws_connection & conn);
 
+		mcp::rpc_ws_config const & get_config() const { return config; }
+
 		static uint16_t const rpc_ws_port = 8764;
 
 		//register to chain
@@ -107,10 +131,14 @@ namespace mcp
 		void on_accept(boost::system::error_code ec);
 
 		std::shared_ptr<mcp::async_task> background;
+		/// nullptr if only subscriptions are served
+		std::shared_ptr<mcp::rpc> m_rpc;
 		bi::tcp::acceptor acceptor;
 		bi::tcp::socket sock;
 		mcp::rpc_ws_config config;
 		mcp::subscribe subscribe;	/*subscribe message*/
+		/// eth_call and eth_estimateGas wait here for the call pool, not on the background io_service
+		ba::thread_pool m_workers;
         mcp::log m_log = { mcp::log("rpc") };
 	};
 
@@ -121,7 +149,20 @@ namespace mcp
 
 		virtual void runloop();
 
-		void do_send(std::string res);
+		~rpc_ws_connection();
+
+		/// subscription message, may be dropped if the connection is slow
+		void do_send(std::shared_ptr<std::string const> message_a);
+
+		/// queues a message, written in order on the strand of the connection, callable from any thread.
+		/// One over the send queue limits is dropped if droppable_a and the config allows, otherwise the connection is closed
+		void send(std::shared_ptr<std::string const> message_a, bool const & droppable_a = false);
+		void send(std::string const & message_a);
+
+		/// on the strand, JSON-RPC requests dispatched for this connection
+		void begin_requests(size_t const & count_a);
+		/// callable from any thread once a request is answered, reading resumes if it was paused at the limit
+		void end_request();
 
 	private:
 		void on_accept(boost::system::error_code ec);
@@ -130,12 +171,20 @@ namespace mcp
 
 		void on_read(boost::system::error_code ec, std::size_t bytes_transferred);
 
+		void write_next();
+
 		void on_write(boost::system::error_code ec, std::size_t bytes_transferred);
 
 
 		boost::beast::websocket::stream<bi::tcp::socket> ws;
-		//ba::strand<ba::io_service::executor_type> strand;
+		ba::strand<bi::tcp::socket::executor_type> strand;
 		boost::beast::multi_buffer buffer;
+		/// the front is being written, only touched on the strand. Messages of subscriptions are shared by all connections
+		std::deque<std::shared_ptr<std::string const>> send_queue;
+		uint64_t send_queue_bytes = 0;
+		/// only touched on the strand
+		size_t inflight = 0;
+		bool read_paused = false;
 		std::string data;
 		mcp::rpc_ws & rpc_ws;
 		template<class ConstBufferSequence>
@@ -155,6 +204,9 @@ namespace mcp
 
 		void deal_error(rpc_ws_error error_Code);
 
+		/// JSON-RPC methods, answered asynchronously
+		void call();
+
 		void subscribe();
 
 		void unsubscribe();
@@ -171,7 +223,8 @@ namespace mcp
 std::shared_ptr<mcp::rpc_ws> get_rpc_ws(
 	boost::asio::io_service & service_a, 
 	std::shared_ptr<mcp::async_task> background_a, 
-	mcp::rpc_ws_config const & config_a
+	mcp::rpc_ws_config const & config_a,
+	std::shared_ptr<mcp::rpc> rpc_a = nullptr
 );
 
 }
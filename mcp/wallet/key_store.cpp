@@ -173,7 +173,7 @@ mcp::json mcp::key_content::to_json() const
 
 //store
 mcp::key_store::key_store(bool & error_a, boost::filesystem::path const& _path) :
-	m_database(std::make_shared<mcp::db::database>(_path))
+	m_database(std::make_shared<mcp::db::database>(_path, "keys"))
 {
 	if (error_a)
 		return;
@@ -742,6 +742,34 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_vrf_verify(
     const void *msg, const unsigned int msglen
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Verify a batch of VRF proofs.
+ *  Uses variable-time multiplications with the verification tables of the
+ *  context and brings the points of all the proofs to affine coordinates with
+ *  a single field inversion. Proofs rejected here may be checked again one by
+ *  one with secp256k1_vrf_verify().
+ *  Returns: 1 if every proof is valid. 0 otherwise.
+ *  Args:   ctx:     a secp256k1 context object, initialized for verification.
+ *  Out:    outputs: pointer to an array of n*32 bytes, filled with the output
+ *                   of each valid proof and zeroes for the invalid ones.
+ *          results: pointer to an array of n ints, set to 1 for each valid
+ *                   proof and 0 for each invalid one.
+ *  In:     proofs:  array of n pointers to 81-byte proofs.
+ *          pks:     array of n pointers to 33-byte serialized public keys.
+ *          msgs:    array of n pointers to the messages of the proofs.
+ *          msglens: array of n message sizes in bytes.
+ *          n:       number of proofs.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_vrf_verify_batch(
+    const secp256k1_context* ctx,
+    unsigned char *outputs,
+    int *results,
+    const unsigned char * const *proofs,
+    const unsigned char * const *pks,
+    const unsigned char * const *msgs,
+    const unsigned int *msglens,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6) SECP256K1_ARG_NONNULL(7);
+
 /** Retrieve the generated random output from a proof.
  *  Returns: 1 on success. 0 on failure.
  *  Out:    output:  pointer to a 32-byte array to be filled by the function.
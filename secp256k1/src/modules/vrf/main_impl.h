@@ -192,6 +192,42 @@ loc_exit:
 
 #endif
 
+/*
+** r = na*a + nb*b in variable time, sharing the doublings of both points.
+** Only used on public data during verification.
+*/
+static void secp256k1_vrf_ecmult_double_var(
+  const secp256k1_ecmult_context *ctx,
+  secp256k1_gej *r,
+  const secp256k1_ge *a, const secp256k1_scalar *na,
+  const secp256k1_ge *b, const secp256k1_scalar *nb
+){
+  secp256k1_gej prej[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+  secp256k1_fe zr[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+  secp256k1_ge pre_a[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+  struct secp256k1_strauss_point_state ps[2];
+#ifdef USE_ENDOMORPHISM
+  secp256k1_ge pre_a_lam[2 * ECMULT_TABLE_SIZE(WINDOW_A)];
+#endif
+  struct secp256k1_strauss_state state;
+  secp256k1_gej points[2];
+  secp256k1_scalar scalars[2];
+
+  secp256k1_gej_set_ge(&points[0], a);
+  secp256k1_gej_set_ge(&points[1], b);
+  scalars[0] = *na;
+  scalars[1] = *nb;
+
+  state.prej = prej;
+  state.zr = zr;
+  state.pre_a = pre_a;
+#ifdef USE_ENDOMORPHISM
+  state.pre_a_lam = pre_a_lam;
+#endif
+  state.ps = ps;
+  secp256k1_ecmult_strauss_wnaf(ctx, &state, r, 2, points, scalars, NULL);
+}
+
 /*
 ** Subtract one point from another by adding one to the other negated (flip sign on Y coordinate)
 */
@@ -479,3 +515,117 @@ int secp256k1_vrf_verify(
         return 0;
     }
 }
+
+/******************************************************************************/
+/** BATCH VERIFICATION ********************************************************/
+/******************************************************************************/
+
+/*
+** Computes H, Gamma, U = s*B - c*Y and V = s*H - c*Gamma of one proof.
+** U and V are left in jacobian coordinates so that the caller can bring
+** the points of all the proofs to affine with a single field inversion.
+*/
+static int vrf_verify_batch_prepare(
+    const secp256k1_ecmult_context *ecmult_ctx,
+    secp256k1_ge HGamma[2],
+    secp256k1_gej UV[2],
+    unsigned char c[16],
+    const unsigned char pi[81],
+    const unsigned char pk[33],
+    const unsigned char *alpha, const unsigned int alphalen
+){
+    unsigned char c_string[32], s_string[32];
+    secp256k1_ge Y_point;
+    secp256k1_gej Y_gej;
+    secp256k1_scalar c_scalar, s_scalar, negc_scalar;
+    int overflow = 0;
+
+    if (!vrf_validate_key(&Y_point, pk)) return 0;
+    if (!vrf_decode_proof(&HGamma[1], c_string+16, s_string, pi)) return 0;
+    memset(c_string, 0, 16);
+    memcpy(c, c_string+16, 16);
+
+    secp256k1_scalar_set_b32(&s_scalar, s_string, &overflow);
+    if (overflow || secp256k1_scalar_is_zero(&s_scalar)) return 0;
+    secp256k1_scalar_set_b32(&c_scalar, c_string, NULL);
+    if (secp256k1_scalar_is_zero(&c_scalar)) return 0;
+    secp256k1_scalar_negate(&negc_scalar, &c_scalar);
+
+    if (!vrf_hash_to_curve_tai(&HGamma[0], &Y_point, alpha, alphalen)) return 0;
+
+    /* U = s*B - c*Y */
+    secp256k1_gej_set_ge(&Y_gej, &Y_point);
+    secp256k1_ecmult(ecmult_ctx, &UV[0], &Y_gej, &negc_scalar, &s_scalar);
+    /* V = s*H - c*Gamma */
+    secp256k1_vrf_ecmult_double_var(ecmult_ctx, &UV[1], &HGamma[0], &s_scalar, &HGamma[1], &negc_scalar);
+    return 1;
+}
+
+int secp256k1_vrf_verify_batch(
+    const secp256k1_context* ctx,
+    unsigned char *outputs,
+    int *results,
+    const unsigned char * const *proofs,
+    const unsigned char * const *pks,
+    const unsigned char * const *msgs,
+    const unsigned int *msglens,
+    size_t n
+){
+    secp256k1_ge *HGamma = NULL, *UV = NULL;
+    secp256k1_gej *UV_gej = NULL;
+    unsigned char *c = NULL;
+    size_t i;
+    int all = 1;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(outputs != NULL);
+    ARG_CHECK(results != NULL);
+    ARG_CHECK(proofs != NULL);
+    ARG_CHECK(pks != NULL);
+    ARG_CHECK(msgs != NULL);
+    ARG_CHECK(msglens != NULL);
+    if (n == 0) return 1;
+
+    HGamma = (secp256k1_ge*)checked_malloc(&ctx->error_callback, 2 * n * sizeof(secp256k1_ge));
+    UV = (secp256k1_ge*)checked_malloc(&ctx->error_callback, 2 * n * sizeof(secp256k1_ge));
+    UV_gej = (secp256k1_gej*)checked_malloc(&ctx->error_callback, 2 * n * sizeof(secp256k1_gej));
+    c = (unsigned char*)checked_malloc(&ctx->error_callback, 16 * n);
+    if (!HGamma || !UV || !UV_gej || !c) {
+        for (i = 0; i < n; i++) results[i] = 0;
+        all = 0;
+        goto loc_cleanup;
+    }
+
+    for (i = 0; i < n; i++) {
+        results[i] = vrf_verify_batch_prepare(&ctx->ecmult_ctx, &HGamma[2*i], &UV_gej[2*i], &c[16*i],
+            proofs[i], pks[i], msgs[i], msglens[i]);
+        if (!results[i]) {
+            secp256k1_gej_set_infinity(&UV_gej[2*i]);
+            secp256k1_gej_set_infinity(&UV_gej[2*i+1]);
+        }
+    }
+
+    /* one inversion for the U and V points of every proof */
+    secp256k1_ge_set_all_gej_var(UV, UV_gej, 2 * n);
+
+    for (i = 0; i < n; i++) {
+        unsigned char cprime[16];
+        if (results[i]) {
+            /* c = ECVRF_hash_points(h, gamma, U, V) */
+            vrf_hash_points(cprime, &HGamma[2*i], &HGamma[2*i+1], &UV[2*i], &UV[2*i+1]);
+            results[i] = memcmp(&c[16*i], cprime, 16) == 0 && secp256k1_vrf_proof_to_hash(&outputs[32*i], proofs[i]);
+        }
+        if (!results[i]) {
+            memset(&outputs[32*i], 0, 32);
+            all = 0;
+        }
+    }
+
+loc_cleanup:
+    free(HGamma);
+    free(UV);
+    free(UV_gej);
+    free(c);
+    return all;
+}
@@ -136,6 +136,46 @@ void run_vrf_tests(void) {
     }
 
 
+    {  /* test batch verify against single verify */
+
+    unsigned char proofs[8][81], pks[8][33], outputs[8*32], single[32];
+    const unsigned char *proof_ptrs[8], *pk_ptrs[8], *msg_ptrs[8];
+    unsigned int msglens[8];
+    char msgs[8][32];
+    int results[8];
+
+    for(i=0; i<8; i++){
+      secp256k1_rand256(seckey);
+      CHECK(secp256k1_ec_pubkey_create(sender, &pubkey, seckey) == 1);
+      CHECK(secp256k1_ec_pubkey_serialize(sender, pks[i], &pklen, &pubkey, SECP256K1_EC_COMPRESSED) == 1);
+      sprintf(msgs[i], "batch%d", i);
+      msglens[i] = strlen(msgs[i]);
+      CHECK(secp256k1_vrf_prove(proofs[i], seckey, &pubkey, msgs[i], msglens[i]) == 1);
+      proof_ptrs[i] = proofs[i];
+      pk_ptrs[i] = pks[i];
+      msg_ptrs[i] = (const unsigned char *)msgs[i];
+    }
+
+    CHECK(secp256k1_vrf_verify_batch(receiver, outputs, results, proof_ptrs, pk_ptrs, msg_ptrs, msglens, 8) == 1);
+    for(i=0; i<8; i++){
+      CHECK(results[i] == 1);
+      CHECK(secp256k1_vrf_verify(single, proofs[i], pks[i], msgs[i], msglens[i]) == 1);
+      CHECK(memcmp(single, &outputs[32*i], 32) == 0);
+    }
+
+    /* a bad proof only fails its own entry */
+    proofs[3][60] ^= 0x01;
+    pk_ptrs[5] = pks[6];
+    CHECK(secp256k1_vrf_verify_batch(receiver, outputs, results, proof_ptrs, pk_ptrs, msg_ptrs, msglens, 8) == 0);
+    for(i=0; i<8; i++){
+      CHECK(results[i] == (i != 3 && i != 5));
+    }
+
+    CHECK(secp256k1_vrf_verify_batch(receiver, outputs, results, proof_ptrs, pk_ptrs, msg_ptrs, msglens, 0) == 1);
+
+    }
+
+
     {  /* test verify */
 
     unsigned char expected_output[32] = {0};
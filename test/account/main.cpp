@@ -13,6 +13,7 @@ int main(int argc, char * const * argv)
 	test_abi();
 	test_decode();
 	test_vrf();
+	test_vrf_batch();
 	test_sha512();
 	test_aes();
 	test_create_account();
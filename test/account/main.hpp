@@ -13,4 +13,5 @@ void test_secure_string();
 
 void test_abi();
 void test_decode();
-void test_vrf();
\ No newline at end of file
+void test_vrf();
+void test_vrf_batch();
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <mcp/core/common.hpp>
+#include <mcp/core/approve.hpp>
 
 void test_vrf()
 {
@@ -26,4 +27,45 @@ void test_vrf()
 	else {
 		std::cout << "[send_approve] secp256k1_vrf_verify fail" << std::endl;
 	}
-}
\ No newline at end of file
+}
+void test_vrf_batch()
+{
+	std::vector<std::shared_ptr<mcp::approve>> approves;
+	std::vector<mcp::block_hash> msgs;
+	std::vector<h256> expected;
+	for (int i = 0; i < 8; i++)
+	{
+		KeyPair key(KeyPair::create());
+		mcp::block_hash msg(dev::sha3(std::to_string(i)));
+		h648 proof;
+		if (!dev::signProve(proof, key.secret(), dev::toPublickey(key.secret()), msg))
+		{
+			std::cout << "[test_vrf_batch] signProve fail" << std::endl;
+			return;
+		}
+		h256 output;
+		dev::verify(output, proof, dev::toPublicCompressed(key.pub()), msg);
+		approves.push_back(std::make_shared<mcp::approve>(i + 1, proof, key.secret()));
+		msgs.push_back(msg);
+		expected.push_back(output);
+	}
+
+	/// a proof of the wrong message is left to vrf_verify
+	std::swap(msgs[2], msgs[5]);
+	mcp::approve::vrf_verify_batch(approves, msgs);
+	bool ok = true;
+	for (size_t i = 0; i < approves.size(); i++)
+	{
+		bool bad = i == 2 || i == 5;
+		if ((approves[i]->outputs() == expected[i]) == bad)
+			ok = false;
+	}
+	std::swap(msgs[2], msgs[5]);
+	for (size_t i = 0; i < approves.size(); i++)
+	{
+		approves[i]->vrf_verify(msgs[i]);
+		if (approves[i]->outputs() != expected[i])
+			ok = false;
+	}
+	std::cout << "[test_vrf_batch] " << (ok ? "ok" : "fail") << std::endl;
+}
@@ -0,0 +1,98 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+mcp::json bench_result::to_json() const
+{
+	mcp::json result;
+	result["name"] = name;
+	result["iterations"] = iterations;
+	result["total_ms"] = total_ms;
+	result["ns_per_op"] = ns_per_op;
+	result["ops_per_second"] = ops_per_second;
+	result["p50_ns"] = p50_ns;
+	result["p99_ns"] = p99_ns;
+	result["max_ns"] = max_ns;
+	return result;
+}
+
+bench_runner::bench_runner(std::string const & filter_a, double const & scale_a, boost::filesystem::path const & data_path_a, boost::filesystem::path const & contracts_path_a) :
+	data_path(data_path_a),
+	contracts_path(contracts_path_a),
+	m_filter(filter_a),
+	m_scale(scale_a)
+{
+}
+
+bool bench_runner::enabled(std::string const & name_a) const
+{
+	return name_a.compare(0, m_filter.size(), m_filter) == 0;
+}
+
+bool bench_runner::group_enabled(std::string const & prefix_a) const
+{
+	size_t common(std::min(prefix_a.size(), m_filter.size()));
+	return prefix_a.compare(0, common, m_filter, 0, common) == 0;
+}
+
+uint64_t bench_runner::scaled(uint64_t const & iterations_a) const
+{
+	return std::max<uint64_t>(1, iterations_a * m_scale);
+}
+
+void bench_runner::run(std::string const & name_a, uint64_t const & iterations_a, std::function<void(uint64_t const &)> const & op_a, bool const & warmup_a)
+{
+	if (!enabled(name_a))
+		return;
+
+	uint64_t iterations(scaled(iterations_a));
+	uint64_t warmup(warmup_a ? std::min<uint64_t>(iterations / 10, 1000) : 0);
+	for (uint64_t i = 0; i < warmup; i++)
+		op_a(i);
+
+	std::vector<uint64_t> samples;
+	samples.reserve(iterations);
+	for (uint64_t i = 0; i < iterations; i++)
+	{
+		auto start(std::chrono::steady_clock::now());
+		op_a(i);
+		samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+	add(name_a, std::move(samples));
+}
+
+void bench_runner::add(std::string const & name_a, std::vector<uint64_t> samples_ns_a, uint64_t const & ops_per_sample_a)
+{
+	if (!enabled(name_a) || samples_ns_a.empty())
+		return;
+
+	bench_result result;
+	result.name = name_a;
+	result.iterations = samples_ns_a.size() * ops_per_sample_a;
+
+	uint64_t total_ns(0);
+	for (auto s : samples_ns_a)
+		total_ns += s;
+	std::sort(samples_ns_a.begin(), samples_ns_a.end());
+
+	result.total_ms = total_ns / 1e6;
+	result.ns_per_op = (double)total_ns / result.iterations;
+	result.ops_per_second = total_ns ? result.iterations * 1e9 / total_ns : 0;
+	/// percentiles are per sample, i.e. per batch if a sample covers several operations
+	result.p50_ns = samples_ns_a[samples_ns_a.size() / 2];
+	result.p99_ns = samples_ns_a[std::min(samples_ns_a.size() - 1, samples_ns_a.size() * 99 / 100)];
+	result.max_ns = samples_ns_a.back();
+
+	std::cout << name_a << ": " << result.iterations << " ops, " << result.ns_per_op << " ns/op, "
+		<< result.ops_per_second << " ops/s, p99 " << result.p99_ns << " ns" << std::endl;
+	m_results.push_back(result);
+}
+
+mcp::json bench_runner::to_json() const
+{
+	mcp::json results = mcp::json::array();
+	for (auto const & r : m_results)
+		results.push_back(r.to_json());
+	return results;
+}
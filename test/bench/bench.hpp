@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mcp/common/mcp_json.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+class bench_result
+{
+public:
+	mcp::json to_json() const;
+
+	std::string name;
+	uint64_t iterations = 0;
+	double total_ms = 0;
+	double ns_per_op = 0;
+	double ops_per_second = 0;
+	uint64_t p50_ns = 0;
+	uint64_t p99_ns = 0;
+	uint64_t max_ns = 0;
+};
+
+/// runs named benchmarks and collects their results.
+/// Every operation is timed on its own, cheap operations should do a small batch per call.
+class bench_runner
+{
+public:
+	bench_runner(std::string const & filter_a, double const & scale_a, boost::filesystem::path const & data_path_a, boost::filesystem::path const & contracts_path_a);
+
+	/// false if filtered out
+	bool enabled(std::string const & name_a) const;
+	/// true if any benchmark starting with the prefix may run, to skip expensive setup
+	bool group_enabled(std::string const & prefix_a) const;
+	/// iteration count multiplied by --scale, at least 1
+	uint64_t scaled(uint64_t const & iterations_a) const;
+
+	/// op is called with the iteration index, after a short warmup unless the op consumes its input
+	void run(std::string const & name_a, uint64_t const & iterations_a, std::function<void(uint64_t const &)> const & op_a, bool const & warmup_a = true);
+	/// for operations timed by the caller, e.g. a whole batch
+	void add(std::string const & name_a, std::vector<uint64_t> samples_ns_a, uint64_t const & ops_per_sample_a = 1);
+
+	mcp::json to_json() const;
+
+	boost::filesystem::path const data_path;
+	boost::filesystem::path const contracts_path;
+
+private:
+	std::string m_filter;
+	double m_scale;
+	std::vector<bench_result> m_results;
+};
+
+void bench_rlp(bench_runner & runner_a);
+void bench_crypto(bench_runner & runner_a);
+void bench_storage(bench_runner & runner_a);
+void bench_node(bench_runner & runner_a);
@@ -0,0 +1,44 @@
+#include "bench.hpp"
+
+#include <mcp/core/config.hpp>
+#include <mcp/core/transaction.hpp>
+
+namespace
+{
+	/// keeps results alive so the measured work is not optimized away
+	volatile size_t sink;
+}
+
+void bench_crypto(bench_runner & runner_a)
+{
+	std::vector<dev::KeyPair> keys;
+	std::vector<dev::h256> hashes;
+	std::vector<dev::Signature> signatures;
+	std::vector<dev::bytes> transaction_rlps;
+	for (size_t i = 0; i < 256; i++)
+	{
+		keys.push_back(dev::KeyPair::create());
+		hashes.push_back(dev::h256::random());
+		signatures.push_back(dev::sign(keys.back().secret(), hashes.back()));
+
+		mcp::Transaction t(i, mcp::gas_price, 21000, dev::Address(dev::h160::random()), dev::bytes(), 0);
+		t.sign(keys.back().secret());
+		transaction_rlps.push_back(t.rlp());
+	}
+
+	runner_a.run("crypto_sign", 20000, [&](uint64_t const & i_a) {
+		size_t index(i_a % keys.size());
+		sink = dev::sign(keys[index].secret(), hashes[index])[0];
+	});
+
+	runner_a.run("crypto_recover", 20000, [&](uint64_t const & i_a) {
+		size_t index(i_a % keys.size());
+		sink = dev::recover(signatures[index], hashes[index])[0];
+	});
+
+	/// what every imported transaction pays: decode, hash and recover the sender
+	runner_a.run("transaction_sender", 20000, [&](uint64_t const & i_a) {
+		mcp::Transaction t(transaction_rlps[i_a % transaction_rlps.size()], mcp::CheckTransaction::None);
+		sink = t.sender()[0];
+	});
+}
@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <mcp/common/common.hpp>
+#include <mcp/core/common.hpp>
+#include <mcp/core/config.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char * const * argv)
+{
+	boost::program_options::options_description description("Benchmark options");
+	description.add_options()
+		("help", "Print out options")
+		("filter", boost::program_options::value<std::string>()->default_value(""), "Only run benchmarks whose name starts with this")
+		("scale", boost::program_options::value<double>()->default_value(1.0), "Multiplier of every iteration count")
+		("output", boost::program_options::value<std::string>(), "Write json results to this file")
+		("data_path", boost::program_options::value<std::string>(), "Directory for benchmark databases (default: new directory below working path, removed afterwards)")
+		("contracts", boost::program_options::value<std::string>()->default_value("test/contracts/mcp-uniswapv2-periphery/build"), "Directory of compiled contract json (bytecode)");
+
+	boost::program_options::variables_map vm;
+	try
+	{
+		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, description), vm);
+		boost::program_options::notify(vm);
+	}
+	catch (boost::program_options::error const & e)
+	{
+		std::cerr << e.what() << std::endl << description << std::endl;
+		return 1;
+	}
+
+	if (vm.count("help"))
+	{
+		std::cout << description << std::endl;
+		return 0;
+	}
+
+	/// no bootstrap nodes, local genesis
+	mcp::mcp_network = mcp::mcp_networks::mcp_mini_test_network;
+
+	bool remove_data(!vm.count("data_path"));
+	boost::filesystem::path data_path(remove_data ? mcp::unique_path() : boost::filesystem::path(vm["data_path"].as<std::string>()));
+	boost::filesystem::create_directories(data_path);
+
+	bench_runner runner(vm["filter"].as<std::string>(), vm["scale"].as<double>(), data_path, vm["contracts"].as<std::string>());
+	int ret(0);
+	try
+	{
+		bench_rlp(runner);
+		bench_crypto(runner);
+		bench_storage(runner);
+		bench_node(runner);
+	}
+	catch (std::exception const & e)
+	{
+		std::cerr << "Benchmark error: " << e.what() << std::endl;
+		ret = 1;
+	}
+
+	mcp::json j_result;
+	j_result["version"] = STR(MCP_VERSION);
+	j_result["timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	j_result["scale"] = vm["scale"].as<double>();
+	j_result["results"] = runner.to_json();
+
+	if (vm.count("output"))
+	{
+		std::ofstream out(vm["output"].as<std::string>());
+		out << j_result.dump(4) << std::endl;
+	}
+	else
+		std::cout << j_result.dump(4) << std::endl;
+
+	if (remove_data)
+	{
+		boost::system::error_code ec;
+		boost::filesystem::remove_all(data_path, ec);
+	}
+	return ret;
+}
@@ -0,0 +1,234 @@
+#include "bench.hpp"
+
+#include <mcp/core/contract.hpp>
+#include <mcp/core/genesis.hpp>
+#include <mcp/core/param.hpp>
+#include <mcp/core/timeout_db_transaction.hpp>
+#include <mcp/node/approve_queue.hpp>
+#include <mcp/node/chain.hpp>
+#include <mcp/node/chain_state.hpp>
+#include <mcp/node/process_block_cache.hpp>
+#include <mcp/node/transaction_queue.hpp>
+
+#include <libdevcore/CommonJS.h>
+
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	/// keeps results alive so the measured work is not optimized away
+	volatile size_t sink;
+
+	uint64_t elapsed_ns(std::chrono::steady_clock::time_point const & start_a)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_a).count();
+	}
+
+	/// creation bytecode of a compiled contract json, empty if not found
+	dev::bytes contract_bytecode(boost::filesystem::path const & contracts_path_a, std::string const & name_a)
+	{
+		std::ifstream in((contracts_path_a / (name_a + ".json")).string());
+		if (!in.is_open())
+		{
+			std::cerr << "Contract " << name_a << " not found in " << contracts_path_a << ", skipped" << std::endl;
+			return dev::bytes();
+		}
+		mcp::json j_contract(mcp::json::parse(in));
+		return dev::fromHex(j_contract["bytecode"].get<std::string>());
+	}
+
+	/// like eth_call and estimate_gas: unsigned, forced sender, zero gas price
+	mcp::Transaction call_transaction(dev::Address const & from_a, dev::Address const & to_a, dev::bytes const & data_a, dev::u256 const & nonce_a)
+	{
+		mcp::Transaction t;
+		if (to_a)
+			t = mcp::Transaction(0, 0, mcp::tx_max_gas, to_a, data_a, nonce_a);
+		else
+			t = mcp::Transaction(0, 0, mcp::tx_max_gas, data_a, nonce_a);
+		t.setSignature(dev::h256(0), dev::h256(0), 0);
+		t.forceSender(from_a);
+		return t;
+	}
+
+	/// one node worth of chain components on a fresh database, without network, witness and block processor
+	class bench_node_context
+	{
+	public:
+		bench_node_context(boost::filesystem::path const & path_a) :
+			sync_async(std::make_shared<mcp::async_task>(sync_io_service))
+		{
+			bool error(false);
+			store = std::make_unique<mcp::block_store>(error, path_a);
+			if (error)
+				throw std::runtime_error("block_store initializing error");
+
+			cache = std::make_shared<mcp::block_cache>(*store);
+			mcp::param::init(cache);
+			chain = std::make_shared<mcp::chain>(*store, cache);
+			mcp::DENCaller = mcp::NewDENContractCaller(std::bind(&mcp::chain::call, chain, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+			mcp::MainCaller = mcp::NewMainContractCaller(std::bind(&mcp::chain::call, chain, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+
+			tq = std::make_shared<mcp::TransactionQueue>(io_service, *store, cache, chain, sync_async);
+			chain->set_TQ(tq);
+			aq = std::make_shared<mcp::ApproveQueue>(*store, cache, chain, sync_async);
+			local_cache = std::make_shared<mcp::process_block_cache>(cache, *store, tq, aq);
+		}
+
+		/// commits like the block processor, flushing the process cache into block_cache
+		std::unique_ptr<mcp::timeout_db_transaction> create_transaction()
+		{
+			return std::make_unique<mcp::timeout_db_transaction>(*store, 60 * 1000, nullptr, nullptr,
+				[this]() { local_cache->mark_as_changing(); },
+				[this]() { local_cache->commit_and_clear_changing(); chain->update_cache(); });
+		}
+
+		dev::eth::McInfo genesis_mc_info()
+		{
+			mcp::db::db_transaction transaction(store->create_transaction());
+			auto gstate(store->block_state_get(transaction, mcp::genesis::block_hash));
+			return dev::eth::McInfo(0, 0, gstate->stable_timestamp, 0, dev::ZeroAddress);
+		}
+
+		boost::asio::io_service io_service;
+		boost::asio::io_service sync_io_service;
+		std::shared_ptr<mcp::async_task> sync_async;
+		std::unique_ptr<mcp::block_store> store;
+		std::shared_ptr<mcp::block_cache> cache;
+		std::shared_ptr<mcp::chain> chain;
+		std::shared_ptr<mcp::TransactionQueue> tq;
+		std::shared_ptr<mcp::ApproveQueue> aq;
+		std::shared_ptr<mcp::process_block_cache> local_cache;
+	};
+}
+
+void bench_node(bench_runner & runner_a)
+{
+	if (!runner_a.group_enabled("chain_") && !runner_a.group_enabled("tq_") && !runner_a.group_enabled("stable_") && !runner_a.group_enabled("evm_"))
+		return;
+
+	mcp::db::database::init_table_cache(256);
+	bench_node_context node(runner_a.data_path / "chaindb");
+
+	{
+		auto start(std::chrono::steady_clock::now());
+		auto timeout_tx(node.create_transaction());
+		bool error(false);
+		node.chain->init(error, *timeout_tx, node.local_cache, node.cache);
+		if (error)
+			throw std::runtime_error("chain init error");
+		timeout_tx->commit();
+		runner_a.add("chain_init_genesis", { elapsed_ns(start) });
+	}
+	dev::eth::McInfo mc_info(node.genesis_mc_info());
+
+	/// many senders with a few queued nonces each, as imported from the network
+	std::vector<dev::KeyPair> keys;
+	for (size_t i = 0; i < 1000; i++)
+		keys.push_back(dev::KeyPair::create());
+
+	if (runner_a.group_enabled("tq_"))
+	{
+		uint64_t const count(20000);
+		std::vector<std::shared_ptr<mcp::Transaction>> transactions;
+		for (size_t i = 0; i < runner_a.scaled(count); i++)
+		{
+			auto t(std::make_shared<mcp::Transaction>(1, mcp::gas_price, 21000, keys[(i + 1) % keys.size()].address(), dev::bytes(), i / keys.size()));
+			t->sign(keys[i % keys.size()].secret());
+			transactions.push_back(t);
+		}
+
+		/// sync source skips the balance check, the senders are not funded
+		runner_a.run("tq_import", count, [&](uint64_t const & i_a) {
+			sink = (size_t)node.tq->import(transactions[i_a], mcp::source::sync);
+		}, false);
+	}
+
+	if (runner_a.group_enabled("stable_"))
+	{
+		/// what set_block_stable does for every linked transaction: execute, commit state, then commit the db transaction
+		{
+			auto timeout_tx(node.create_transaction());
+			mcp::AccountMap accounts;
+			for (auto const & k : keys)
+				accounts[k.address()] = std::make_shared<mcp::account_state>(k.address(), dev::h256(0), dev::h256(0), 0, dev::u256(1) << 100);
+			mcp::overlay_db db(timeout_tx->get_transaction(), *node.store);
+			mcp::commit(timeout_tx->get_transaction(), accounts, &db, node.local_cache, *node.store, dev::h256(0));
+			timeout_tx->commit();
+		}
+
+		size_t const block_size(1000);
+		size_t const blocks(runner_a.scaled(10));
+		std::vector<mcp::Transaction> transfers;
+		for (size_t i = 0; i < block_size * blocks; i++)
+		{
+			mcp::Transaction t(1, mcp::gas_price, 21000, dev::Address(dev::h160::random()), dev::bytes(), i / keys.size());
+			t.sign(keys[i % keys.size()].secret());
+			transfers.push_back(t);
+		}
+
+		std::vector<uint64_t> samples;
+		for (size_t b = 0; b < blocks; b++)
+		{
+			auto start(std::chrono::steady_clock::now());
+			auto timeout_tx(node.create_transaction());
+			for (size_t i = b * block_size; i < (b + 1) * block_size; i++)
+			{
+				auto result(node.chain->execute(timeout_tx->get_transaction(), node.local_cache, transfers[i], mc_info, mcp::Permanence::Committed, dev::eth::OnOpFunc()));
+				sink = result.second.statusCode();
+			}
+			timeout_tx->commit();
+			samples.push_back(elapsed_ns(start));
+		}
+		runner_a.add("stable_execute_transfers", samples, block_size);
+	}
+
+	if (runner_a.group_enabled("evm_"))
+	{
+		dev::Address deployer(dev::KeyPair::create().address());
+		dev::bytes weth9(contract_bytecode(runner_a.contracts_path, "WETH9"));
+		dev::bytes erc20(contract_bytecode(runner_a.contracts_path, "ERC20"));
+
+		auto timeout_tx(node.create_transaction());
+		mcp::db::db_transaction & transaction(timeout_tx->get_transaction());
+
+		if (!weth9.empty())
+		{
+			runner_a.run("evm_deploy_weth9", 1000, [&](uint64_t const &) {
+				auto result(node.chain->execute(transaction, node.local_cache, call_transaction(deployer, dev::Address(), weth9, 0), mc_info, mcp::Permanence::Reverted, dev::eth::OnOpFunc()));
+				sink = result.second.statusCode();
+			});
+		}
+
+		if (!erc20.empty())
+		{
+			/// constructor(uint _totalSupply)
+			dev::bytes init(erc20);
+			dev::bytes supply(dev::h256(dev::u256(1) << 128).asBytes());
+			init.insert(init.end(), supply.begin(), supply.end());
+
+			runner_a.run("evm_deploy_erc20", 1000, [&](uint64_t const &) {
+				auto result(node.chain->execute(transaction, node.local_cache, call_transaction(deployer, dev::Address(), init, 0), mc_info, mcp::Permanence::Reverted, dev::eth::OnOpFunc()));
+				sink = result.second.statusCode();
+			});
+
+			auto deployed(node.chain->execute(transaction, node.local_cache, call_transaction(deployer, dev::Address(), init, 0), mc_info, mcp::Permanence::Committed, dev::eth::OnOpFunc()));
+			if (!deployed.second.statusCode())
+				throw std::runtime_error("ERC20 deployment failed");
+			dev::Address token(dev::toAddress(deployer, 0));
+
+			/// transfer(address,uint256), reverted so every iteration touches the same storage slots
+			dev::bytes transfer(dev::fromHex("a9059cbb"));
+			dev::bytes to(dev::h256(dev::KeyPair::create().address(), dev::h256::AlignRight).asBytes());
+			dev::bytes amount(dev::h256(dev::u256(1000)).asBytes());
+			transfer.insert(transfer.end(), to.begin(), to.end());
+			transfer.insert(transfer.end(), amount.begin(), amount.end());
+
+			runner_a.run("evm_erc20_transfer", 20000, [&](uint64_t const &) {
+				auto result(node.chain->execute(transaction, node.local_cache, call_transaction(deployer, token, transfer, 1), mc_info, mcp::Permanence::Reverted, dev::eth::OnOpFunc()));
+				sink = result.second.statusCode();
+			});
+		}
+		timeout_tx->rollback();
+	}
+}
@@ -0,0 +1,68 @@
+#include "bench.hpp"
+
+#include <mcp/core/blocks.hpp>
+#include <mcp/core/config.hpp>
+
+namespace
+{
+	/// keeps results alive so the measured work is not optimized away
+	volatile size_t sink;
+
+	dev::h256s random_hashes(size_t const & count_a)
+	{
+		dev::h256s result;
+		for (size_t i = 0; i < count_a; i++)
+			result.push_back(dev::h256::random());
+		return result;
+	}
+}
+
+void bench_rlp(bench_runner & runner_a)
+{
+	dev::KeyPair key(dev::KeyPair::create());
+
+	/// transfer sized and contract call sized transactions
+	std::vector<dev::bytes> transaction_rlps;
+	std::vector<mcp::Transaction> transactions;
+	for (size_t i = 0; i < 256; i++)
+	{
+		dev::bytes data(i % 2 ? dev::bytes() : dev::bytes(68 + i, 0xab));
+		mcp::Transaction t(i, mcp::gas_price, mcp::tx_max_gas, dev::Address(dev::h160::random()), data, i);
+		t.sign(key.secret());
+		transaction_rlps.push_back(t.rlp());
+		transactions.push_back(t);
+	}
+
+	runner_a.run("rlp_transaction_encode", 200000, [&](uint64_t const & i_a) {
+		sink = transactions[i_a % transactions.size()].rlp().size();
+	});
+
+	runner_a.run("rlp_transaction_decode", 200000, [&](uint64_t const & i_a) {
+		mcp::Transaction t(transaction_rlps[i_a % transaction_rlps.size()], mcp::CheckTransaction::None);
+		sink = t.data().size();
+	});
+
+	/// a witness block with a full link list
+	std::vector<mcp::block_hash> parents(random_hashes(4));
+	mcp::block b(key.address(), dev::h256::random(), parents, random_hashes(1000), random_hashes(14),
+		dev::h256::random(), dev::h256::random(), dev::h256::random(), 1700625600, key.secret());
+	dev::RLPStream block_stream;
+	b.streamRLP(block_stream);
+	dev::bytes block_rlp(block_stream.out());
+
+	runner_a.run("rlp_block_encode", 20000, [&](uint64_t const &) {
+		dev::RLPStream s;
+		b.streamRLP(s);
+		sink = s.out().size();
+	});
+
+	runner_a.run("rlp_block_decode", 20000, [&](uint64_t const &) {
+		mcp::block decoded{ dev::RLP(block_rlp) };
+		sink = decoded.links().size();
+	});
+
+	runner_a.run("block_hash", 20000, [&](uint64_t const &) {
+		mcp::block decoded{ dev::RLP(block_rlp) };
+		sink = decoded.hash()[0];
+	});
+}
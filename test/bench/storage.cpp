@@ -0,0 +1,92 @@
+#include "bench.hpp"
+
+#include <mcp/core/block_cache.hpp>
+#include <mcp/core/block_store.hpp>
+#include <mcp/core/config.hpp>
+
+namespace
+{
+	/// keeps results alive so the measured work is not optimized away
+	volatile size_t sink;
+}
+
+void bench_storage(bench_runner & runner_a)
+{
+	if (!runner_a.group_enabled("db_") && !runner_a.group_enabled("cache_"))
+		return;
+
+	mcp::db::database::init_table_cache(256);
+	bool error(false);
+	mcp::block_store store(error, runner_a.data_path / "storage");
+	if (error)
+		throw std::runtime_error("block_store initializing error");
+
+	dev::KeyPair key(dev::KeyPair::create());
+	std::vector<std::shared_ptr<mcp::Transaction>> transactions;
+	for (size_t i = 0; i < runner_a.scaled(100000); i++)
+	{
+		auto t(std::make_shared<mcp::Transaction>(i, mcp::gas_price, 21000, dev::Address(dev::h160::random()), dev::bytes(), i));
+		t->sign(key.secret());
+		transactions.push_back(t);
+	}
+
+	/// writes are committed in batches like the block processor does
+	size_t const batch_size(100);
+	{
+		std::vector<uint64_t> samples;
+		for (size_t i = 0; i + batch_size <= transactions.size(); i += batch_size)
+		{
+			auto start(std::chrono::steady_clock::now());
+			mcp::db::db_transaction transaction(store.create_transaction());
+			for (size_t j = i; j < i + batch_size; j++)
+				store.transaction_put(transaction, transactions[j]->sha3(), *transactions[j]);
+			transaction.commit();
+			samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+		runner_a.add("db_transaction_put", samples, batch_size);
+	}
+
+	{
+		mcp::db::db_transaction transaction(store.create_transaction());
+		runner_a.run("db_transaction_get", 100000, [&](uint64_t const & i_a) {
+			auto t(store.transaction_get(transaction, transactions[(i_a * 7919) % transactions.size()]->sha3()));
+			sink = t->nonce() != 0;
+		});
+
+		runner_a.run("db_transaction_get_missing", 100000, [&](uint64_t const &) {
+			sink = store.transaction_get(transaction, dev::h256::random()) != nullptr;
+		});
+	}
+
+	mcp::block_cache cache(store);
+	{
+		mcp::db::db_transaction transaction(store.create_transaction());
+		/// hot set well below the cache capacity
+		size_t const hot(std::min<size_t>(transactions.size(), 1000));
+		for (size_t i = 0; i < hot; i++)
+			cache.transaction_get(transaction, transactions[i]->sha3());
+
+		runner_a.run("cache_transaction_hit", 200000, [&](uint64_t const & i_a) {
+			sink = cache.transaction_get(transaction, transactions[i_a % hot]->sha3()) != nullptr;
+		});
+
+		/// strided over far more transactions than the cache holds, every lookup goes to the store
+		if (transactions.size() > hot)
+		{
+			runner_a.run("cache_transaction_miss", 100000, [&](uint64_t const & i_a) {
+				sink = cache.transaction_get(transaction, transactions[hot + (i_a * 7919) % (transactions.size() - hot)]->sha3()) != nullptr;
+			});
+		}
+
+		std::vector<dev::Address> accounts;
+		for (size_t i = 0; i < hot; i++)
+			accounts.push_back(dev::Address(dev::h160::random()));
+		for (size_t i = 0; i < hot; i++)
+			cache.account_nonce_put(accounts[i], i);
+
+		runner_a.run("cache_account_nonce_hit", 200000, [&](uint64_t const & i_a) {
+			dev::u256 nonce;
+			sink = cache.account_nonce_get(transaction, accounts[i_a % hot], nonce);
+		});
+	}
+}
@@ -0,0 +1,434 @@
+#include "loadgen.hpp"
+
+#include <mcp/common/common.hpp>
+#include <mcp/core/config.hpp>
+#include <mcp/core/transaction.hpp>
+
+#include <libdevcore/CommonJS.h>
+#include <libdevcore/SHA3.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+	using steady_clock = std::chrono::steady_clock;
+
+	/// counter contract, every call increments storage slot 0.
+	/// Init code copies the 10 byte runtime (PUSH1 1 PUSH1 0 SLOAD ADD PUSH1 0 SSTORE STOP) and returns it.
+	std::string const counter_contract("0x600a600c600039600a6000f360016000540160005500");
+
+	uint64_t const transfer_gas(21000);
+	uint64_t const call_gas(100000);
+	uint64_t const deploy_gas(200000);
+
+	class signed_transaction
+	{
+	public:
+		dev::h256 hash;
+		std::string rlp;
+	};
+
+	signed_transaction sign(mcp::Transaction & t_a, dev::Secret const & secret_a)
+	{
+		t_a.sign(secret_a);
+		return signed_transaction{ t_a.sha3(), dev::toHexPrefixed(t_a.rlp()) };
+	}
+
+	/// sent transactions waiting for their stable receipt
+	class tracker
+	{
+	public:
+		void sent(dev::h256 const & hash_a, steady_clock::time_point const & time_a)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_first_sent || time_a < *m_first_sent)
+				m_first_sent = time_a;
+			m_pending.emplace(hash_a, time_a);
+			m_order.push_back(hash_a);
+			accepted++;
+		}
+
+		void rejected(std::string const & error_a)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_errors[error_a]++;
+			rejected_count++;
+		}
+
+		/// oldest pending hashes, these are the next to become stable
+		std::vector<dev::h256> oldest(size_t const & count_a)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			while (!m_order.empty() && !m_pending.count(m_order.front()))
+				m_order.pop_front();
+
+			std::vector<dev::h256> result;
+			for (auto it(m_order.begin()); it != m_order.end() && result.size() < count_a; ++it)
+			{
+				if (m_pending.count(*it))
+					result.push_back(*it);
+			}
+			return result;
+		}
+
+		void stable(dev::h256 const & hash_a, bool const & success_a, steady_clock::time_point const & time_a)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it(m_pending.find(hash_a));
+			if (it == m_pending.end())
+				return;
+			m_latencies_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(time_a - it->second).count());
+			m_pending.erase(it);
+			m_last_stable = time_a;
+			if (!success_a)
+				failed++;
+		}
+
+		size_t pending()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_pending.size();
+		}
+
+		mcp::json to_json()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			mcp::json result;
+			result["accepted"] = accepted.load();
+			result["rejected"] = rejected_count.load();
+			result["stable"] = m_latencies_us.size();
+			result["failed"] = failed.load();
+			result["timed_out"] = m_pending.size();
+
+			double stable_seconds(m_first_sent && m_last_stable ? std::chrono::duration<double>(*m_last_stable - *m_first_sent).count() : 0);
+			result["stable_seconds"] = stable_seconds;
+			result["stable_tps"] = stable_seconds > 0 ? m_latencies_us.size() / stable_seconds : 0;
+
+			mcp::json j_latency;
+			if (!m_latencies_us.empty())
+			{
+				std::vector<uint64_t> sorted(m_latencies_us);
+				std::sort(sorted.begin(), sorted.end());
+				uint64_t total(0);
+				for (auto l : sorted)
+					total += l;
+				auto percentile = [&sorted](size_t const & p_a) { return sorted[std::min(sorted.size() - 1, sorted.size() * p_a / 100)] / 1000.0; };
+				j_latency["mean"] = total / 1000.0 / sorted.size();
+				j_latency["p50"] = percentile(50);
+				j_latency["p90"] = percentile(90);
+				j_latency["p99"] = percentile(99);
+				j_latency["max"] = sorted.back() / 1000.0;
+			}
+			result["latency_ms"] = j_latency;
+
+			mcp::json j_errors = mcp::json::object();
+			for (auto const & e : m_errors)
+				j_errors[e.first] = e.second;
+			result["errors"] = j_errors;
+			return result;
+		}
+
+		std::atomic<uint64_t> accepted = { 0 };
+		std::atomic<uint64_t> rejected_count = { 0 };
+		std::atomic<uint64_t> failed = { 0 };
+
+	private:
+		std::mutex m_mutex;
+		std::unordered_map<dev::h256, steady_clock::time_point> m_pending;
+		std::deque<dev::h256> m_order;
+		std::vector<uint64_t> m_latencies_us;
+		std::map<std::string, uint64_t> m_errors;
+		boost::optional<steady_clock::time_point> m_first_sent;
+		boost::optional<steady_clock::time_point> m_last_stable;
+	};
+
+	/// sends in batches and waits until every transaction is stable, throws if any fails
+	void send_and_wait(rpc_client & client_a, std::vector<signed_transaction> const & transactions_a, size_t const & batch_a, std::chrono::seconds const & timeout_a)
+	{
+		for (size_t i = 0; i < transactions_a.size(); i += batch_a)
+		{
+			std::vector<mcp::json> params;
+			for (size_t j = i; j < std::min(i + batch_a, transactions_a.size()); j++)
+				params.push_back(mcp::json::array({ transactions_a[j].rlp }));
+			std::vector<std::string> errors;
+			client_a.batch("eth_sendRawTransaction", params, &errors);
+			for (auto const & e : errors)
+			{
+				if (!e.empty())
+					throw std::runtime_error("eth_sendRawTransaction: " + e);
+			}
+		}
+
+		std::unordered_set<dev::h256> pending;
+		for (auto const & t : transactions_a)
+			pending.insert(t.hash);
+
+		auto deadline(steady_clock::now() + timeout_a);
+		while (!pending.empty())
+		{
+			if (steady_clock::now() > deadline)
+				throw std::runtime_error(std::to_string(pending.size()) + " setup transactions not stable in time");
+
+			std::vector<dev::h256> hashes(pending.begin(), pending.end());
+			hashes.resize(std::min<size_t>(hashes.size(), 1000));
+			std::vector<mcp::json> params;
+			for (auto const & h : hashes)
+				params.push_back(mcp::json::array({ dev::toJS(h) }));
+
+			auto receipts(client_a.batch("eth_getTransactionReceipt", params));
+			for (size_t i = 0; i < hashes.size(); i++)
+			{
+				if (receipts[i].is_null())
+					continue;
+				if (dev::jsToU256(receipts[i]["status"].get<std::string>()) != 1)
+					throw std::runtime_error("setup transaction failed: " + dev::toJS(hashes[i]));
+				pending.erase(hashes[i]);
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		}
+	}
+
+	std::vector<std::string> rpc_endpoints(boost::program_options::variables_map const & vm_a, std::string & seed_a)
+	{
+		std::vector<std::string> endpoints;
+		if (vm_a.count("rpc"))
+			boost::split(endpoints, vm_a["rpc"].as<std::string>(), boost::is_any_of(","));
+		else if (boost::filesystem::exists(boost::filesystem::path(vm_a["dir"].as<std::string>()) / "testnet.json"))
+		{
+			/// nodes of a generated testnet
+			std::ifstream in((boost::filesystem::path(vm_a["dir"].as<std::string>()) / "testnet.json").string());
+			mcp::json j_testnet(mcp::json::parse(in));
+			for (auto const & n : j_testnet["nodes"])
+				endpoints.push_back(n["rpc"].get<std::string>());
+			if (vm_a["seed"].defaulted())
+				seed_a = j_testnet["seed"].get<std::string>();
+		}
+		if (endpoints.empty())
+			endpoints.push_back("127.0.0.1:8765");
+		return endpoints;
+	}
+}
+
+int run_load(boost::program_options::variables_map const & vm_a)
+{
+	std::string seed(vm_a["seed"].as<std::string>());
+	std::vector<std::string> endpoints(rpc_endpoints(vm_a, seed));
+	std::string mode(vm_a["mode"].as<std::string>());
+	size_t senders(vm_a["senders"].as<size_t>());
+	size_t total(vm_a["transactions"].as<size_t>());
+	double rate(vm_a["rate"].as<double>());
+	size_t batch(std::max<size_t>(1, vm_a["batch"].as<size_t>()));
+	size_t connections(std::max<size_t>(1, std::min(vm_a["connections"].as<size_t>(), senders)));
+	std::chrono::seconds timeout(vm_a["timeout"].as<uint64_t>());
+	if (mode != "transfer" && mode != "call" && mode != "mixed")
+	{
+		std::cerr << "Invalid mode " << mode << ", expected transfer, call or mixed" << std::endl;
+		return 1;
+	}
+	if (senders == 0 || rate <= 0)
+	{
+		std::cerr << "Senders and rate must be positive" << std::endl;
+		return 1;
+	}
+
+	rpc_client setup_client(endpoints[0]);
+	/// transactions are signed for the chain id of the node
+	mcp::chain_id = (uint64_t)dev::jsToU256(setup_client.call("eth_chainId", mcp::json::array()).get<std::string>());
+	dev::u256 gas_price(dev::jsToU256(setup_client.call("eth_gasPrice", mcp::json::array()).get<std::string>()));
+
+	std::vector<dev::KeyPair> keys;
+	for (size_t i = 0; i < senders; i++)
+		keys.push_back(testnet_key(seed, "sender", i));
+	size_t per_sender((total + senders - 1) / senders);
+
+	/// fund the senders from the genesis account and deploy the counter contract
+	dev::KeyPair genesis_key(testnet_key(seed, "genesis", 0));
+	dev::u256 genesis_nonce(dev::jsToU256(setup_client.call("eth_getTransactionCount", mcp::json::array({ genesis_key.address().hexPrefixed(), "pending" })).get<std::string>()));
+	dev::u256 funding(dev::u256(per_sender) * (call_gas * gas_price + 1) * 2);
+
+	std::vector<signed_transaction> setup;
+	dev::Address contract;
+	if (mode != "transfer")
+	{
+		mcp::Transaction t(0, gas_price, deploy_gas, dev::jsToBytes(counter_contract), genesis_nonce);
+		setup.push_back(sign(t, genesis_key.secret()));
+		contract = dev::toAddress(genesis_key.address(), genesis_nonce);
+		genesis_nonce++;
+	}
+	for (auto const & k : keys)
+	{
+		mcp::Transaction t(funding, gas_price, transfer_gas, k.address(), dev::bytes(), genesis_nonce++);
+		setup.push_back(sign(t, genesis_key.secret()));
+	}
+	std::cout << "Funding " << senders << " senders from " << genesis_key.address().hexPrefixed() << " through " << endpoints[0] << std::endl;
+	send_and_wait(setup_client, setup, batch, timeout);
+
+	std::vector<mcp::json> nonce_params;
+	for (auto const & k : keys)
+		nonce_params.push_back(mcp::json::array({ k.address().hexPrefixed(), "pending" }));
+	std::vector<dev::u256> nonces;
+	for (size_t i = 0; i < keys.size(); i += 1000)
+	{
+		std::vector<mcp::json> params(nonce_params.begin() + i, nonce_params.begin() + std::min(i + 1000, keys.size()));
+		for (auto const & n : setup_client.batch("eth_getTransactionCount", params))
+			nonces.push_back(n.is_null() ? 0 : dev::jsToU256(n.get<std::string>()));
+	}
+
+	/// every connection owns a disjoint set of senders, so the nonces of a sender arrive in order
+	dev::Address recipient(dev::right160(dev::sha3(seed + ":recipient")));
+	/// increment(), the counter ignores the selector
+	dev::bytes call_data(dev::fromHex("d09de08a"));
+	std::vector<std::vector<signed_transaction>> queues(connections);
+	{
+		std::cout << "Signing " << per_sender * senders << " transactions" << std::endl;
+		std::vector<std::thread> signers;
+		for (size_t c = 0; c < connections; c++)
+		{
+			signers.emplace_back([&, c]() {
+				for (size_t j = 0; j < per_sender; j++)
+				{
+					for (size_t s = c; s < senders; s += connections)
+					{
+						bool is_call(mode == "call" || (mode == "mixed" && (s + j) % 2));
+						mcp::Transaction t(is_call
+							? mcp::Transaction(0, gas_price, call_gas, contract, call_data, nonces[s] + j)
+							: mcp::Transaction(1, gas_price, transfer_gas, recipient, dev::bytes(), nonces[s] + j));
+						queues[c].push_back(sign(t, keys[s].secret()));
+					}
+				}
+			});
+		}
+		for (auto & t : signers)
+			t.join();
+	}
+
+	tracker track;
+	std::atomic<bool> sending(true);
+	auto start(steady_clock::now());
+
+	std::vector<std::thread> threads;
+	for (size_t c = 0; c < connections; c++)
+	{
+		threads.emplace_back([&, c]() {
+			rpc_client client(endpoints[c % endpoints.size()]);
+			double connection_rate(rate / connections);
+			auto const & queue(queues[c]);
+			for (size_t i = 0; i < queue.size(); i += batch)
+			{
+				/// open loop: the schedule does not wait for slow responses
+				std::this_thread::sleep_until(start + std::chrono::microseconds((uint64_t)(i / connection_rate * 1e6)));
+
+				std::vector<mcp::json> params;
+				size_t end(std::min(i + batch, queue.size()));
+				for (size_t j = i; j < end; j++)
+					params.push_back(mcp::json::array({ queue[j].rlp }));
+
+				auto sent_time(steady_clock::now());
+				try
+				{
+					std::vector<std::string> errors;
+					auto results(client.batch("eth_sendRawTransaction", params, &errors));
+					for (size_t j = i; j < end; j++)
+					{
+						if (!errors[j - i].empty())
+							track.rejected(errors[j - i]);
+						else if (results[j - i].is_null())
+							track.rejected("no response");
+						else
+							track.sent(queue[j].hash, sent_time);
+					}
+				}
+				catch (std::exception const & e)
+				{
+					for (size_t j = i; j < end; j++)
+						track.rejected(e.what());
+				}
+			}
+		});
+	}
+
+	std::thread poller([&]() {
+		rpc_client client(endpoints[0]);
+		auto last_report(steady_clock::now());
+		boost::optional<steady_clock::time_point> deadline;
+		while (true)
+		{
+			if (!sending && !deadline)
+				deadline = steady_clock::now() + timeout;
+			if (deadline && (track.pending() == 0 || steady_clock::now() > *deadline))
+				break;
+
+			auto hashes(track.oldest(1000));
+			size_t found(0);
+			if (!hashes.empty())
+			{
+				std::vector<mcp::json> params;
+				for (auto const & h : hashes)
+					params.push_back(mcp::json::array({ dev::toJS(h) }));
+				try
+				{
+					auto receipts(client.batch("eth_getTransactionReceipt", params));
+					auto now(steady_clock::now());
+					for (size_t i = 0; i < hashes.size(); i++)
+					{
+						if (receipts[i].is_null())
+							continue;
+						track.stable(hashes[i], dev::jsToU256(receipts[i]["status"].get<std::string>()) == 1, now);
+						found++;
+					}
+				}
+				catch (std::exception const & e)
+				{
+					std::cerr << "Receipt polling error: " << e.what() << std::endl;
+				}
+			}
+			if (found == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+			if (steady_clock::now() - last_report > std::chrono::seconds(5))
+			{
+				last_report = steady_clock::now();
+				std::cout << "accepted " << track.accepted.load() << ", rejected " << track.rejected_count.load() << ", pending " << track.pending() << std::endl;
+			}
+		}
+	});
+
+	for (auto & t : threads)
+		t.join();
+	double send_seconds(std::chrono::duration<double>(steady_clock::now() - start).count());
+	sending = false;
+	poller.join();
+
+	mcp::json j_result(track.to_json());
+	j_result["version"] = STR(MCP_VERSION);
+	j_result["mode"] = mode;
+	j_result["endpoints"] = endpoints;
+	j_result["senders"] = senders;
+	j_result["connections"] = connections;
+	j_result["batch"] = batch;
+	j_result["target_tps"] = rate;
+	j_result["submitted"] = per_sender * senders;
+	j_result["send_seconds"] = send_seconds;
+	j_result["submit_tps"] = send_seconds > 0 ? track.accepted.load() / send_seconds : 0;
+
+	if (vm_a.count("output"))
+	{
+		std::ofstream out(vm_a["output"].as<std::string>());
+		out << j_result.dump(4) << std::endl;
+	}
+	else
+		std::cout << j_result.dump(4) << std::endl;
+	return 0;
+}
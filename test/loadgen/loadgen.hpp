@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mcp/common/mcp_json.hpp>
+
+#include <libdevcrypto/Common.h>
+
+#include <boost/program_options.hpp>
+
+#include <string>
+
+/// deterministic key of a testnet role (genesis, witness, node, sender), the same seed always gives the same testnet
+dev::KeyPair testnet_key(std::string const & seed_a, std::string const & role_a, size_t const & index_a);
+
+/// blocking JSON-RPC client over HTTP.
+/// The node's RPC server closes every connection after one response, so each request connects anew.
+class rpc_client
+{
+public:
+	/// host:port
+	rpc_client(std::string const & endpoint_a);
+
+	/// result of a single call, throws std::runtime_error on transport or rpc error
+	mcp::json call(std::string const & method_a, mcp::json const & params_a);
+	/// one batch request, the responses are returned in the order of the calls (null result on error)
+	std::vector<mcp::json> batch(std::string const & method_a, std::vector<mcp::json> const & params_a, std::vector<std::string> * errors_a = nullptr);
+
+	std::string const endpoint;
+
+private:
+	std::string post(std::string const & body_a);
+
+	std::string m_host;
+	std::string m_port;
+	uint64_t m_id = 0;
+};
+
+int generate_testnet(boost::program_options::variables_map const & vm_a);
+int run_load(boost::program_options::variables_map const & vm_a);
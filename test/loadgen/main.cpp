@@ -0,0 +1,58 @@
+#include "loadgen.hpp"
+
+#include <iostream>
+
+int main(int argc, char * const * argv)
+{
+	boost::program_options::options_description description("Load generator options");
+	description.add_options()
+		("help", "Print out options")
+		("generate", "Generate a local witness testnet: genesis, node keys, witness keystores and node arguments")
+		("load", "Fund senders from the genesis account, then send pre-signed transactions at the target rate")
+		("dir", boost::program_options::value<std::string>()->default_value("testnet"), "Testnet directory")
+		("seed", boost::program_options::value<std::string>()->default_value("mcp-loadgen"), "Seed of every generated key")
+		("nodes", boost::program_options::value<size_t>()->default_value(4), "Number of witness nodes to generate")
+		("password", boost::program_options::value<std::string>()->default_value("loadgen"), "Password of the witness keystores")
+		("p2p_port", boost::program_options::value<uint16_t>()->default_value(30610), "P2P port of the first node, the others follow")
+		("rpc_port", boost::program_options::value<uint16_t>()->default_value(8770), "HTTP-RPC port of the first node, the others follow")
+		("timestamp", boost::program_options::value<uint64_t>()->default_value(1700625600), "Genesis exec timestamp")
+		("rpc", boost::program_options::value<std::string>(), "Comma separated host:port of the nodes to load (default: nodes of the testnet directory)")
+		("mode", boost::program_options::value<std::string>()->default_value("transfer"), "Transactions to send: transfer, call or mixed")
+		("senders", boost::program_options::value<size_t>()->default_value(1000), "Number of sending accounts")
+		("transactions", boost::program_options::value<size_t>()->default_value(100000), "Number of transactions to send")
+		("rate", boost::program_options::value<double>()->default_value(1000), "Target transactions per second")
+		("batch", boost::program_options::value<size_t>()->default_value(100), "Transactions per JSON-RPC batch request")
+		("connections", boost::program_options::value<size_t>()->default_value(4), "Concurrent senders, spread over the nodes")
+		("timeout", boost::program_options::value<uint64_t>()->default_value(120), "Seconds to wait for stable receipts after sending")
+		("output", boost::program_options::value<std::string>(), "Write json results to this file");
+
+	boost::program_options::variables_map vm;
+	try
+	{
+		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, description), vm);
+		boost::program_options::notify(vm);
+	}
+	catch (boost::program_options::error const & e)
+	{
+		std::cerr << e.what() << std::endl << description << std::endl;
+		return 1;
+	}
+
+	if (vm.count("help") || (!vm.count("generate") && !vm.count("load")))
+	{
+		std::cout << description << std::endl;
+		return 0;
+	}
+
+	try
+	{
+		if (vm.count("generate"))
+			return generate_testnet(vm);
+		return run_load(vm);
+	}
+	catch (std::exception const & e)
+	{
+		std::cerr << "Load generator error: " << e.what() << std::endl;
+		return 1;
+	}
+}
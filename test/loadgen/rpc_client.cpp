@@ -0,0 +1,103 @@
+#include "loadgen.hpp"
+
+#include <libdevcore/SHA3.h>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+dev::KeyPair testnet_key(std::string const & seed_a, std::string const & role_a, size_t const & index_a)
+{
+	return dev::KeyPair(dev::Secret(dev::sha3(seed_a + ":" + role_a + ":" + std::to_string(index_a))));
+}
+
+rpc_client::rpc_client(std::string const & endpoint_a) :
+	endpoint(endpoint_a)
+{
+	size_t colon(endpoint_a.rfind(':'));
+	if (colon == std::string::npos)
+		throw std::runtime_error("Invalid rpc endpoint " + endpoint_a + ", expected host:port");
+	m_host = endpoint_a.substr(0, colon);
+	m_port = endpoint_a.substr(colon + 1);
+}
+
+std::string rpc_client::post(std::string const & body_a)
+{
+	boost::asio::io_context io_context;
+	boost::asio::ip::tcp::resolver resolver(io_context);
+	boost::beast::tcp_stream stream(io_context);
+	stream.connect(resolver.resolve(m_host, m_port));
+
+	boost::beast::http::request<boost::beast::http::string_body> request(boost::beast::http::verb::post, "/", 11);
+	request.set(boost::beast::http::field::host, m_host);
+	request.set(boost::beast::http::field::content_type, "application/json");
+	request.body() = body_a;
+	request.prepare_payload();
+	boost::beast::http::write(stream, request);
+
+	boost::beast::flat_buffer buffer;
+	boost::beast::http::response<boost::beast::http::string_body> response;
+	boost::beast::http::read(stream, buffer, response);
+
+	boost::system::error_code ec;
+	stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+
+	if (response.result() != boost::beast::http::status::ok)
+		throw std::runtime_error(endpoint + " http status " + std::to_string(response.result_int()));
+	return response.body();
+}
+
+mcp::json rpc_client::call(std::string const & method_a, mcp::json const & params_a)
+{
+	mcp::json request;
+	request["jsonrpc"] = "2.0";
+	request["id"] = ++m_id;
+	request["method"] = method_a;
+	request["params"] = params_a;
+
+	mcp::json response(mcp::json::parse(post(request.dump())));
+	if (response.count("error"))
+		throw std::runtime_error(method_a + ": " + response["error"].dump());
+	return response["result"];
+}
+
+std::vector<mcp::json> rpc_client::batch(std::string const & method_a, std::vector<mcp::json> const & params_a, std::vector<std::string> * errors_a)
+{
+	std::vector<mcp::json> results(params_a.size());
+	if (errors_a)
+		errors_a->assign(params_a.size(), std::string());
+	if (params_a.empty())
+		return results;
+
+	uint64_t first_id(m_id + 1);
+	mcp::json requests = mcp::json::array();
+	for (auto const & params : params_a)
+	{
+		mcp::json request;
+		request["jsonrpc"] = "2.0";
+		request["id"] = ++m_id;
+		request["method"] = method_a;
+		request["params"] = params;
+		requests.push_back(request);
+	}
+
+	mcp::json responses(mcp::json::parse(post(requests.dump())));
+	if (!responses.is_array())
+		throw std::runtime_error(method_a + " batch: " + responses.dump());
+
+	for (auto const & response : responses)
+	{
+		if (!response.count("id") || !response["id"].is_number_unsigned())
+			continue;
+		uint64_t index(response["id"].get<uint64_t>() - first_id);
+		if (index >= results.size())
+			continue;
+		if (response.count("error"))
+		{
+			if (errors_a)
+				(*errors_a)[index] = response["error"].count("message") ? response["error"]["message"].dump() : response["error"].dump();
+		}
+		else
+			results[index] = response["result"];
+	}
+	return results;
+}
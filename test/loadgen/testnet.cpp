@@ -0,0 +1,121 @@
+#include "loadgen.hpp"
+
+#include <mcp/core/config.hpp>
+#include <mcp/wallet/key_manager.hpp>
+
+#include <libdevcore/CommonJS.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	/// keystore files of a local testnet do not need the standard 256MB scrypt cost
+	int const light_scrypt_n(1 << 12);
+	int const light_scrypt_p(6);
+
+	void write_file(boost::filesystem::path const & path_a, std::string const & content_a)
+	{
+		std::ofstream out(path_a.string(), std::ios::trunc);
+		if (!out.is_open())
+			throw std::runtime_error("Can not write " + path_a.string());
+		out << content_a;
+	}
+}
+
+int generate_testnet(boost::program_options::variables_map const & vm_a)
+{
+	std::string seed(vm_a["seed"].as<std::string>());
+	size_t nodes(vm_a["nodes"].as<size_t>());
+	std::string password(vm_a["password"].as<std::string>());
+	uint16_t p2p_port(vm_a["p2p_port"].as<uint16_t>());
+	uint16_t rpc_port(vm_a["rpc_port"].as<uint16_t>());
+	boost::filesystem::path dir(boost::filesystem::absolute(vm_a["dir"].as<std::string>()));
+	if (nodes == 0)
+	{
+		std::cerr << "At least one node is needed" << std::endl;
+		return 1;
+	}
+
+	boost::filesystem::create_directories(dir);
+
+	/// genesis account funds the senders of the load run, every node is a genesis witness
+	dev::KeyPair genesis_key(testnet_key(seed, "genesis", 0));
+	mcp::json j_witnesses = mcp::json::array();
+	for (size_t i = 0; i < nodes; i++)
+		j_witnesses.push_back(testnet_key(seed, "witness", i).address().hexPrefixed());
+
+	mcp::json j_genesis;
+	j_genesis["from"] = genesis_key.address().hexPrefixed();
+	j_genesis["to"] = genesis_key.address().hexPrefixed();
+	j_genesis["value"] = "2000000000000000000000000000";
+	j_genesis["data"] = "";
+	j_genesis["exec_timestamp"] = std::to_string(vm_a["timestamp"].as<uint64_t>());
+	j_genesis["witnesses"] = j_witnesses;
+	boost::filesystem::path genesis_path(dir / "genesis.json");
+	write_file(genesis_path, j_genesis.dump(4));
+
+	std::vector<std::string> enodes;
+	for (size_t i = 0; i < nodes; i++)
+	{
+		dev::KeyPair node_key(testnet_key(seed, "node", i));
+		enodes.push_back("mcpnode://" + node_key.pub().hex() + "@127.0.0.1:" + std::to_string(p2p_port + i));
+	}
+
+	mcp::json j_nodes = mcp::json::array();
+	std::string args;
+	for (size_t i = 0; i < nodes; i++)
+	{
+		boost::filesystem::path node_path(dir / ("node" + std::to_string(i)));
+		boost::filesystem::create_directories(node_path);
+
+		dev::KeyPair node_key(testnet_key(seed, "node", i));
+		write_file(node_path / "nodekey", dev::toHex(node_key.secret().ref()));
+
+		dev::KeyPair witness_key(testnet_key(seed, "witness", i));
+		mcp::key_content kc(witness_key.address(), mcp::EncryptDataV3(witness_key.secret(), password, light_scrypt_n, light_scrypt_p),
+			boost::uuids::random_generator()(), mcp::Key::version);
+		boost::filesystem::path keystore_path(node_path / "witness.json");
+		write_file(keystore_path, kc.to_json().dump());
+
+		std::string bootstrap_nodes;
+		for (size_t j = 0; j < nodes; j++)
+		{
+			if (j == i)
+				continue;
+			if (!bootstrap_nodes.empty())
+				bootstrap_nodes += ",";
+			bootstrap_nodes += enodes[j];
+		}
+
+		args += "--daemon --network " + std::to_string((unsigned)mcp::mcp_networks::mcp_mini_test_network)
+			+ " --data_path " + node_path.string()
+			+ " --genesis " + genesis_path.string()
+			+ " --port " + std::to_string(p2p_port + i)
+			+ " --rpc --rpc_port " + std::to_string(rpc_port + i)
+			+ " --witness --witness_account " + keystore_path.string()
+			+ " --password " + password
+			+ (bootstrap_nodes.empty() ? "" : " --bootstrap_nodes " + bootstrap_nodes)
+			+ "\n";
+
+		mcp::json j_node;
+		j_node["data_path"] = node_path.string();
+		j_node["enode"] = enodes[i];
+		j_node["witness"] = witness_key.address().hexPrefixed();
+		j_node["rpc"] = "127.0.0.1:" + std::to_string(rpc_port + i);
+		j_nodes.push_back(j_node);
+	}
+	write_file(dir / "nodes.args", args);
+
+	mcp::json j_testnet;
+	j_testnet["seed"] = seed;
+	j_testnet["genesis_account"] = genesis_key.address().hexPrefixed();
+	j_testnet["nodes"] = j_nodes;
+	write_file(dir / "testnet.json", j_testnet.dump(4));
+
+	std::cout << "Testnet of " << nodes << " witness nodes written to " << dir << std::endl;
+	return 0;
+}
@@ -0,0 +1,45 @@
+#!/bin/bash
+# Launches a local witness testnet on loopback and optionally loads it.
+#   testnet.sh start <nodes> [dir]   generate keys and genesis, start <nodes> witness nodes
+#   testnet.sh stop [dir]            stop the nodes of the testnet
+#   testnet.sh load [dir] [args...]  run mcp_loadgen against the nodes, extra args are passed on
+# MCP and MCP_LOADGEN select the binaries (default: ./mcp and ./mcp_loadgen).
+
+MCP=${MCP:-./mcp}
+MCP_LOADGEN=${MCP_LOADGEN:-./mcp_loadgen}
+
+case "$1" in
+start)
+	NODES=${2:-4}
+	DIR=${3:-testnet}
+	if [ -f "$DIR/pids" ]; then
+		echo "$DIR is running, stop it first"
+		exit 1
+	fi
+	"$MCP_LOADGEN" --generate --nodes "$NODES" --dir "$DIR" || exit 1
+	i=0
+	while read -r args; do
+		"$MCP" $args > "$DIR/node$i.out" 2>&1 &
+		echo $! >> "$DIR/pids"
+		i=$((i + 1))
+	done < "$DIR/nodes.args"
+	echo "Started $i nodes, logs in $DIR/node*/log"
+	;;
+stop)
+	DIR=${2:-testnet}
+	if [ -f "$DIR/pids" ]; then
+		kill $(cat "$DIR/pids") 2> /dev/null
+		rm "$DIR/pids"
+	fi
+	;;
+load)
+	DIR=${2:-testnet}
+	shift
+	[ $# -gt 0 ] && shift
+	"$MCP_LOADGEN" --load --dir "$DIR" "$@"
+	;;
+*)
+	echo "usage: $0 start <nodes> [dir] | stop [dir] | load [dir] [args...]"
+	exit 1
+	;;
+esac